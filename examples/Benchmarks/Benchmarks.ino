@@ -0,0 +1,830 @@
+/*
+ * Benchmarks
+ *
+ * Micro-benchmarks for the library's hot-path conversions. Results are
+ * printed once at startup as CSV so they can be captured from the serial
+ * monitor and compared between builds:
+ *
+ *   bench,name,iterations,total_us,ns_per_op
+ *
+ * Correctness checks print "check,name,pass|fail" and the run ends with
+ * "bench,done". tools/compare_bench.py diffs two captures and fails when a
+ * benchmark slows down by more than a threshold. tools/bench builds the
+ * protocol benchmarks for the host and prints the same CSV.
+ */
+
+#include <BMDBLEController.h>
+#include <Controls/ApertureTable.h>
+#include <Protocol/CharConv.h>
+#include <Protocol/Fixed16.h>
+#include <Protocol/HexCodec.h>
+#include <Protocol/ParameterCache.h>
+#include <Protocol/ParameterHistory.h>
+#include <Protocol/ParameterSubscriptions.h>
+#include <Protocol/Parameters.h>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+using namespace BMDCamera;
+
+// Keeps results alive so the optimizer can't drop the loops
+volatile float floatSink = 0.0f;
+volatile uint32_t intSink = 0;
+
+const uint32_t ITERATIONS = 100000;
+
+// Time fn(i) for i in [0, iterations); opsPerIteration counts the values
+// each call processes, so batch and scalar results are per value
+template <typename Fn>
+void runBenchmark(const char* name, uint32_t iterations, Fn fn, uint32_t opsPerIteration = 1) {
+  uint32_t start = micros();
+  for (uint32_t i = 0; i < iterations; i++) {
+    fn(i);
+  }
+  uint32_t elapsed = micros() - start;
+  uint32_t ops = iterations * opsPerIteration;
+
+  Serial.print("bench,");
+  Serial.print(name);
+  Serial.print(",");
+  Serial.print(ops);
+  Serial.print(",");
+  Serial.print(elapsed);
+  Serial.print(",");
+  Serial.println(elapsed * 1000.0f / ops, 2);
+}
+
+void benchmarkAperture() {
+  const float minFStop = 1.8f;
+  const float maxFStop = 22.0f;
+
+  // Reference: the pow()/log() formulation the table replaces
+  runBenchmark("aperture_to_fstop_pow", ITERATIONS, [&](uint32_t i) {
+    float normalized = (i & 2047) / 2048.0f;
+    floatSink = minFStop * std::pow(maxFStop / minFStop, normalized);
+  });
+
+  runBenchmark("aperture_to_fstop_lut", ITERATIONS, [](uint32_t i) {
+    float normalized = (i & 2047) / 2048.0f;
+    floatSink = ApertureTable::normalizedToFStop(normalized);
+  });
+
+  runBenchmark("aperture_to_fstop_lut_q10", ITERATIONS, [](uint32_t i) {
+    intSink = ApertureTable::fixed16ToFStopQ10(i & 2047);
+  });
+
+  runBenchmark("aperture_from_fstop_log", ITERATIONS, [&](uint32_t i) {
+    float fStop = minFStop + (i & 1023) * 0.0197f;
+    floatSink = std::log(fStop / minFStop) / std::log(maxFStop / minFStop);
+  });
+
+  runBenchmark("aperture_from_fstop_lut", ITERATIONS, [](uint32_t i) {
+    float fStop = 1.8f + (i & 1023) * 0.0197f;
+    intSink = ApertureTable::fStopToFixed16(fStop);
+  });
+}
+
+// Buffers for the batch conversion benchmarks
+const size_t FIXED16_BATCH = 256;
+float floatBuffer[FIXED16_BATCH];
+float floatResult[FIXED16_BATCH];
+int16_t fixedBuffer[FIXED16_BATCH];
+uint8_t payloadBuffer[FIXED16_BATCH * 2];
+
+// Batch and scalar conversions must agree, round to nearest and saturate
+bool checkFixed16() {
+  const float edges[] = {
+    0.0f, -0.0f, 0.5f / 2048, -0.5f / 2048, 0.3f, -0.3f, 1.0f, -1.0f,
+    15.9995f, 15.9999f, 16.0f, -16.0f, -16.001f, 1000.0f, -1000.0f,
+    NAN, INFINITY, -INFINITY
+  };
+  const size_t edgeCount = sizeof(edges) / sizeof(edges[0]);
+
+  for (size_t i = 0; i < FIXED16_BATCH; i++) {
+    floatBuffer[i] = i < edgeCount ? edges[i] : (static_cast<int32_t>(i * 2654435761u) / 65536.0f) / 1500.0f;
+  }
+  Fixed16::fromFloat(floatBuffer, fixedBuffer, FIXED16_BATCH);
+
+  uint32_t failures = 0;
+  for (size_t i = 0; i < FIXED16_BATCH; i++) {
+    float value = floatBuffer[i];
+    int32_t expected = 0;
+    if (!std::isnan(value)) {
+      float rounded = std::round(value * 2048.0f);
+      expected = rounded > 32767.0f ? 32767 : (rounded < -32768.0f ? -32768 : static_cast<int32_t>(rounded));
+    }
+    if (fixedBuffer[i] != expected || Fixed16::fromFloat(value) != expected) {
+      failures++;
+    }
+  }
+
+  for (int32_t raw = -32768; raw <= 32767; raw++) {
+    if (Fixed16::fromFloat(Fixed16::toFloat(static_cast<int16_t>(raw))) != raw) {
+      failures++;
+    }
+  }
+
+  Serial.print("check,fixed16,");
+  Serial.println(failures == 0 ? "pass" : "fail");
+  return failures == 0;
+}
+
+void benchmarkFixed16() {
+  checkFixed16();
+
+  const uint32_t rounds = ITERATIONS / FIXED16_BATCH;
+
+  runBenchmark("fixed16_from_float_scalar", rounds * FIXED16_BATCH, [](uint32_t i) {
+    fixedBuffer[i % FIXED16_BATCH] = Fixed16::fromFloat(floatBuffer[i % FIXED16_BATCH]);
+  });
+
+  runBenchmark("fixed16_from_float_batch", rounds, [](uint32_t) {
+    intSink = Fixed16::fromFloat(floatBuffer, fixedBuffer, FIXED16_BATCH);
+  }, FIXED16_BATCH);
+
+  runBenchmark("fixed16_to_float_batch", rounds, [](uint32_t) {
+    Fixed16::toFloat(fixedBuffer, floatResult, FIXED16_BATCH);
+  }, FIXED16_BATCH);
+
+  runBenchmark("fixed16_encode_payload", rounds, [](uint32_t) {
+    intSink = Fixed16::encode(floatBuffer, payloadBuffer, FIXED16_BATCH);
+  }, FIXED16_BATCH);
+
+  runBenchmark("fixed16_decode_payload", rounds, [](uint32_t) {
+    Fixed16::decode(payloadBuffer, floatResult, FIXED16_BATCH);
+  }, FIXED16_BATCH);
+  floatSink = floatResult[0];
+}
+
+// Buffers for the hex benchmarks: a typical 64-byte trace dump
+const size_t HEX_BYTES = 64;
+uint8_t hexInput[HEX_BYTES];
+uint8_t hexDecoded[HEX_BYTES];
+char hexText[HexCodec::encodedSize(HEX_BYTES)];
+
+// Reference: the stringstream/setw encoder the codec replaces
+std::string hexEncodeStream(const uint8_t* data, size_t length) {
+  std::stringstream ss;
+  ss << std::hex << std::setfill('0');
+  for (size_t i = 0; i < length; i++) {
+    ss << std::setw(2) << static_cast<int>(data[i]) << " ";
+  }
+  std::string result = ss.str();
+  if (!result.empty()) {
+    result.pop_back();
+  }
+  return result;
+}
+
+// Reference: appending String fragments per byte
+String hexEncodeString(const uint8_t* data, size_t length) {
+  String result;
+  result.reserve(length * 3);
+  for (size_t i = 0; i < length; i++) {
+    if (data[i] < 0x10) {
+      result += "0";
+    }
+    result += String(data[i], HEX);
+    if (i < length - 1) {
+      result += " ";
+    }
+  }
+  return result;
+}
+
+// Reference: substr + stoi per byte
+size_t hexDecodeStoi(const std::string& text, uint8_t* out) {
+  std::string clean;
+  for (char c : text) {
+    if (isxdigit(c)) {
+      clean += c;
+    }
+  }
+  size_t count = 0;
+  for (size_t i = 0; i + 1 < clean.length(); i += 2) {
+    out[count++] = static_cast<uint8_t>(std::stoi(clean.substr(i, 2), nullptr, 16));
+  }
+  return count;
+}
+
+// Table codec must match the reference output and round trip
+bool checkHex() {
+  for (size_t i = 0; i < HEX_BYTES; i++) {
+    hexInput[i] = static_cast<uint8_t>(i * 37 + 11);
+  }
+  HexCodec::encode(hexInput, HEX_BYTES, hexText, sizeof(hexText));
+  size_t decoded = HexCodec::decode(hexText, sizeof(hexText) - 1, hexDecoded, HEX_BYTES);
+
+  bool pass = hexEncodeStream(hexInput, HEX_BYTES) == hexText &&
+              decoded == HEX_BYTES && memcmp(hexInput, hexDecoded, HEX_BYTES) == 0;
+
+  Serial.print("check,hex,");
+  Serial.println(pass ? "pass" : "fail");
+  return pass;
+}
+
+void benchmarkHex() {
+  checkHex();
+
+  const uint32_t rounds = ITERATIONS / 100;
+  const std::string text(hexText);
+
+  // Throughput is reported per byte
+  runBenchmark("hex_encode_stringstream", rounds, [](uint32_t) {
+    intSink = hexEncodeStream(hexInput, HEX_BYTES).size();
+  }, HEX_BYTES);
+
+  runBenchmark("hex_encode_string_append", rounds, [](uint32_t) {
+    intSink = hexEncodeString(hexInput, HEX_BYTES).length();
+  }, HEX_BYTES);
+
+  runBenchmark("hex_encode_table", rounds, [](uint32_t) {
+    intSink = HexCodec::encode(hexInput, HEX_BYTES, hexText, sizeof(hexText));
+  }, HEX_BYTES);
+
+  runBenchmark("hex_decode_stoi", rounds, [&](uint32_t) {
+    intSink = hexDecodeStoi(text, hexDecoded);
+  }, HEX_BYTES);
+
+  runBenchmark("hex_decode_table", rounds, [&](uint32_t) {
+    intSink = HexCodec::decode(text.data(), text.size(), hexDecoded, HEX_BYTES);
+  }, HEX_BYTES);
+}
+
+// Text conversions for string-typed parameters
+const char* const NUMBER_TEXT[] = { "800", "-12", "5600", "0.5", "-1.25", "2.8", "16.000000", "3e2" };
+const size_t NUMBER_TEXT_COUNT = sizeof(NUMBER_TEXT) / sizeof(NUMBER_TEXT[0]);
+char numberBuffer[32];
+
+// Must agree with strtof/strtoll and "%f" formatting
+bool checkCharConv() {
+  bool pass = true;
+  for (size_t i = 0; i < NUMBER_TEXT_COUNT; i++) {
+    const char* text = NUMBER_TEXT[i];
+    float parsed = 0.0f;
+    int64_t integer = 0;
+    pass = pass && CharConv::parseFloat(text, text + strlen(text), parsed).ok && parsed == strtof(text, nullptr);
+    pass = pass && CharConv::parseInteger(text, text + strlen(text), integer).ok && integer == strtoll(text, nullptr, 10);
+  }
+  for (int32_t raw = -32768; raw <= 32767 && pass; raw += 7) {
+    float value = Fixed16::toFloat(static_cast<int16_t>(raw));
+    CharConv::formatFloat(value, numberBuffer, sizeof(numberBuffer));
+    pass = std::to_string(value) == numberBuffer;
+  }
+
+  Serial.print("check,char_conv,");
+  Serial.println(pass ? "pass" : "fail");
+  return pass;
+}
+
+void benchmarkCharConv() {
+  checkCharConv();
+
+  // Reference: the std::stof / std::to_string calls the conversions replace
+  runBenchmark("parse_float_stof", ITERATIONS, [](uint32_t i) {
+    floatSink = std::stof(NUMBER_TEXT[i % NUMBER_TEXT_COUNT]);
+  });
+
+  runBenchmark("parse_float_chars", ITERATIONS, [](uint32_t i) {
+    const char* text = NUMBER_TEXT[i % NUMBER_TEXT_COUNT];
+    float value = 0.0f;
+    CharConv::parseFloat(text, text + strlen(text), value);
+    floatSink = value;
+  });
+
+  runBenchmark("parse_integer_chars", ITERATIONS, [](uint32_t i) {
+    const char* text = NUMBER_TEXT[i % NUMBER_TEXT_COUNT];
+    int64_t value = 0;
+    CharConv::parseInteger(text, text + strlen(text), value);
+    intSink = static_cast<uint32_t>(value);
+  });
+
+  runBenchmark("format_float_to_string", ITERATIONS, [](uint32_t i) {
+    intSink = std::to_string(Fixed16::toFloat(static_cast<int16_t>(i))).size();
+  });
+
+  runBenchmark("format_float_chars", ITERATIONS, [](uint32_t i) {
+    intSink = CharConv::formatFloat(Fixed16::toFloat(static_cast<int16_t>(i)), numberBuffer, sizeof(numberBuffer));
+  });
+
+  runBenchmark("format_integer_chars", ITERATIONS, [](uint32_t i) {
+    intSink = CharConv::formatInteger(static_cast<int32_t>(i * 2654435761u), numberBuffer, sizeof(numberBuffer));
+  });
+}
+
+// Encode and decode through the typed descriptors, one per data type. The
+// payload starts after the 8-byte header.
+template <typename P>
+void benchmarkParamCodec(const char* encodeName, const char* decodeName, const typename P::Value& value) {
+  runBenchmark(encodeName, ITERATIONS, [&](uint32_t) {
+    auto packet = P::encode(value);
+    intSink = packet[packet.size() - 1];
+  });
+
+  auto packet = P::encode(value);
+  runBenchmark(decodeName, ITERATIONS, [&](uint32_t) {
+    typename P::Value decoded;
+    intSink = P::decode(packet.data() + 8, P::PAYLOAD_SIZE, decoded);
+  });
+}
+
+void benchmarkCodec() {
+  benchmarkParamCodec<Lens::AutoFocus>("encode_void", "decode_void", Trigger{});
+  benchmarkParamCodec<Audio::PhantomPower>("encode_bool", "decode_bool", true);
+  benchmarkParamCodec<Video::Sharpening>("encode_int8", "decode_int8", int8_t(2));
+  benchmarkParamCodec<Lens::ZoomMillimeters>("encode_int16", "decode_int16", int16_t(35));
+  benchmarkParamCodec<Video::ISO>("encode_int32", "decode_int32", int32_t(800));
+  benchmarkParamCodec<Config::Location>("encode_int64x2", "decode_int64x2", Config::Location::Value{ 515074000LL, -127800LL });
+  benchmarkParamCodec<Lens::Focus>("encode_fixed16", "decode_fixed16", 0.5f);
+  benchmarkParamCodec<Color::Lift>("encode_fixed16x4", "decode_fixed16x4", Color::Lift::Value{ 0.1f, -0.1f, 0.0f, 0.25f });
+}
+
+// Cache every fixed-size parameter in the schema up to count
+void populateCache(ParameterCache& cache, size_t count) {
+  const uint8_t zeros[ParameterCache::MAX_PAYLOAD] = {};
+  cache.clear();
+  for (size_t i = 0; i < PARAMETER_COUNT && i < count; i++) {
+    const ParameterInfo& info = PARAMETER_TABLE[i];
+    cache.store(info.category, info.id, info.dataType, zeros, info.payloadSize());
+  }
+}
+
+ParameterCache benchCache;
+
+// Ingest cost should not depend on how much is already cached
+void benchmarkCache() {
+  const auto iso = Video::ISO::encode(800, OP_REPORT);
+  const size_t populations[] = { 0, PARAMETER_COUNT / 4, PARAMETER_COUNT / 2, PARAMETER_COUNT };
+  const char* ingestNames[] = { "cache_ingest_empty", "cache_ingest_quarter", "cache_ingest_half", "cache_ingest_full" };
+
+  for (size_t i = 0; i < 4; i++) {
+    populateCache(benchCache, populations[i]);
+    runBenchmark(ingestNames[i], ITERATIONS, [&](uint32_t) {
+      intSink = benchCache.update(iso.data(), iso.size());
+    });
+  }
+
+  // A dump of several reports back to back, as after a mode change
+  uint8_t burst[Video::ISO::PACKET_SIZE * 4];
+  size_t burstLength = 0;
+  const int32_t values[] = { 200, 400, 800, 1600 };
+  for (int32_t value : values) {
+    auto packet = Video::ISO::encode(value, OP_REPORT);
+    memcpy(burst + burstLength, packet.data(), packet.size());
+    burstLength += packet.size();
+  }
+  runBenchmark("cache_ingest_burst4", ITERATIONS / 4, [&](uint32_t) {
+    intSink = benchCache.update(burst, burstLength);
+  }, 4);
+
+  // Lookups against a full cache
+  populateCache(benchCache, PARAMETER_COUNT);
+  benchCache.update(iso.data(), iso.size());
+
+  runBenchmark("cache_lookup_hit", ITERATIONS, [](uint32_t) {
+    int32_t value = 0;
+    intSink = benchCache.get<Video::ISO>(value) ? value : 0;
+  });
+
+  runBenchmark("cache_lookup_miss", ITERATIONS, [](uint32_t) {
+    uint8_t payload[ParameterCache::MAX_PAYLOAD];
+    size_t length = 0;
+    intSink = benchCache.read(CAT_VIDEO, 0x7F, payload, length);
+  });
+
+  runBenchmark("schema_index_of", ITERATIONS, [](uint32_t i) {
+    const ParameterInfo& info = PARAMETER_TABLE[i % PARAMETER_COUNT];
+    intSink = ParameterSchema::indexOf(info.category, info.id);
+  });
+
+  // Incremental sync after four parameters of a full cache change
+  // (focus, aperture f-stop, normalised and ordinal: two bytes each)
+  const uint8_t changedIds[] = { 0x00, 0x02, 0x03, 0x04 };
+  ChangedParameter changes[8];
+  runBenchmark("cache_changes_since_4", ITERATIONS / 4, [&](uint32_t i) {
+    uint32_t since = benchCache.getSequence();
+    uint8_t payload[2] = { static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8) };
+    for (uint8_t id : changedIds) {
+      benchCache.store(CAT_LENS, id, ParameterSchema::find(CAT_LENS, id)->dataType, payload, sizeof(payload));
+    }
+    intSink = benchCache.getChangesSince(since, changes, 8);
+  }, 4);
+}
+
+// Never connected, so commands go through encoding and sendData() and are
+// dropped at the transport
+BMDBLEController camera;
+volatile uint32_t callbackCount = 0;
+
+// Full notification path: raw copy, cache ingest, counters, callback
+void benchmarkDispatch() {
+  const auto iso = Video::ISO::encode(800, OP_REPORT);
+
+  runBenchmark("dispatch_no_callback", ITERATIONS, [&](uint32_t) {
+    camera.injectNotification(BMDBLEController::NOTIFY_INCOMING_CONTROL, iso.data(), iso.size());
+  });
+
+  camera.setIncomingControlCallback([](const uint8_t*, size_t) {
+    callbackCount = callbackCount + 1;
+  });
+  runBenchmark("dispatch_callback", ITERATIONS, [&](uint32_t) {
+    camera.injectNotification(BMDBLEController::NOTIFY_INCOMING_CONTROL, iso.data(), iso.size());
+  });
+
+  camera.setNotificationDecimation(BMDBLEController::NOTIFY_INCOMING_CONTROL, 10);
+  runBenchmark("dispatch_decimated_10", ITERATIONS, [&](uint32_t) {
+    camera.injectNotification(BMDBLEController::NOTIFY_INCOMING_CONTROL, iso.data(), iso.size());
+  });
+  camera.setNotificationDecimation(BMDBLEController::NOTIFY_INCOMING_CONTROL, 1);
+  camera.setIncomingControlCallback(nullptr);
+
+  // The camera repeats unchanged values; ChangesOnly holds them back
+  SubscriptionId allReports = camera.onParameter<Video::ISO>([](const int32_t&) {
+    callbackCount = callbackCount + 1;
+  }, NotifyMode::AllReports);
+  runBenchmark("dispatch_parameter_all_reports", ITERATIONS, [&](uint32_t) {
+    camera.injectNotification(BMDBLEController::NOTIFY_INCOMING_CONTROL, iso.data(), iso.size());
+  });
+  camera.removeParameterCallback(allReports);
+
+  camera.onParameter<Video::ISO>([](const int32_t&) {
+    callbackCount = callbackCount + 1;
+  });
+  runBenchmark("dispatch_parameter_changes_only", ITERATIONS, [&](uint32_t) {
+    camera.injectNotification(BMDBLEController::NOTIFY_INCOMING_CONTROL, iso.data(), iso.size());
+  });
+  camera.removeParameterCallback(CAT_VIDEO, Video::ISO::ID);
+
+  // Eight subscribers matched by key, wildcard and category mask
+  SubscriptionId fanout[8];
+  for (size_t i = 0; i < 8; i++) {
+    ParameterCallback count = [](uint8_t, uint8_t, const uint8_t*, size_t) {
+      callbackCount = callbackCount + 1;
+    };
+    if (i % 3 == 0) {
+      fanout[i] = camera.onParameter(CAT_VIDEO, Video::ISO::ID, count, NotifyMode::AllReports);
+    } else if (i % 3 == 1) {
+      fanout[i] = camera.onParameter(ANY_CATEGORY, Video::ISO::ID, count, NotifyMode::AllReports);
+    } else {
+      fanout[i] = camera.onCategories(1u << CAT_VIDEO, count, NotifyMode::AllReports);
+    }
+  }
+  runBenchmark("dispatch_parameter_fanout_8", ITERATIONS, [&](uint32_t) {
+    camera.injectNotification(BMDBLEController::NOTIFY_INCOMING_CONTROL, iso.data(), iso.size());
+  });
+  for (SubscriptionId subscription : fanout) {
+    camera.removeParameterCallback(subscription);
+  }
+
+  // A Deferred callback costs ingest one queued copy; loop() runs it
+  SubscriptionId deferred = camera.onParameter<Video::ISO>([](const int32_t&) {
+    callbackCount = callbackCount + 1;
+  }, NotifyMode::AllReports, CallbackExecutor::Deferred);
+  runBenchmark("dispatch_parameter_deferred", ITERATIONS, [&](uint32_t i) {
+    camera.injectNotification(BMDBLEController::NOTIFY_INCOMING_CONTROL, iso.data(), iso.size());
+    if ((i & 15) == 15) {
+      camera.loop();
+    }
+  });
+  camera.loop();
+  camera.removeParameterCallback(deferred);
+}
+
+// Captured by subscription callbacks; a callback that runs after its
+// capture was destroyed sees the poisoned value
+struct Canary {
+  static const uint32_t ALIVE = 0xA11CE;
+  uint32_t magic = ALIVE;
+  Canary() = default;
+  Canary(const Canary&) = default;
+  ~Canary() { magic = 0; }
+};
+
+ParameterSubscriptions checkSubscriptions;
+const uint8_t CHECK_PAYLOAD[2] = { 0x00, 0x10 };
+volatile uint32_t staleCalls = 0;
+volatile uint32_t checkCalls = 0;
+SubscriptionId selfRemoving = INVALID_SUBSCRIPTION;
+
+void dispatchFocus() {
+  checkSubscriptions.dispatch(CAT_LENS, Lens::Focus::ID, CHECK_PAYLOAD, sizeof(CHECK_PAYLOAD), true);
+}
+
+// A callback that unsubscribes itself finishes with its capture intact
+// and never runs again
+bool checkUnsubscribeInCallback() {
+  staleCalls = 0;
+  checkCalls = 0;
+  bool removed = false;
+  Canary canary;
+  selfRemoving = checkSubscriptions.subscribe(CAT_LENS, Lens::Focus::ID,
+      [canary, &removed](uint8_t, uint8_t, const uint8_t*, size_t) {
+        removed = checkSubscriptions.unsubscribe(selfRemoving);
+        staleCalls = staleCalls + (canary.magic != Canary::ALIVE);
+        checkCalls = checkCalls + 1;
+      }, NotifyMode::AllReports);
+
+  dispatchFocus();
+  dispatchFocus();
+  bool pass = selfRemoving != INVALID_SUBSCRIPTION && removed && checkCalls == 1 && staleCalls == 0 &&
+              checkSubscriptions.getSubscriberCount() == 0;
+
+  Serial.print("check,unsubscribe_in_callback,");
+  Serial.println(pass ? "pass" : "fail");
+  return pass;
+}
+
+const uint32_t CHURN_ROUNDS = 2000;
+volatile bool churnDone = false;
+volatile uint32_t churnFailures = 0;
+
+// Subscribes and unsubscribes on the other core while setup() dispatches
+void churnSubscriptions(void*) {
+  for (uint32_t i = 0; i < CHURN_ROUNDS; i++) {
+    Canary canary;
+    SubscriptionId subscription = checkSubscriptions.subscribe(CAT_LENS, Lens::Focus::ID,
+        [canary](uint8_t, uint8_t, const uint8_t*, size_t) {
+          staleCalls = staleCalls + (canary.magic != Canary::ALIVE);
+          checkCalls = checkCalls + 1;
+        }, NotifyMode::AllReports);
+    if (subscription == INVALID_SUBSCRIPTION || !checkSubscriptions.unsubscribe(subscription)) {
+      churnFailures = churnFailures + 1;
+    }
+  }
+  churnDone = true;
+  vTaskDelete(nullptr);
+}
+
+// Removal racing dispatch must never run a destroyed callable
+bool checkConcurrentRemoval() {
+  staleCalls = 0;
+  checkCalls = 0;
+  churnDone = false;
+  churnFailures = 0;
+
+  bool pass = xTaskCreatePinnedToCore(churnSubscriptions, "bench_churn", 4096, nullptr, 1, nullptr, 0) == pdPASS;
+  while (pass && !churnDone) {
+    dispatchFocus();
+  }
+  pass = pass && churnFailures == 0 && staleCalls == 0 && checkSubscriptions.getSubscriberCount() == 0;
+
+  Serial.print("check,concurrent_unsubscribe,");
+  Serial.println(pass ? "pass" : "fail");
+  return pass;
+}
+
+// A report queued for a deferred subscriber that is then replaced in
+// the same slot reaches neither of them
+bool checkSlotReuse() {
+  staleCalls = 0;
+  checkCalls = 0;
+  SubscriptionId first = checkSubscriptions.subscribe(CAT_LENS, Lens::Focus::ID,
+      [](uint8_t, uint8_t, const uint8_t*, size_t) { staleCalls = staleCalls + 1; },
+      NotifyMode::AllReports, CallbackExecutor::Deferred);
+  dispatchFocus();
+  checkSubscriptions.unsubscribe(first);
+
+  SubscriptionId second = checkSubscriptions.subscribe(CAT_LENS, Lens::Focus::ID,
+      [](uint8_t, uint8_t, const uint8_t*, size_t) { checkCalls = checkCalls + 1; },
+      NotifyMode::AllReports, CallbackExecutor::Deferred);
+  checkSubscriptions.poll();
+  bool pass = (first & 0xFF) == (second & 0xFF) && staleCalls == 0 && checkCalls == 0;
+
+  dispatchFocus();
+  checkSubscriptions.poll();
+  pass = pass && checkCalls == 1 && checkSubscriptions.getDelivered(second) == 1;
+  checkSubscriptions.unsubscribe(second);
+
+  Serial.print("check,deferred_slot_reuse,");
+  Serial.println(pass ? "pass" : "fail");
+  return pass;
+}
+
+void benchmarkUnsubscribe() {
+  checkUnsubscribeInCallback();
+  checkConcurrentRemoval();
+  checkSlotReuse();
+
+  runBenchmark("subscribe_unsubscribe", ITERATIONS / 4, [](uint32_t) {
+    SubscriptionId subscription = checkSubscriptions.subscribe(CAT_LENS, Lens::Focus::ID,
+        [](uint8_t, uint8_t, const uint8_t*, size_t) {}, NotifyMode::AllReports);
+    intSink = checkSubscriptions.unsubscribe(subscription);
+  });
+}
+
+// Focus history: a sample every 10 ms, starting just before millis() wraps
+ParameterHistory benchHistory;
+const size_t HISTORY_CAPACITY = 64;
+const uint32_t HISTORY_START_MS = 0xFFFFFF00u;
+
+void recordFocus(uint32_t i) {
+  auto focus = Lens::Focus::encode((i % 100) / 100.0f, OP_REPORT);
+  benchHistory.record(CAT_LENS, Lens::Focus::ID, focus.data() + 8, Lens::Focus::PAYLOAD_SIZE, true, HISTORY_START_MS + i * 10);
+}
+
+// Time queries must find the right samples across the wrap
+bool checkHistory() {
+  benchHistory.reset();
+  bool pass = benchHistory.enable(CAT_LENS, Lens::Focus::ID, HISTORY_CAPACITY);
+  for (uint32_t i = 0; i < 100; i++) {
+    recordFocus(i);
+  }
+
+  float value = 0.0f;
+  HistoryStats stats;
+  pass = pass && benchHistory.getSize(CAT_LENS, Lens::Focus::ID) == HISTORY_CAPACITY;
+  pass = pass && !benchHistory.valueAt(CAT_LENS, Lens::Focus::ID, HISTORY_START_MS + 355, value);
+  pass = pass && benchHistory.valueAt(CAT_LENS, Lens::Focus::ID, HISTORY_START_MS + 505, value) && fabsf(value - 0.5f) < 0.001f;
+  pass = pass && benchHistory.getStats(CAT_LENS, Lens::Focus::ID, HISTORY_START_MS + 500, HISTORY_START_MS + 600, stats) &&
+         stats.count == 11 && fabsf(stats.mean - 0.55f) < 0.001f;
+
+  Serial.print("check,parameter_history,");
+  Serial.println(pass ? "pass" : "fail");
+  return pass;
+}
+
+void benchmarkHistory() {
+  checkHistory();
+
+  runBenchmark("history_record", ITERATIONS, [](uint32_t i) {
+    recordFocus(i);
+  });
+
+  const uint32_t newest = HISTORY_START_MS + (ITERATIONS - 1) * 10;
+  runBenchmark("history_value_at", ITERATIONS, [&](uint32_t i) {
+    float value = 0.0f;
+    benchHistory.valueAt(CAT_LENS, Lens::Focus::ID, newest - (i % HISTORY_CAPACITY) * 10, value);
+    floatSink = value;
+  });
+
+  runBenchmark("history_stats_full", ITERATIONS / 16, [&](uint32_t) {
+    HistoryStats stats;
+    benchHistory.getStats(CAT_LENS, Lens::Focus::ID, newest - HISTORY_CAPACITY * 10, newest, stats);
+    floatSink = stats.mean;
+  });
+}
+
+void benchmarkSetters() {
+  runBenchmark("set_iso", ITERATIONS, [](uint32_t i) {
+    intSink = camera.set<Video::ISO>(static_cast<int32_t>(100 + (i & 1023)));
+  });
+
+  runBenchmark("set_focus", ITERATIONS, [](uint32_t i) {
+    intSink = camera.set<Lens::Focus>((i & 2047) / 2048.0f);
+  });
+
+  runBenchmark("set_white_balance", ITERATIONS, [](uint32_t i) {
+    intSink = camera.set<Video::WhiteBalance>({ static_cast<int16_t>(3200 + (i & 2047)), 0 });
+  });
+
+  runBenchmark("set_auto_focus", ITERATIONS, [](uint32_t) {
+    intSink = camera.set<Lens::AutoFocus>();
+  });
+
+  runBenchmark("get_iso", ITERATIONS, [](uint32_t) {
+    intSink = camera.get<Video::ISO>(0);
+  });
+}
+
+// Seed packets laid out as the camera reports them: single reports, a
+// padded multi-command burst, a timecode frame and a status byte
+const uint8_t SEED_ISO[] = { 0xFF, 0x08, 0x00, 0x00, 0x01, 0x0E, 0x03, 0x02, 0x20, 0x03, 0x00, 0x00 };
+const uint8_t SEED_WHITE_BALANCE[] = { 0xFF, 0x08, 0x00, 0x00, 0x01, 0x02, 0x02, 0x02, 0x80, 0x0C, 0x00, 0x00 };
+const uint8_t SEED_FOCUS[] = { 0xFF, 0x06, 0x00, 0x00, 0x00, 0x00, 0x80, 0x02, 0x00, 0x04, 0x00, 0x00 };
+const uint8_t SEED_BURST[] = {
+  0xFF, 0x05, 0x00, 0x00, 0x01, 0x08, 0x01, 0x02, 0x02, 0x00, 0x00, 0x00,
+  0xFF, 0x08, 0x00, 0x00, 0x01, 0x0B, 0x03, 0x02, 0x50, 0x46, 0x00, 0x00,
+  0xFF, 0x09, 0x00, 0x00, 0x0A, 0x01, 0x01, 0x02, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+const uint8_t SEED_TIMECODE[] = { 0xFF, 0x08, 0x00, 0x00, 0x07, 0x00, 0x03, 0x02, 0x12, 0x30, 0x45, 0x01 };
+const uint8_t SEED_STATUS[] = { 0x3F };
+
+struct Seed {
+  BMDBLEController::NotificationSource source;
+  const uint8_t* data;
+  size_t length;
+};
+
+const Seed SEEDS[] = {
+  { BMDBLEController::NOTIFY_INCOMING_CONTROL, SEED_ISO, sizeof(SEED_ISO) },
+  { BMDBLEController::NOTIFY_INCOMING_CONTROL, SEED_WHITE_BALANCE, sizeof(SEED_WHITE_BALANCE) },
+  { BMDBLEController::NOTIFY_INCOMING_CONTROL, SEED_FOCUS, sizeof(SEED_FOCUS) },
+  { BMDBLEController::NOTIFY_INCOMING_CONTROL, SEED_BURST, sizeof(SEED_BURST) },
+  { BMDBLEController::NOTIFY_TIMECODE, SEED_TIMECODE, sizeof(SEED_TIMECODE) },
+  { BMDBLEController::NOTIFY_CAMERA_STATUS, SEED_STATUS, sizeof(SEED_STATUS) },
+};
+const size_t SEED_COUNT = sizeof(SEEDS) / sizeof(SEEDS[0]);
+
+const size_t MUTATION_BUFFER = 64;
+uint8_t mutated[MUTATION_BUFFER];
+uint32_t mutationState = 0x9E3779B9;
+
+uint32_t nextRandom() {
+  mutationState ^= mutationState << 13;
+  mutationState ^= mutationState >> 17;
+  mutationState ^= mutationState << 5;
+  return mutationState;
+}
+
+// Flip bits, overwrite bytes with boundary values, truncate or extend a
+// seed. Returns the mutated length.
+size_t mutateSeed(const Seed& seed) {
+  const uint8_t interesting[] = { 0x00, 0x01, 0x03, 0x04, 0x7F, 0x80, 0xFE, 0xFF };
+  size_t length = seed.length;
+  memcpy(mutated, seed.data, length);
+
+  uint32_t edits = 1 + (nextRandom() & 3);
+  for (uint32_t e = 0; e < edits; e++) {
+    uint32_t r = nextRandom();
+    switch (r & 3) {
+      case 0:
+        mutated[(r >> 8) % length] ^= 1 << ((r >> 4) & 7);
+        break;
+      case 1:
+        mutated[(r >> 8) % length] = interesting[(r >> 4) & 7];
+        break;
+      case 2:
+        length = (r >> 8) % (length + 1);
+        break;
+      default:
+        while (length < MUTATION_BUFFER && (r & 0x100) == 0) {
+          mutated[length++] = static_cast<uint8_t>(nextRandom());
+          r >>= 1;
+        }
+        break;
+    }
+    if (length == 0) {
+      break;
+    }
+  }
+  return length;
+}
+
+ParameterCache fuzzCache;
+
+// Every cached payload must still satisfy the schema, however malformed
+// the input was
+bool cacheMatchesSchema(const ParameterCache& cache) {
+  for (size_t i = 0; i < PARAMETER_COUNT; i++) {
+    const ParameterInfo& info = PARAMETER_TABLE[i];
+    uint8_t payload[ParameterCache::MAX_PAYLOAD];
+    size_t length = 0;
+    if (cache.read(info.category, info.id, payload, length) &&
+        !ParameterSchema::validate(info.category, info.id, info.dataType, length)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Mutated captures through the whole ingest path: packet walking, schema
+// checks, cache, timecode and status decoding. A crash or hang here is a
+// bug; the benchmark keeps executions per second visible. For coverage-
+// guided fuzzing of the same path on a desktop, see tools/fuzz.
+void benchmarkIngestRobustness() {
+  const uint32_t executions = ITERATIONS / 2;
+  bool pass = true;
+
+  for (uint32_t i = 0; i < executions && pass; i++) {
+    const Seed& seed = SEEDS[i % SEED_COUNT];
+    size_t length = mutateSeed(seed);
+    fuzzCache.update(mutated, length);
+    camera.injectNotification(seed.source, mutated, length);
+    pass = (i & 1023) != 0 || (cacheMatchesSchema(fuzzCache) && cacheMatchesSchema(camera.getIncomingParameters()));
+  }
+  pass = pass && cacheMatchesSchema(fuzzCache) && cacheMatchesSchema(camera.getIncomingParameters());
+
+  Serial.print("check,ingest_mutation,");
+  Serial.println(pass ? "pass" : "fail");
+
+  runBenchmark("ingest_mutated_packet", executions, [](uint32_t i) {
+    const Seed& seed = SEEDS[i % SEED_COUNT];
+    size_t length = mutateSeed(seed);
+    camera.injectNotification(seed.source, mutated, length);
+  });
+}
+
+void setup() {
+  Serial.begin(115200);
+  delay(1000);
+
+  Serial.println("bench,name,iterations,total_us,ns_per_op");
+  benchmarkAperture();
+  benchmarkFixed16();
+  benchmarkHex();
+  benchmarkCharConv();
+  benchmarkCodec();
+  benchmarkCache();
+  benchmarkDispatch();
+  benchmarkUnsubscribe();
+  benchmarkHistory();
+  benchmarkSetters();
+  benchmarkIngestRobustness();
+  Serial.println("bench,done");
+}
+
+void loop() {
+  delay(1000);
+}
@@ -1,38 +1,117 @@
 #include "BMDBLEController.h"
+#include <esp_timer.h>
+#include "Protocol/ProtocolUtils.h"
 
 BLEScan* BMDBLEController::pBLEScan = nullptr;   // Initialize static member
 BLEClient* BMDBLEController::pClient = nullptr; // Initialize pClient
 bool BMDBLEController::is_connected = false;
+BMDBLEController* BMDBLEController::activeController = nullptr;
 
 
-BMDBLEController::BMDBLEController() :
+BMDBLEController::BMDBLEController(const char* deviceName) :
     pServerAddress(nullptr),
     pOutgoingCameraControl(nullptr),
     pIncomingCameraControl(nullptr),
     pTimecode(nullptr),
     pCameraStatus(nullptr),  // Initialize to nullptr
     rawIncomingData(""),
-    rawTimecodeData("")
+    rawTimecodeData(""),
+    scheduler(timecodeClock, [this](const uint8_t* data, size_t length) { return sendData(data, length); }),
+    deviceName(deviceName)
 {
-    BLEDevice::init("ESP32_BMD_Controller");  // Device name can be changed
+    // Nothing touches the BLE stack here so global instances stay cheap;
+    // see begin()
+    incomingParameters.setClock([]() { return static_cast<uint64_t>(esp_timer_get_time()); });
+    scheduler.setEchoSource([this](uint8_t category, uint8_t id, uint32_t& sequence, uint64_t& changedUs) {
+        return incomingParameters.getChangeInfo(category, id, sequence, changedUs);
+    });
+    incomingParameters.setUpdateCallback([this](uint8_t category, uint8_t id, const uint8_t* payload, size_t length, bool changed) {
+        uint32_t nowMs = millis();
+        if (category == BMDCamera::Video::RecordingFormat::CATEGORY && id == BMDCamera::Video::RecordingFormat::ID) {
+            applyRecordingFormat(payload, length);
+        }
+        parameterHistory.record(category, id, payload, length, changed, nowMs);
+        parameterSubscriptions.dispatch(category, id, payload, length, changed);
+        parameterBatcher.add(category, id, payload, length, changed, nowMs);
+    });
+}
+
+bool BMDBLEController::begin() {
+    InitState expected = InitState::Uninitialized;
+    if (initState.compare_exchange_strong(expected, InitState::Initializing)) {
+        initializeStack();
+        return true;
+    }
+
+    // Already ready, or a beginAsync() is in flight
+    return waitUntilReady();
+}
+
+bool BMDBLEController::beginAsync() {
+    InitState expected = InitState::Uninitialized;
+    if (!initState.compare_exchange_strong(expected, InitState::Initializing)) {
+        return true; // Already started
+    }
+
+    if (xTaskCreate(beginTask, "bmd_ble_init", 4096, this, 1, nullptr) != pdPASS) {
+        // Could not spawn the task; fall back to a synchronous bring-up
+        initializeStack();
+    }
+    return true;
+}
+
+bool BMDBLEController::waitUntilReady(uint32_t timeoutMs) {
+    uint32_t start = millis();
+    while (initState.load() != InitState::Ready) {
+        if (initState.load() == InitState::Uninitialized || millis() - start >= timeoutMs) {
+            return false;
+        }
+        delay(1);
+    }
+    return true;
+}
+
+void BMDBLEController::beginTask(void* param) {
+    static_cast<BMDBLEController*>(param)->initializeStack();
+    vTaskDelete(nullptr);
+}
+
+void BMDBLEController::initializeStack() {
+    uint32_t startMs = millis();
+
+    BLEDevice::init(deviceName.c_str());
     BLEDevice::setPower(ESP_PWR_LVL_P9); // Set max power
 
     pClient = BLEDevice::createClient();
 
+    // Parameter updates confirm link profile switches
+    activeController = this;
+    BLEDevice::setCustomGapHandler(gapEventHandler);
+
     //Setup Security
+    securityCallbacks.reset(new MySecurityCallbacks(this));
     BLEDevice::setEncryptionLevel(ESP_BLE_SEC_ENCRYPT);
-    BLEDevice::setSecurityCallbacks(new MySecurityCallbacks(this));
-    BLESecurity* pSecurity = new BLESecurity();
-    pSecurity->setAuthenticationMode(ESP_LE_AUTH_REQ_SC_BOND);
-    pSecurity->setCapability(ESP_IO_CAP_IN);
-    pSecurity->setRespEncryptionKey(ESP_BLE_ENC_KEY_MASK | ESP_BLE_ID_KEY_MASK);
+    BLEDevice::setSecurityCallbacks(securityCallbacks.get());
+    security.reset(new BLESecurity());
+    security->setAuthenticationMode(ESP_LE_AUTH_REQ_SC_BOND);
+    security->setCapability(ESP_IO_CAP_IN);
+    security->setRespEncryptionKey(ESP_BLE_ENC_KEY_MASK | ESP_BLE_ID_KEY_MASK);
 
+    advertisedDeviceCallbacks.reset(new MyAdvertisedDeviceCallbacks(this));
     pBLEScan = BLEDevice::getScan(); //create new scan
-    pBLEScan->setAdvertisedDeviceCallbacks(new MyAdvertisedDeviceCallbacks(this));
+    pBLEScan->setAdvertisedDeviceCallbacks(advertisedDeviceCallbacks.get());
     pBLEScan->setActiveScan(true); //active scan uses more power, but get results faster
     pBLEScan->setInterval(100);
     pBLEScan->setWindow(99);  //should be less or equal RSSI interval
 
+    // Trace records from the BLE callbacks are printed from an idle-priority task
+    if (traceOutput != nullptr) {
+        BMDCamera::TraceLog::instance().startDrainTask(*traceOutput, traceFormat);
+    }
+
+    bootToReadyMs = millis();
+    beginDurationMs = bootToReadyMs - startMs;
+    initState.store(InitState::Ready);
 }
 
 BMDBLEController::~BMDBLEController() {
@@ -43,26 +122,32 @@ BMDBLEController::~BMDBLEController() {
     // Clean up other resources if necessary
 }
 void BMDBLEController::MyAdvertisedDeviceCallbacks::onResult(BLEAdvertisedDevice advertisedDevice) {
-    Serial.printf("Advertised Device Found: %s\n", advertisedDevice.toString().c_str());
+    // Runs on the BLE task for every advertisement; trace instead of printing
+    BLEAddress deviceAddress = advertisedDevice.getAddress();
+    const uint8_t* address = *deviceAddress.getNative();
+    BMD_TRACE_DEBUG(BMDCamera::TRACE_DEVICE_FOUND, BMDCamera::traceBytes(address, 4),
+                    BMDCamera::traceBytes(address + 4, 2), static_cast<uint32_t>(advertisedDevice.getRSSI()));
 
     if (advertisedDevice.haveServiceUUID() && advertisedDevice.isAdvertisingService(BLEUUID(SERVICE_UUID))) {
         BLEDevice::getScan()->stop();
-        bmdController->pServerAddress = new BLEAddress(advertisedDevice.getAddress());
+        bmdController->pServerAddress = new BLEAddress(deviceAddress);
         bmdController->doConnect = true;
         bmdController->doScan = false; // Stop scanning once device found
-        Serial.println("Formed a connection to the Blackmagic Camera");
+        BMD_TRACE_INFO(BMDCamera::TRACE_CAMERA_FOUND, BMDCamera::traceBytes(address, 4),
+                       BMDCamera::traceBytes(address + 4, 2));
     }
 }
 
 uint32_t BMDBLEController::MySecurityCallbacks::onPassKeyRequest() {
-    Serial.print("PassKeyRequest: ");
-    Serial.println(bmdController->pinCode);
+    BMD_TRACE_INFO(BMDCamera::TRACE_PASSKEY_REQUEST, bmdController->pinCode);
     return bmdController->pinCode;
 }
 
 void BMDBLEController::MySecurityCallbacks::onAuthenticationComplete(esp_ble_auth_cmpl_t auth_cmpl) {
+    bmdController->profiler.endStage(BMDCamera::ConnectionStage::Authentication, auth_cmpl.success);
+
     if (auth_cmpl.success) {
-        Serial.println("Authentication success!");
+        BMD_TRACE_INFO(BMDCamera::TRACE_AUTH_SUCCESS);
         // Save bonding information
         bmdController->preferences.begin("camera", false);
         bmdController->preferences.putBool("authenticated", true);
@@ -72,13 +157,22 @@ void BMDBLEController::MySecurityCallbacks::onAuthenticationComplete(esp_ble_aut
 
     }
     else {
-        Serial.printf("Authentication failed: %d\n", auth_cmpl.fail_reason);
+        BMD_TRACE_ERROR(BMDCamera::TRACE_AUTH_FAILED, auth_cmpl.fail_reason);
         is_connected = false;
     }
 }
 
 
 bool BMDBLEController::connect() {
+    // Bring the stack up on first use
+    if (!begin()) {
+        Serial.println("BLE stack not ready");
+        return false;
+    }
+
+    profiler.beginAttempt();
+    BMDCamera::MetricsRegistry::instance().increment(BMDCamera::Counter::ConnectionAttempts);
+
     preferences.begin("camera", false);
     bool authenticated = preferences.getBool("authenticated", false);
     String savedAddress = preferences.getString("address", "");
@@ -111,23 +205,47 @@ bool BMDBLEController::connect() {
     if (doScan) {
         // Start scanning for devices
         Serial.println("Scanning Started");
+        profiler.ensureAttempt();
+        profiler.startStage(BMDCamera::ConnectionStage::Scan);
         BLEScanResults foundDevices = pBLEScan->start(5, false); // Scan for 5 seconds
         Serial.print("Devices found: ");
         Serial.println(foundDevices.getCount());
         pBLEScan->clearResults();   // delete results fromBLEScan buffer to release memory
+        profiler.endStage(BMDCamera::ConnectionStage::Scan, doConnect);
+
+        // Connect straight away if the scan found a camera
+        if (doConnect) {
+            if (connectToServer()) {
+                Serial.println("Connected to the BLE Server.");
+            }
+            doConnect = false;
+        }
     }
 
+    if (isConnected()) {
+        if (hasConnected) {
+            BMDCamera::MetricsRegistry::instance().increment(BMDCamera::Counter::Reconnects);
+        }
+        hasConnected = true;
+    }
     return isConnected();
 }
 
 
 
 bool BMDBLEController::connectToServer() {
+    profiler.ensureAttempt();
 
+    profiler.startStage(BMDCamera::ConnectionStage::LinkUp);
     if (!pClient->connect(*pServerAddress)) {
         Serial.println("Connection Failed");
+        profiler.endStage(BMDCamera::ConnectionStage::LinkUp, false);
         return false;  // Return false on connection failure
     }
+    profiler.endStage(BMDCamera::ConnectionStage::LinkUp);
+
+    // Encryption/bonding starts once the link is up and completes asynchronously
+    profiler.startStage(BMDCamera::ConnectionStage::Authentication);
 
     if (!discoverServices()) {
         return false; // Return false if service discovery fails
@@ -137,15 +255,20 @@ bool BMDBLEController::connectToServer() {
 }
 
 bool BMDBLEController::discoverServices() {
-     BLERemoteService* pRemoteService = pClient->getService(SERVICE_UUID);
+    profiler.startStage(BMDCamera::ConnectionStage::ServiceDiscovery);
+    BLERemoteService* pRemoteService = pClient->getService(SERVICE_UUID);
     if (pRemoteService == nullptr) {
         Serial.print("Failed to find our service UUID: ");
         Serial.println(SERVICE_UUID);
+        profiler.endStage(BMDCamera::ConnectionStage::ServiceDiscovery, false);
         pClient->disconnect();
         return false;
     }
+    profiler.endStage(BMDCamera::ConnectionStage::ServiceDiscovery);
     Serial.println("Found our service");
 
+    profiler.startStage(BMDCamera::ConnectionStage::CharacteristicLookup);
+
     // Obtain references to the characteristics
     pOutgoingCameraControl = pRemoteService->getCharacteristic(CHARACTERISTIC_UUID_OUTGOING_CAMERA_CONTROL);
     pIncomingCameraControl = pRemoteService->getCharacteristic(CHARACTERISTIC_UUID_INCOMING_CAMERA_CONTROL);
@@ -153,11 +276,18 @@ bool BMDBLEController::discoverServices() {
     pCameraStatus = pRemoteService->getCharacteristic(CHARACTERISTIC_UUID_CAMERA_STATUS);
     pDeviceName = pRemoteService->getCharacteristic(CHARACTERISTIC_UUID_DEVICE_NAME);  // Get device name characteristic
 
-    if (pOutgoingCameraControl == nullptr || pIncomingCameraControl == nullptr || pTimecode == nullptr || pCameraStatus == nullptr) {
+    // Only the characteristics we subscribe to are required
+    bool missing = pOutgoingCameraControl == nullptr
+        || ((subscriptionFlags & SUBSCRIBE_INCOMING_CONTROL) && pIncomingCameraControl == nullptr)
+        || ((subscriptionFlags & SUBSCRIBE_TIMECODE) && pTimecode == nullptr)
+        || ((subscriptionFlags & SUBSCRIBE_CAMERA_STATUS) && pCameraStatus == nullptr);
+    if (missing) {
         Serial.println("Failed to find one or more characteristics");
+        profiler.endStage(BMDCamera::ConnectionStage::CharacteristicLookup, false);
         pClient->disconnect();
         return false;
     }
+    profiler.endStage(BMDCamera::ConnectionStage::CharacteristicLookup);
     Serial.println("Found our characteristics");
     // Trigger bonding by writing to device name (if not already bonded)
     if (!isConnected()) {
@@ -167,15 +297,31 @@ bool BMDBLEController::discoverServices() {
     }
 
     // Register for notifications
-    pIncomingCameraControl->registerForNotify(controlNotifyCallback);
-    pTimecode->registerForNotify(timecodeNotifyCallback);
-    pCameraStatus->registerForNotify(cameraStatusNotifyCallback);
+    profiler.startStage(BMDCamera::ConnectionStage::NotificationSubscription);
+    if (subscriptionFlags & SUBSCRIBE_INCOMING_CONTROL) {
+        pIncomingCameraControl->registerForNotify(controlNotifyCallback);
+    }
+    if (subscriptionFlags & SUBSCRIBE_TIMECODE) {
+        pTimecode->registerForNotify(timecodeNotifyCallback);
+    }
+    if (subscriptionFlags & SUBSCRIBE_CAMERA_STATUS) {
+        pCameraStatus->registerForNotify(cameraStatusNotifyCallback);
+    }
+    profiler.endStage(BMDCamera::ConnectionStage::NotificationSubscription);
+
+    // The attempt is complete once the camera sends its first notification
+    profiler.startStage(BMDCamera::ConnectionStage::FirstReport);
 
     return true;
 
 }
 
 bool BMDBLEController::disconnect() {
+    linkProfile.reset();
+    portENTER_CRITICAL(&linkLock);
+    negotiatedLink = BMDCamera::NegotiatedLinkParameters();
+    portEXIT_CRITICAL(&linkLock);
+    cameraStatus.reset();
     if (isConnected()) {
         pClient->disconnect();
         is_connected = false; // Update connection status
@@ -188,11 +334,125 @@ bool BMDBLEController::isConnected() {
     return is_connected; // Use the static variable
 }
 
+void BMDBLEController::loop() {
+    profiler.poll();
+    scheduler.poll(micros());
+    parameterSubscriptions.poll();
+    parameterBatcher.poll(millis());
+
+    // The queue has drained once the scheduler is empty; sent commands stop
+    // holding the link active once reported back or timed out
+    linkActivity.setQueueDepth(scheduler.pending());
+    if (unreportedCommands.load() > 0 && millis() - lastCommandMs >= COMMAND_REPORT_TIMEOUT_MS) {
+        unreportedCommands.store(0);
+    }
+    linkActivity.setPendingRequests(unreportedCommands.load());
+    updateLinkProfile();
+
+    BMDCamera::MetricsRegistry& metrics = BMDCamera::MetricsRegistry::instance();
+    metrics.setGauge(BMDCamera::Gauge::ScheduledCommands, static_cast<int32_t>(scheduler.pending()));
+    metrics.setGauge(BMDCamera::Gauge::FreeHeap, static_cast<int32_t>(ESP.getFreeHeap()));
+    metrics.setGauge(BMDCamera::Gauge::HeapLowWater, static_cast<int32_t>(ESP.getMinFreeHeap()));
+}
+
+void BMDBLEController::setAutoLinkProfile(bool enabled, uint32_t idleTimeoutMs) {
+    autoLinkProfile = enabled;
+    linkActivity.setIdleTimeout(idleTimeoutMs);
+}
+
+void BMDBLEController::updateLinkProfile() {
+    if (!autoLinkProfile || !isConnected() || pServerAddress == nullptr) {
+        return;
+    }
+
+    uint32_t now = millis();
+    linkProfile.update(linkActivity.desiredProfile(now), *pServerAddress->getNative(), now);
+}
+
+BMDCamera::NegotiatedLinkParameters BMDBLEController::getNegotiatedLinkParameters() const {
+    portENTER_CRITICAL(&linkLock);
+    BMDCamera::NegotiatedLinkParameters params = negotiatedLink;
+    portEXIT_CRITICAL(&linkLock);
+    return params;
+}
+
+void BMDBLEController::gapEventHandler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t* param) {
+    BMDBLEController* controller = activeController;
+    if (controller == nullptr || event != ESP_GAP_BLE_UPDATE_CONN_PARAMS_EVT) {
+        return;
+    }
+
+    bool success = param->update_conn_params.status == ESP_BT_STATUS_SUCCESS;
+    controller->linkProfile.onParametersUpdated(success, param->update_conn_params.conn_int,
+                                                param->update_conn_params.latency,
+                                                param->update_conn_params.timeout);
+    if (success) {
+        portENTER_CRITICAL(&controller->linkLock);
+        controller->negotiatedLink.interval = param->update_conn_params.conn_int;
+        controller->negotiatedLink.slaveLatency = param->update_conn_params.latency;
+        controller->negotiatedLink.supervisionTimeout = param->update_conn_params.timeout;
+        portEXIT_CRITICAL(&controller->linkLock);
+    }
+}
+
+std::optional<BMDCamera::IncomingCameraControlManager::ParameterData>
+BMDBLEController::getParameter(BMDCamera::Category category, uint8_t id) const {
+    uint8_t key = static_cast<uint8_t>(category);
+    const BMDCamera::ParameterInfo* info = BMDCamera::ParameterSchema::find(key, id);
+    if (info == nullptr || !BMDCamera::ParameterCache::caches(*info)) {
+        std::lock_guard<std::mutex> guard(otherParametersMutex);
+        return otherParameters.getParameter(category, id);
+    }
+
+    uint8_t payload[BMDCamera::ParameterCache::MAX_PAYLOAD];
+    size_t length = 0;
+    if (!incomingParameters.read(key, id, payload, length)) {
+        return std::nullopt;
+    }
+
+    BMDCamera::IncomingCameraControlManager::ParameterData data;
+    data.rawData.assign(payload, payload + length);
+    data.dataType = static_cast<BMDCamera::DataType>(info->dataType);
+    uint32_t sequence = 0;
+    uint64_t changedUs = 0;
+    if (incomingParameters.getChangeInfo(key, id, sequence, changedUs)) {
+        data.timestamp = changedUs / 1000;
+    }
+    return data;
+}
+
+bool BMDBLEController::sendCommand(BMDCamera::Category category, uint8_t id, BMDCamera::DataType dataType,
+                                   BMDCamera::OperationType operation, const std::vector<uint8_t>& payload) {
+    // The length byte can't describe a longer command
+    if (payload.size() > 255 - 4) {
+        return false;
+    }
+    std::vector<uint8_t> packet = BMDCamera::ProtocolUtils::createCommandPacket(category, id, dataType, operation, payload);
+    return sendData(packet.data(), packet.size());
+}
+
+uint32_t BMDBLEController::scheduleCommand(const BMDCamera::Timecode& at, const uint8_t* packet, size_t length) {
+    if (packet == nullptr || length == 0) {
+        return 0;
+    }
+    return scheduler.schedule(at, std::vector<uint8_t>(packet, packet + length));
+}
+
 bool BMDBLEController::sendData(const uint8_t* data, size_t length) {
     if (isConnected() && pOutgoingCameraControl != nullptr) {
         pOutgoingCameraControl->writeValue((uint8_t*)data, length); // Cast away const
+        BMDCamera::MetricsRegistry::instance().increment(BMDCamera::Counter::CommandsSent);
+
+        // Go active straight away rather than on the next loop()
+        lastCommandMs = millis();
+        unreportedCommands++;
+        linkActivity.noteOutgoing(lastCommandMs, scheduler.pending());
+        if (linkProfile.getProfile() != BMDCamera::LinkProfile::Active) {
+            updateLinkProfile();
+        }
         return true;
     }
+    BMDCamera::MetricsRegistry::instance().increment(BMDCamera::Counter::CommandsDropped);
     return false;
 }
 
@@ -200,31 +460,200 @@ bool BMDBLEController::sendData(const uint8_t* data, size_t length) {
 
 void BMDBLEController::controlNotifyCallback(BLERemoteCharacteristic* pBLERemoteCharacteristic, uint8_t* pData, size_t length, bool isNotify) {
     // Correctly access the BMDBLEController instance:
-    ((BMDBLEController*)pBLERemoteCharacteristic->getRemoteService()->getClient()->getData())->rawIncomingData = std::string((char*)pData, length);
-
-    Serial.print("Incoming Camera Control Notify callback, Data: ");
-    Serial.println(((BMDBLEController*)pBLERemoteCharacteristic->getRemoteService()->getClient()->getData())->rawIncomingData.c_str());
-     // Add your parsing logic here, based on the actual data format
+    BMDBLEController* controller = (BMDBLEController*)pBLERemoteCharacteristic->getRemoteService()->getClient()->getData();
+    controller->handleNotification(NOTIFY_INCOMING_CONTROL, pData, length);
 }
 
 void BMDBLEController::timecodeNotifyCallback(BLERemoteCharacteristic* pBLERemoteCharacteristic, uint8_t* pData, size_t length, bool isNotify) {
-   ((BMDBLEController*)pBLERemoteCharacteristic->getRemoteService()->getClient()->getData())->rawTimecodeData = std::string((char*)pData, length);
-    Serial.print("Timecode Notify callback, Data: ");
-    Serial.println(((BMDBLEController*)pBLERemoteCharacteristic->getRemoteService()->getClient()->getData())->rawTimecodeData.c_str());
-    // Add your parsing logic here
+    BMDBLEController* controller = (BMDBLEController*)pBLERemoteCharacteristic->getRemoteService()->getClient()->getData();
+    controller->handleNotification(NOTIFY_TIMECODE, pData, length);
 }
 
 void BMDBLEController::cameraStatusNotifyCallback(BLERemoteCharacteristic * pBLERemoteCharacteristic, uint8_t * pData, size_t length, bool isNotify)
 {
-    ((BMDBLEController*)pBLERemoteCharacteristic->getRemoteService()->getClient()->getData())->rawCameraStatusData = std::string((char*)pData, length);
-    Serial.print("Camera Status Notify callback, Data: ");
-    Serial.println(((BMDBLEController*)pBLERemoteCharacteristic->getRemoteService()->getClient()->getData())->rawCameraStatusData.c_str());
+    BMDBLEController* controller = (BMDBLEController*)pBLERemoteCharacteristic->getRemoteService()->getClient()->getData();
+    controller->handleNotification(NOTIFY_CAMERA_STATUS, pData, length);
+}
+
+void BMDBLEController::handleNotification(NotificationSource source, const uint8_t* pData, size_t length)
+{
+    static const BMDCamera::Counter packetCounters[NOTIFY_SOURCE_COUNT] = {
+        BMDCamera::Counter::PacketsIncomingControl,
+        BMDCamera::Counter::PacketsTimecode,
+        BMDCamera::Counter::PacketsCameraStatus
+    };
+    std::string* latest[NOTIFY_SOURCE_COUNT] = {
+        &rawIncomingData, &rawTimecodeData, &rawCameraStatusData
+    };
+    BMDCamera::MetricsRegistry& metrics = BMDCamera::MetricsRegistry::instance();
+    metrics.increment(packetCounters[source]);
+
+    // Only control reports are traffic; timecode and status keep coming
+    // while the camera is otherwise idle
+    if (source == NOTIFY_INCOMING_CONTROL) {
+        linkActivity.noteIncoming(millis());
+        unreportedCommands.store(0);
+    }
+
+    // Always keep the latest value; assign() reuses the existing buffer
+    latest[source]->assign((const char*)pData, length);
+    recordFirstReport();
+
+    // Keep the local clock anchored even when delivery is decimated
+    BMDCamera::Timecode timecode;
+    if (source == NOTIFY_TIMECODE && BMDCamera::TimecodeDecoder::decode(pData, length, timecode)) {
+        timecodeClock.update(timecode, micros());
+    }
+
+    // Reported parameter values back get<P>()
+    if (source == NOTIFY_INCOMING_CONTROL) {
+        if (incomingParameters.update(pData, length) == 0) {
+            const BMDCamera::ParameterInfo* info =
+                length >= 8 ? BMDCamera::ParameterSchema::find(pData[4], pData[5]) : nullptr;
+            if (info != nullptr && BMDCamera::ParameterCache::caches(*info)) {
+                metrics.increment(BMDCamera::Counter::PacketsRejected);
+            } else {
+                // Strings and unknown ids; malformed packets are counted there
+                std::lock_guard<std::mutex> guard(otherParametersMutex);
+                otherParameters.processIncomingPacket(pData, length);
+            }
+        }
+        parameterBatcher.endCycle();
+    }
+
+    // Status change events fire only for bits that actually changed
+    BMDCamera::CameraStatus status;
+    if (source == NOTIFY_CAMERA_STATUS && BMDCamera::CameraStatus::decode(pData, length, status)) {
+        cameraStatus.update(status);
+    }
+
+    NotificationStream& stream = notificationStreams[source];
+    stream.received++;
+
+    if (verboseNotifications) {
+        BMD_TRACE_INFO(BMDCamera::TRACE_NOTIFY, source, length, BMDCamera::traceBytes(pData, length));
+    }
+
+    // Hold a reference so the sketch can replace the callback meanwhile
+    portENTER_CRITICAL(&stream.lock);
+    std::shared_ptr<const NotificationCallback> callback = stream.callback;
+    portEXIT_CRITICAL(&stream.lock);
+
+    // Decimate and throttle before spending any time on the application
+    if (!callback) {
+        return;
+    }
+    if (++stream.counter < stream.decimation) {
+        return;
+    }
+    uint32_t now = millis();
+    if (stream.minIntervalMs > 0 && stream.delivered > 0 && now - stream.lastDeliveryMs < stream.minIntervalMs) {
+        return;
+    }
+
+    stream.counter = 0;
+    stream.lastDeliveryMs = now;
+    stream.delivered++;
+
+    BMDCamera::ScopedMetricsTimer timer(BMDCamera::Histogram::CallbackMicros);
+    (*callback)(pData, length);
+}
+
+void BMDBLEController::setNotificationCallback(NotificationSource source, NotificationCallback cb)
+{
+    if (source >= NOTIFY_SOURCE_COUNT) {
+        return;
+    }
+
+    // Allocate outside the lock; the old callback is released after it,
+    // or by a call still running on the BLE task
+    std::shared_ptr<const NotificationCallback> replacement;
+    if (cb) {
+        replacement = std::make_shared<const NotificationCallback>(std::move(cb));
+    }
 
+    NotificationStream& stream = notificationStreams[source];
+    portENTER_CRITICAL(&stream.lock);
+    stream.callback.swap(replacement);
+    portEXIT_CRITICAL(&stream.lock);
+}
+
+void BMDBLEController::setNotificationDecimation(NotificationSource source, uint16_t everyN, uint32_t minIntervalMs)
+{
+    if (source < NOTIFY_SOURCE_COUNT) {
+        NotificationStream& stream = notificationStreams[source];
+        stream.decimation = everyN > 0 ? everyN : 1;
+        stream.minIntervalMs = minIntervalMs;
+        stream.counter = 0;
+    }
+}
+
+uint32_t BMDBLEController::getNotificationsReceived(NotificationSource source) const
+{
+    return source < NOTIFY_SOURCE_COUNT ? notificationStreams[source].received : 0;
+}
+
+uint32_t BMDBLEController::getNotificationsDelivered(NotificationSource source) const
+{
+    return source < NOTIFY_SOURCE_COUNT ? notificationStreams[source].delivered : 0;
+}
+
+void BMDBLEController::recordFirstReport()
+{
+    // Close out the connection profile on the first notification after
+    // subscribing; later ones, and a racing timeout, find it finished
+    profiler.finishWithStage(BMDCamera::ConnectionStage::FirstReport);
 }
 
 String BMDBLEController::getTimecode()
 {
-    return String(rawTimecodeData.c_str()); //Simple return you MUST PARSE IT
+    BMDCamera::Timecode timecode;
+    if (!getTimecode(timecode)) {
+        return String(rawTimecodeData.c_str());
+    }
+
+    char buffer[BMDCamera::TIMECODE_STRING_SIZE];
+    timecode.format(buffer, sizeof(buffer));
+    return String(buffer);
+}
+
+bool BMDBLEController::getTimecode(BMDCamera::Timecode& timecode) const
+{
+    // Decoded on the BLE task; the clock hands it over under its lock
+    BMDCamera::TimecodeClock::Snapshot clock = timecodeClock.snapshot();
+    if (!clock.hasReported) {
+        return false;
+    }
+    timecode = clock.reported;
+    return true;
+}
+
+void BMDBLEController::applyRecordingFormat(const uint8_t* payload, size_t length)
+{
+    // Timecode counts file frames: [file rate, sensor rate, width, height,
+    // flags], with flag bit 0 marking an M-rate (x1000/1001) file rate
+    BMDCamera::Video::RecordingFormat::Value format;
+    if (!BMDCamera::Video::RecordingFormat::decode(payload, length, format) || format[0] <= 0) {
+        return;
+    }
+
+    uint32_t rate = static_cast<uint32_t>(format[0]);
+    if ((format[4] & 0x01) != 0) {
+        timecodeClock.setFrameRate(rate * 1000, 1001);
+    } else {
+        timecodeClock.setFrameRate(rate, 1);
+    }
+}
+
+bool BMDBLEController::getCurrentTimecode(BMDCamera::Timecode& timecode) const
+{
+    // One copy of the anchor, which the BLE task may move at any time
+    BMDCamera::TimecodeClock::Snapshot clock = timecodeClock.snapshot();
+    if (!clock.valid) {
+        return false;
+    }
+    timecode = clock.timecodeAt(micros());
+    return true;
 }
 
 String BMDBLEController::getCameraStatus()
@@ -7,6 +7,28 @@
 #include <BLEScan.h>
 #include <BLEAdvertisedDevice.h>
 #include <Preferences.h>  // For storing bonding info
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include "Connection/ConnectionProfiler.h"
+#include "Connection/LinkActivityMonitor.h"
+#include "Connection/LinkParameters.h"
+#include "Connection/LinkProfileSwitcher.h"
+#include "Protocol/Timecode.h"
+#include "Protocol/CameraStatus.h"
+#include "Protocol/TimecodeScheduler.h"
+#include "Protocol/Parameters.h"
+#include "Protocol/ParameterCache.h"
+#include "Protocol/ParameterSubscriptions.h"
+#include "Protocol/ParameterBatch.h"
+#include "Protocol/ParameterHistory.h"
+#include "Protocol/IncomingCameraControlManager.h"
+#include "Diagnostics/TraceLog.h"
+#include "Diagnostics/Metrics.h"
 
 #define SERVICE_UUID "291d567a-6d75-11e6-8b77-86f30ca893d3"
 #define CHARACTERISTIC_UUID_OUTGOING_CAMERA_CONTROL "f1e4fc02-6d76-11e6-8b77-86f30ca893d3"
@@ -18,16 +40,200 @@
 
 class BMDBLEController {
 public:
-    BMDBLEController();
+    // Notifying characteristics the controller can subscribe to
+    enum NotificationSource : uint8_t {
+        NOTIFY_INCOMING_CONTROL = 0,
+        NOTIFY_TIMECODE = 1,
+        NOTIFY_CAMERA_STATUS = 2,
+        NOTIFY_SOURCE_COUNT = 3
+    };
+
+    // Bit flags for setSubscriptions()
+    static constexpr uint8_t SUBSCRIBE_INCOMING_CONTROL = 1 << NOTIFY_INCOMING_CONTROL;
+    static constexpr uint8_t SUBSCRIBE_TIMECODE = 1 << NOTIFY_TIMECODE;
+    static constexpr uint8_t SUBSCRIBE_CAMERA_STATUS = 1 << NOTIFY_CAMERA_STATUS;
+    static constexpr uint8_t SUBSCRIBE_ALL = SUBSCRIBE_INCOMING_CONTROL | SUBSCRIBE_TIMECODE | SUBSCRIBE_CAMERA_STATUS;
+
+    // Called with the raw notification bytes
+    using NotificationCallback = std::function<void(const uint8_t* data, size_t length)>;
+
+    // Construction is cheap; the BLE stack is brought up by begin()
+    explicit BMDBLEController(const char* deviceName = "ESP32_BMD_Controller");
     ~BMDBLEController();
 
+    // Bring up the BLE stack, client, security and scanner. Called lazily by
+    // connect() if the sketch has not done so; safe to call more than once.
+    bool begin();
+
+    // Bring up the BLE stack on a background task so setup() can continue
+    // with other boot work. connect() waits for it to finish.
+    bool beginAsync();
+
+    // Block until the stack is ready (or the timeout expires)
+    bool waitUntilReady(uint32_t timeoutMs = 5000);
+
+    bool isReady() const { return initState.load() == InitState::Ready; }
+
+    // millis() since boot at which the stack became ready (0 if not yet)
+    uint32_t getBootToReadyMs() const { return bootToReadyMs; }
+
+    // Time spent inside the stack bring-up itself
+    uint32_t getBeginDurationMs() const { return beginDurationMs; }
+
     bool connect();
     bool disconnect();
     bool isConnected();
 
+    // Service periodic work (scheduled commands). Call from the sketch's loop().
+    void loop();
+
     // Send data to the camera
     bool sendData(const uint8_t* data, size_t length);
 
+    // Run a notification through the same path as the BLE callbacks, as if
+    // the camera had sent it (replaying captures, benchmarks)
+    void injectNotification(NotificationSource source, const uint8_t* data, size_t length) {
+        if (source < NOTIFY_SOURCE_COUNT && data != nullptr) {
+            handleNotification(source, data, length);
+        }
+    }
+
+    // Typed parameter access, e.g. set<BMDCamera::Video::ISO>(800). The
+    // packet is laid out at compile time from the descriptor, so the value
+    // can't be sent with the wrong data type or size.
+    template <typename P>
+    bool set(const typename P::Value& value) {
+        auto packet = P::encode(value);
+        return sendData(packet.data(), packet.size());
+    }
+
+    // Commands without a value, e.g. set<BMDCamera::Lens::AutoFocus>()
+    template <typename P>
+    bool set() {
+        static_assert(std::is_same<typename P::Value, BMDCamera::Trigger>::value,
+                      "Only void commands can be sent without a value");
+        return set<P>(BMDCamera::Trigger{});
+    }
+
+    // Add to the camera's current value instead of replacing it
+    template <typename P>
+    bool offset(const typename P::Value& delta) {
+        auto packet = P::encode(delta, BMDCamera::OP_OFFSET);
+        return sendData(packet.data(), packet.size());
+    }
+
+    // Last value the camera reported; false if none has arrived yet
+    template <typename P>
+    bool tryGet(typename P::Value& value) const { return incomingParameters.get<P>(value); }
+
+    template <typename P>
+    typename P::Value get(const typename P::Value& fallback = {}) const {
+        typename P::Value value = fallback;
+        return incomingParameters.get<P>(value) ? value : fallback;
+    }
+
+    const BMDCamera::ParameterCache& getIncomingParameters() const { return incomingParameters; }
+
+    // Incremental sync: every change to a cached parameter takes the next
+    // sequence number and is stamped with esp_timer_get_time(), which
+    // never jumps or wraps. Keep the sequence of the last change seen and
+    // ask for what changed after it.
+    uint32_t getParameterSequence() const { return incomingParameters.getSequence(); }
+    size_t getChangesSince(uint32_t sequence, BMDCamera::ChangedParameter* changes, size_t maxChanges) const {
+        return incomingParameters.getChangesSince(sequence, changes, maxChanges);
+    }
+
+    // Runtime-keyed access, as used by the Controls classes. Cached
+    // parameters are read from the ParameterCache; the latest report of a
+    // string or of an id outside the schema is kept separately. Empty if
+    // nothing has been reported for the key.
+    std::optional<BMDCamera::IncomingCameraControlManager::ParameterData> getParameter(BMDCamera::Category category, uint8_t id) const;
+
+    // Send a command from a raw payload; the padding is added here
+    bool sendCommand(BMDCamera::Category category, uint8_t id, BMDCamera::DataType dataType,
+                     BMDCamera::OperationType operation, const std::vector<uint8_t>& payload);
+
+    // Per-parameter callbacks. By default only reports that change the
+    // value are delivered; NotifyMode::AllReports also passes the camera's
+    // repeats through. Any number of callbacks may watch a parameter;
+    // category and id accept BMDCamera::ANY_CATEGORY and
+    // BMDCamera::ANY_PARAMETER. String parameters aren't cached, so they
+    // can't be subscribed to and wildcards skip them. Callbacks run on the
+    // BLE task as reports arrive unless CallbackExecutor::Deferred (run
+    // from loop()) or Worker (see startCallbackWorker) is given. Returns 0
+    // if no slot is free.
+    BMDCamera::SubscriptionId onParameter(uint8_t category, uint8_t id, BMDCamera::ParameterCallback cb,
+                                          BMDCamera::NotifyMode mode = BMDCamera::NotifyMode::ChangesOnly,
+                                          BMDCamera::CallbackExecutor executor = BMDCamera::CallbackExecutor::Inline) {
+        return parameterSubscriptions.subscribe(category, id, std::move(cb), mode, executor);
+    }
+
+    // Typed form, e.g. onParameter<BMDCamera::Video::ISO>([](const int32_t& iso) { ... })
+    template <typename P, typename F>
+    BMDCamera::SubscriptionId onParameter(F cb, BMDCamera::NotifyMode mode = BMDCamera::NotifyMode::ChangesOnly,
+                                          BMDCamera::CallbackExecutor executor = BMDCamera::CallbackExecutor::Inline) {
+        static_assert(P::DATA_TYPE != BMDCamera::TYPE_STRING, "String parameters are not reported to subscribers");
+        return onParameter(P::CATEGORY, P::ID, [cb](uint8_t, uint8_t, const uint8_t* payload, size_t length) {
+            typename P::Value value;
+            if (P::decode(payload, length, value)) {
+                cb(value);
+            }
+        }, mode, executor);
+    }
+
+    // Every parameter in a set of categories, e.g. (1 << CAT_LENS) | (1 << CAT_VIDEO)
+    BMDCamera::SubscriptionId onCategories(uint32_t categoryMask, BMDCamera::ParameterCallback cb,
+                                           BMDCamera::NotifyMode mode = BMDCamera::NotifyMode::ChangesOnly,
+                                           BMDCamera::CallbackExecutor executor = BMDCamera::CallbackExecutor::Inline) {
+        return parameterSubscriptions.subscribeCategories(categoryMask, std::move(cb), mode, executor);
+    }
+
+    bool removeParameterCallback(BMDCamera::SubscriptionId subscription) { return parameterSubscriptions.unsubscribe(subscription); }
+    bool removeParameterCallback(uint8_t category, uint8_t id) { return parameterSubscriptions.unsubscribe(category, id) > 0; }
+    const BMDCamera::ParameterSubscriptions& getParameterSubscriptions() const { return parameterSubscriptions; }
+
+    // Task for CallbackExecutor::Worker callbacks; until it is started they
+    // run from loop() like Deferred ones
+    bool startCallbackWorker(uint32_t stackSize = 4096, UBaseType_t priority = 1) {
+        return parameterSubscriptions.startWorker(stackSize, priority);
+    }
+
+    // Flag parameter callbacks that run longer than budgetMicros (0 = off):
+    // counted per subscription, traced, and passed to the handler
+    void setCallbackBudget(uint32_t budgetMicros, BMDCamera::SlowCallbackHandler handler = nullptr) {
+        parameterSubscriptions.setCallbackBudget(budgetMicros, std::move(handler));
+    }
+
+    // All parameter changes of a notification, or of a time window, in one
+    // call (see ParameterBatcher). Windowed batches are delivered from loop().
+    void setParameterBatchCallback(BMDCamera::ParameterBatchCallback cb, uint32_t windowMs = 0, bool coalesce = true,
+                                   BMDCamera::NotifyMode mode = BMDCamera::NotifyMode::ChangesOnly) {
+        parameterBatcher.setCallback(std::move(cb), windowMs, coalesce, mode);
+    }
+    const BMDCamera::ParameterBatcher& getParameterBatcher() const { return parameterBatcher; }
+
+    // Keep the last capacity reported values of a parameter, with their
+    // millis() times, for queries through getParameterHistory(). Samples
+    // come from a fixed pool (BMD_PARAMETER_HISTORY_SAMPLES).
+    bool enableParameterHistory(uint8_t category, uint8_t id, size_t capacity, uint8_t element = 0,
+                                BMDCamera::NotifyMode mode = BMDCamera::NotifyMode::ChangesOnly) {
+        return parameterHistory.enable(category, id, capacity, element, mode);
+    }
+
+    template <typename P>
+    bool enableParameterHistory(size_t capacity, uint8_t element = 0,
+                                BMDCamera::NotifyMode mode = BMDCamera::NotifyMode::ChangesOnly) {
+        return parameterHistory.enable(P::CATEGORY, P::ID, capacity, element, mode);
+    }
+
+    // Minimum, maximum and mean over the last windowMs
+    bool getParameterStats(uint8_t category, uint8_t id, uint32_t windowMs, BMDCamera::HistoryStats& stats) const {
+        uint32_t now = millis();
+        return parameterHistory.getStats(category, id, now - windowMs, now, stats);
+    }
+
+    const BMDCamera::ParameterHistory& getParameterHistory() const { return parameterHistory; }
+
     // Getters for raw data (for advanced users)
     const std::string& getRawIncomingData() const { return rawIncomingData; }
     const std::string& getRawTimecodeData() const { return rawTimecodeData; }
@@ -35,12 +241,88 @@ public:
 
 
     // Data access methods (you'll add parsing functions here)
-    String getTimecode();
+    String getTimecode();      // "HH:MM:SS:FF", or the raw bytes if undecodable
+    bool getTimecode(BMDCamera::Timecode& timecode) const;  // Last decoded notification
+
+    // Timecode interpolated to the current instant
+    bool getCurrentTimecode(BMDCamera::Timecode& timecode) const;
+    // Follows the file frame rate of Video::RecordingFormat once the camera
+    // reports it; set it here for cameras that don't
+    void setTimecodeFrameRate(uint32_t numerator, uint32_t denominator = 1) { timecodeClock.setFrameRate(numerator, denominator); }
+    const BMDCamera::TimecodeClock& getTimecodeClock() const { return timecodeClock; }
+
+    // Send a complete command packet when the camera reaches a timecode.
+    // Returns an id for cancelling, or 0 if no timecode has been received.
+    // The scheduler's echo callback reports when the camera confirmed it.
+    uint32_t scheduleCommand(const BMDCamera::Timecode& at, const uint8_t* packet, size_t length);
+    bool cancelScheduledCommand(uint32_t id) { return scheduler.cancel(id); }
+    BMDCamera::TimecodeScheduler& getScheduler() { return scheduler; }
     String getCameraStatus();  // Add more as you parse more data
 
+    // Decoded camera status flags, and change events for individual bits
+    BMDCamera::CameraStatus getCameraStatusFlags() const { return cameraStatus.getStatus(); }
+    bool isCameraReady() const { return cameraStatus.getStatus().isCameraReady(); }
+    void setCameraStatusChangeCallback(BMDCamera::CameraStatusChangeCallback cb) { cameraStatus.setChangeCallback(std::move(cb)); }
+
     // Set the PIN code (to be called from the main sketch)
     void setPinCode(uint32_t pin) { pinCode = pin; }
 
+    // Choose which characteristics discoverServices() subscribes to.
+    // Takes effect on the next connection.
+    void setSubscriptions(uint8_t flags) { subscriptionFlags = flags; }
+    uint8_t getSubscriptions() const { return subscriptionFlags; }
+
+    // Application callbacks per characteristic. May be replaced from any
+    // task while notifications arrive; a call already running on the BLE
+    // task finishes with the callback it started with.
+    void setNotificationCallback(NotificationSource source, NotificationCallback cb);
+    void setIncomingControlCallback(NotificationCallback cb) { setNotificationCallback(NOTIFY_INCOMING_CONTROL, std::move(cb)); }
+    void setTimecodeCallback(NotificationCallback cb) { setNotificationCallback(NOTIFY_TIMECODE, std::move(cb)); }
+    void setCameraStatusCallback(NotificationCallback cb) { setNotificationCallback(NOTIFY_CAMERA_STATUS, std::move(cb)); }
+
+    // Ingress throttling: deliver at most every Nth notification and no more
+    // often than minIntervalMs. The latest value is always stored.
+    void setNotificationDecimation(NotificationSource source, uint16_t everyN, uint32_t minIntervalMs = 0);
+    void setTimecodeDecimation(uint16_t everyNFrames) { setNotificationDecimation(NOTIFY_TIMECODE, everyNFrames); }
+
+    // Notifications received and delivered to the application
+    uint32_t getNotificationsReceived(NotificationSource source) const;
+    uint32_t getNotificationsDelivered(NotificationSource source) const;
+
+    // Trace every notification (off by default). Records go to the trace
+    // log rather than straight to Serial, so enabling this doesn't stall
+    // the BLE task.
+    void setVerboseNotifications(bool enabled) { verboseNotifications = enabled; }
+
+    // Where begin() drains trace records (Serial as text by default; nullptr
+    // leaves draining to the sketch). Must be set before begin().
+    void setTraceOutput(Print* out, BMDCamera::TraceFormat format = BMDCamera::TraceFormat::Text) {
+        traceOutput = out;
+        traceFormat = format;
+    }
+
+    // Pipeline counters, queue depths, callback timings and heap usage
+    BMDCamera::MetricsRegistry& getMetrics() const { return BMDCamera::MetricsRegistry::instance(); }
+    void getMetrics(BMDCamera::MetricsSnapshot& snapshot) const { getMetrics().snapshot(snapshot); }
+    void dumpMetrics(Print& out) const { getMetrics().dump(out); }
+
+    // Per-stage timing of the most recent connection attempt
+    BMDCamera::ConnectionReport getConnectionReport() const { return profiler.getLastReport(); }
+    void setConnectionReportCallback(BMDCamera::ConnectionReportCallback cb) { profiler.setReportCallback(std::move(cb)); }
+
+    // Switch the connection between the active and idle parameter profiles
+    // with control traffic (see LinkActivityMonitor). Sends and control
+    // reports count as activity; commands waiting in the scheduler, and
+    // sent commands the camera hasn't reported back yet, keep the link
+    // active. loop() drops it to idle after idleTimeoutMs of quiet.
+    // The profile only changes once the camera reports the new parameters.
+    void setAutoLinkProfile(bool enabled, uint32_t idleTimeoutMs = 2000);
+    void setActiveLinkParameters(const BMDCamera::ConnectionParameters& params) { linkProfile.setActiveParameters(params); }
+    void setIdleLinkParameters(const BMDCamera::ConnectionParameters& params) { linkProfile.setIdleParameters(params); }
+    BMDCamera::LinkProfile getLinkProfile() const { return linkProfile.getProfile(); }
+
+    // Connection timing in effect, as last reported by the stack (interval 0 until then)
+    BMDCamera::NegotiatedLinkParameters getNegotiatedLinkParameters() const;
 
 private:
     static void controlNotifyCallback(BLERemoteCharacteristic* pBLERemoteCharacteristic, uint8_t* pData, size_t length, bool isNotify);
@@ -48,8 +330,26 @@ private:
     static void cameraStatusNotifyCallback(BLERemoteCharacteristic* pBLERemoteCharacteristic, uint8_t* pData, size_t length, bool isNotify);
 
 
+    enum class InitState : uint8_t {
+        Uninitialized,
+        Initializing,
+        Ready
+    };
+
+    static void beginTask(void* param); // FreeRTOS entry point for beginAsync()
+    void initializeStack();             // The actual bring-up work
+
     bool connectToServer(); //Handles conneciton to server
     bool discoverServices(); // Discover services and characteristics
+    void handleNotification(NotificationSource source, const uint8_t* pData, size_t length);
+    void recordFirstReport(); // Completes the connection profile
+    void applyRecordingFormat(const uint8_t* payload, size_t length); // Sets the timecode frame rate
+    void updateLinkProfile(); // Requests the profile link activity calls for
+
+    // GAP events arrive through a plain function pointer, so they go to the
+    // controller that brought up the stack
+    static BMDBLEController* activeController;
+    static void gapEventHandler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t* param);
 
     BLEAddress* pServerAddress;
     bool deviceFound = false;
@@ -66,11 +366,59 @@ private:
     std::string rawTimecodeData;
     std::string rawCameraStatusData;
 
+    // Per-characteristic delivery state
+    struct NotificationStream {
+        std::shared_ptr<const NotificationCallback> callback; // Swapped under lock
+        portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+        uint16_t decimation = 1;     // Deliver every Nth notification
+        uint16_t counter = 0;
+        uint32_t minIntervalMs = 0;  // Minimum time between deliveries
+        uint32_t lastDeliveryMs = 0;
+        uint32_t received = 0;
+        uint32_t delivered = 0;
+    };
+    NotificationStream notificationStreams[NOTIFY_SOURCE_COUNT];
+    BMDCamera::TimecodeClock timecodeClock; // Also holds the last decoded timecode
+    BMDCamera::CameraStatusTracker cameraStatus;
+    BMDCamera::TimecodeScheduler scheduler;
+    BMDCamera::ParameterCache incomingParameters; // Latest reported value per parameter
+    BMDCamera::ParameterSubscriptions parameterSubscriptions; // Fed by incomingParameters
+    BMDCamera::ParameterBatcher parameterBatcher;
+    BMDCamera::ParameterHistory parameterHistory;
+
+    // Reports the ParameterCache doesn't hold. These allocate, so they use
+    // a mutex rather than a spinlock.
+    BMDCamera::IncomingCameraControlManager otherParameters;
+    mutable std::mutex otherParametersMutex;
+
+    uint8_t subscriptionFlags = SUBSCRIBE_ALL;
+    bool verboseNotifications = false;
+    Print* traceOutput = &Serial;
+    BMDCamera::TraceFormat traceFormat = BMDCamera::TraceFormat::Text;
+
+    bool hasConnected = false; // Later successful connections count as reconnects
+
     uint32_t pinCode = 0; // Store the PIN code
     static BLEScan* pBLEScan; // Declare pBLEScan as a static member
     static BLEClient* pClient; // Declare pClient
     static bool is_connected;
     Preferences preferences;
+    BMDCamera::ConnectionProfiler profiler; // Connection setup stage timings
+
+    // Activity-driven link profile switching
+    static constexpr uint32_t COMMAND_REPORT_TIMEOUT_MS = 500; // Not every command is reported back
+    BMDCamera::LinkActivityMonitor linkActivity;
+    bool autoLinkProfile = false;
+    BMDCamera::LinkProfileSwitcher linkProfile; // Confirmed by the GAP handler
+    BMDCamera::NegotiatedLinkParameters negotiatedLink; // Under linkLock, set on the BLE task
+    mutable portMUX_TYPE linkLock = portMUX_INITIALIZER_UNLOCKED;
+    uint32_t lastCommandMs = 0;
+    std::atomic<uint16_t> unreportedCommands{0}; // Sent since the camera last reported
+
+    std::string deviceName;
+    std::atomic<InitState> initState{InitState::Uninitialized};
+    uint32_t bootToReadyMs = 0;
+    uint32_t beginDurationMs = 0;
 
     // Inner class for advertisement callbacks
     class MyAdvertisedDeviceCallbacks : public BLEAdvertisedDeviceCallbacks {
@@ -91,6 +439,11 @@ private:
         void onAuthenticationComplete(esp_ble_auth_cmpl_t auth_cmpl) override;
         bool onConfirmPIN(uint32_t pin) override { return true; }; // Always accept (for simplicity)
     };
+
+    // Created by begin(), owned here because the BLE stack only keeps pointers
+    std::unique_ptr<MySecurityCallbacks> securityCallbacks;
+    std::unique_ptr<MyAdvertisedDeviceCallbacks> advertisedDeviceCallbacks;
+    std::unique_ptr<BLESecurity> security;
 };
 
 #endif // BMDBLECONTROLLER_H
@@ -4,6 +4,8 @@
 
 namespace BMDCamera {
 
+BLEConnectionManager* BLEConnectionManager::s_activeManager = nullptr;
+
 // Constructor
 BLEConnectionManager::BLEConnectionManager(
     CallbackManager* callbackManager,
@@ -16,17 +18,17 @@ BLEConnectionManager::BLEConnectionManager(
     m_scanCallback = std::unique_ptr<ScanCallback>(new ScanCallback(this));
     m_securityCallbacks = std::unique_ptr<SecurityCallbacks>(new SecurityCallbacks(this));
     
-    // Load any saved bonding information
-    m_preferences.begin("bmd-camera", false);
-    if (m_preferences.isKey("camera_addr")) {
-        m_savedCameraAddress = m_preferences.getString("camera_addr", "").c_str();
-    }
-    m_preferences.end();
+    // Saved bonding information is loaded on first use so that constructing
+    // a global instance does not touch NVS
 }
 
 // Destructor
 BLEConnectionManager::~BLEConnectionManager() {
     disconnect();
+    
+    if (s_activeManager == this) {
+        s_activeManager = nullptr;
+    }
 }
 
 // Start scanning for Blackmagic cameras
@@ -43,16 +45,25 @@ bool BLEConnectionManager::startScan(uint32_t duration) {
     BLEScan* pBLEScan = BLEDevice::getScan();
     
     // Set the callback and start scanning
+    m_profiler.beginAttempt();
+    m_profiler.startStage(ConnectionStage::Scan);
     pBLEScan->setAdvertisedDeviceCallbacks(m_scanCallback.get());
     pBLEScan->setActiveScan(true);
     pBLEScan->start(duration, false);
     
+    // The scan callback ends the stage when a camera is found
+    if (!m_profiler.hasCompleted(ConnectionStage::Scan)) {
+        m_profiler.endStage(ConnectionStage::Scan, false);
+    }
+    
     // Return true to indicate scan started
     return true;
 }
 
 // Connect to a discovered camera
 bool BLEConnectionManager::connect() {
+    m_profiler.ensureAttempt();
+    
     // Check if a camera was discovered
     if (m_discoveredCameraAddress.empty()) {
         if (m_callbackManager) {
@@ -69,14 +80,37 @@ bool BLEConnectionManager::connect() {
     // Set up security
     setupBLESecurity();
     
+    // Route link events here and request our MTU during the connection
+    s_activeManager = this;
+    BLEDevice::setCustomGapHandler(gapEventHandler);
+    BLEDevice::setCustomGattcHandler(gattcEventHandler);
+    BLEDevice::setMTU(m_preferredMtu);
+    m_negotiated = NegotiatedLinkParameters();
+    
     // Connect to the device
     BLEAddress bleAddr(m_discoveredCameraAddress);
+    m_profiler.startStage(ConnectionStage::LinkUp);
     if (!m_pClient->connect(bleAddr)) {
+        m_profiler.endStage(ConnectionStage::LinkUp, false);
         if (m_callbackManager) {
             m_callbackManager->onError(ERROR_CONNECTION_FAILED);
         }
         return false;
     }
+    m_profiler.endStage(ConnectionStage::LinkUp);
+    
+    // Authentication completes asynchronously in the security callbacks
+    m_profiler.startStage(ConnectionStage::Authentication);
+    
+    if (!subscribeToCamera()) {
+        m_pClient->disconnect();
+        if (m_callbackManager) {
+            m_callbackManager->onError(ERROR_CONNECTION_FAILED);
+        }
+        return false;
+    }
+    
+    applyLinkPreferences();
     
     // Successfully connected
     if (m_callbackManager) {
@@ -88,6 +122,8 @@ bool BLEConnectionManager::connect() {
 
 // Connect to a specific saved camera address
 bool BLEConnectionManager::connectToSavedCamera() {
+    loadSavedAddress();
+    
     // Check if we have a saved address
     if (m_savedCameraAddress.empty()) {
         if (m_callbackManager) {
@@ -105,6 +141,8 @@ bool BLEConnectionManager::connectToSavedCamera() {
 
 // Disconnect from the current camera
 void BLEConnectionManager::disconnect() {
+    m_linkProfile.reset();
+    
     if (m_pClient && m_pClient->isConnected()) {
         m_pClient->disconnect();
         
@@ -135,6 +173,226 @@ std::string BLEConnectionManager::getCurrentCameraAddress() const {
     return m_discoveredCameraAddress;
 }
 
+bool BLEConnectionManager::requestMtu(uint16_t mtu) {
+    if (mtu < BLE_DEFAULT_MTU || mtu > BLE_MAX_MTU) {
+        return false;
+    }
+    
+    m_preferredMtu = mtu;
+    BLEDevice::setMTU(mtu);
+    
+    if (!isConnected()) {
+        // Exchanged automatically on the next connect
+        return true;
+    }
+    
+    return esp_ble_gattc_send_mtu_req(m_pClient->getGattcIf(), m_pClient->getConnId()) == ESP_OK;
+}
+
+bool BLEConnectionManager::requestConnectionParameters(const ConnectionParameters& params) {
+    if (!isConnected()) {
+        return false;
+    }
+    
+    // Values outside what the specification allows are rejected
+    BLEAddress bleAddr(m_discoveredCameraAddress);
+    return LinkProfileSwitcher::request(*bleAddr.getNative(), params);
+}
+
+bool BLEConnectionManager::requestActiveParameters() {
+    return requestConnectionParameters(m_linkProfile.getParameters(LinkProfile::Active));
+}
+
+bool BLEConnectionManager::requestIdleParameters() {
+    return requestConnectionParameters(m_linkProfile.getParameters(LinkProfile::Idle));
+}
+
+bool BLEConnectionManager::requestPhy2M() {
+#if defined(CONFIG_BT_BLE_50_FEATURES_SUPPORTED)
+    m_prefer2MPhy = true;
+    
+    if (!isConnected()) {
+        // Requested once the link is up
+        return true;
+    }
+    
+    BLEAddress bleAddr(m_discoveredCameraAddress);
+    return esp_ble_gap_set_preferred_phy(
+        *bleAddr.getNative(),
+        0,
+        ESP_BLE_GAP_PHY_2M_PREF_MASK,
+        ESP_BLE_GAP_PHY_2M_PREF_MASK,
+        ESP_BLE_GAP_PHY_OPTIONS_NO_PREF
+    ) == ESP_OK;
+#else
+    // Original ESP32 controller is BLE 4.2 only
+    return false;
+#endif
+}
+
+void BLEConnectionManager::setAutoLinkProfile(bool enabled, uint32_t idleTimeoutMs) {
+    m_autoLinkProfile = enabled;
+    m_activityMonitor.setIdleTimeout(idleTimeoutMs);
+}
+
+void BLEConnectionManager::noteOutgoingActivity(size_t queueDepth) {
+    m_activityMonitor.noteOutgoing(millis(), queueDepth);
+    
+    // Switch to the fast profile straight away rather than on the next loop()
+    if (m_linkProfile.getProfile() != LinkProfile::Active) {
+        updateLinkProfile();
+    }
+}
+
+void BLEConnectionManager::setQueueDepth(size_t queueDepth) {
+    m_activityMonitor.setQueueDepth(queueDepth);
+}
+
+void BLEConnectionManager::noteIncomingActivity() {
+    m_activityMonitor.noteIncoming(millis());
+}
+
+void BLEConnectionManager::setPendingRequests(size_t count) {
+    m_activityMonitor.setPendingRequests(count);
+}
+
+void BLEConnectionManager::loop() {
+    m_profiler.poll();
+    updateLinkProfile();
+}
+
+// Internal method to move the link to the profile activity calls for
+void BLEConnectionManager::updateLinkProfile() {
+    if (!m_autoLinkProfile || !isConnected()) {
+        return;
+    }
+    
+    // The switch counts once the camera reports the new parameters
+    uint32_t now = millis();
+    BLEAddress bleAddr(m_discoveredCameraAddress);
+    m_linkProfile.update(m_activityMonitor.desiredProfile(now), *bleAddr.getNative(), now);
+}
+
+// Internal method to find the camera service and enable its reports
+bool BLEConnectionManager::subscribeToCamera() {
+    m_profiler.startStage(ConnectionStage::ServiceDiscovery);
+    BLERemoteService* service = m_pClient->getService(BMD_SERVICE_UUID);
+    if (service == nullptr) {
+        m_profiler.endStage(ConnectionStage::ServiceDiscovery, false);
+        return false;
+    }
+    m_profiler.endStage(ConnectionStage::ServiceDiscovery);
+    
+    m_profiler.startStage(ConnectionStage::CharacteristicLookup);
+    BLERemoteCharacteristic* incoming = service->getCharacteristic(BMD_INCOMING_CONTROL_UUID);
+    if (incoming == nullptr || !incoming->canNotify()) {
+        m_profiler.endStage(ConnectionStage::CharacteristicLookup, false);
+        return false;
+    }
+    m_profiler.endStage(ConnectionStage::CharacteristicLookup);
+    
+    m_profiler.startStage(ConnectionStage::NotificationSubscription);
+    incoming->registerForNotify(incomingNotifyHandler);
+    m_profiler.endStage(ConnectionStage::NotificationSubscription);
+    
+    // The camera only reports once pairing is done, so the first report
+    // completes the attempt; loop() fails it if none arrives
+    m_profiler.startStage(ConnectionStage::FirstReport);
+    return true;
+}
+
+// Reports from the camera count as link activity
+void BLEConnectionManager::incomingNotifyHandler(BLERemoteCharacteristic* characteristic, uint8_t* data, size_t length, bool isNotify) {
+    BLEConnectionManager* manager = s_activeManager;
+    if (manager) {
+        manager->m_profiler.finishWithStage(ConnectionStage::FirstReport);
+        manager->noteIncomingActivity();
+    }
+}
+
+// Internal method to apply link preferences once connected
+void BLEConnectionManager::applyLinkPreferences() {
+    m_negotiated.mtu = m_pClient->getMTU();
+    
+    if (m_prefer2MPhy) {
+        requestPhy2M();
+    }
+    
+    notifyLinkParameters();
+}
+
+// Internal method to publish the negotiated values
+void BLEConnectionManager::notifyLinkParameters() {
+    if (m_linkParametersCallback) {
+        m_linkParametersCallback(m_negotiated);
+    }
+}
+
+// GAP events carry the connection parameter and PHY results
+void BLEConnectionManager::gapEventHandler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t* param) {
+    BLEConnectionManager* manager = s_activeManager;
+    if (!manager) {
+        return;
+    }
+    
+    switch (event) {
+        case ESP_GAP_BLE_UPDATE_CONN_PARAMS_EVT:
+            manager->m_linkProfile.onParametersUpdated(
+                param->update_conn_params.status == ESP_BT_STATUS_SUCCESS,
+                param->update_conn_params.conn_int,
+                param->update_conn_params.latency,
+                param->update_conn_params.timeout);
+            if (param->update_conn_params.status == ESP_BT_STATUS_SUCCESS) {
+                manager->m_negotiated.interval = param->update_conn_params.conn_int;
+                manager->m_negotiated.slaveLatency = param->update_conn_params.latency;
+                manager->m_negotiated.supervisionTimeout = param->update_conn_params.timeout;
+                manager->notifyLinkParameters();
+            }
+            break;
+            
+#if defined(CONFIG_BT_BLE_50_FEATURES_SUPPORTED)
+        case ESP_GAP_BLE_PHY_UPDATE_COMPLETE_EVT:
+            if (param->phy_update.status == ESP_BT_STATUS_SUCCESS) {
+                manager->m_negotiated.txPhy = static_cast<BLEPhy>(param->phy_update.tx_phy);
+                manager->m_negotiated.rxPhy = static_cast<BLEPhy>(param->phy_update.rx_phy);
+                manager->notifyLinkParameters();
+            }
+            break;
+#endif
+            
+        default:
+            break;
+    }
+}
+
+// GATT client events carry the MTU exchange result
+void BLEConnectionManager::gattcEventHandler(esp_gattc_cb_event_t event, esp_gatt_if_t gattcIf, esp_ble_gattc_cb_param_t* param) {
+    BLEConnectionManager* manager = s_activeManager;
+    if (!manager) {
+        return;
+    }
+    
+    if (event == ESP_GATTC_CFG_MTU_EVT && param->cfg_mtu.status == ESP_GATT_OK) {
+        manager->m_negotiated.mtu = param->cfg_mtu.mtu;
+        manager->notifyLinkParameters();
+    }
+}
+
+// Internal method to load saved bonding information once
+void BLEConnectionManager::loadSavedAddress() {
+    if (m_savedAddressLoaded) {
+        return;
+    }
+    
+    m_preferences.begin("bmd-camera", false);
+    if (m_preferences.isKey("camera_addr")) {
+        m_savedCameraAddress = m_preferences.getString("camera_addr", "").c_str();
+    }
+    m_preferences.end();
+    
+    m_savedAddressLoaded = true;
+}
+
 // Internal method to save bonding information
 void BLEConnectionManager::saveBondingInformation() {
     if (!m_discoveredCameraAddress.empty()) {
@@ -144,6 +402,7 @@ void BLEConnectionManager::saveBondingInformation() {
         
         // Update saved address
         m_savedCameraAddress = m_discoveredCameraAddress;
+        m_savedAddressLoaded = true;
     }
 }
 
@@ -184,6 +443,7 @@ void BLEConnectionManager::ScanCallback::onResult(BLEAdvertisedDevice advertised
         
         // Store the address
         m_connectionManager->m_discoveredCameraAddress = advertisedDevice.getAddress().toString();
+        m_connectionManager->m_profiler.endStage(ConnectionStage::Scan);
         
         // Stop scanning - we found what we're looking for
         advertisedDevice.getScan()->stop();
@@ -222,6 +482,8 @@ bool BLEConnectionManager::SecurityCallbacks::onSecurityRequest() {
 }
 
 void BLEConnectionManager::SecurityCallbacks::onAuthenticationComplete(esp_ble_auth_cmpl_t auth_cmpl) {
+    m_connectionManager->m_profiler.endStage(ConnectionStage::Authentication, auth_cmpl.success);
+    
     if (auth_cmpl.success) {
         // Save bonding information on successful authentication
         m_connectionManager->saveBondingInformation();
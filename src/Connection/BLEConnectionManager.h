@@ -7,6 +7,10 @@
 #include "../Interfaces/PinInputInterface.h"
 #include "../Interfaces/CallbackInterface.h"
 #include "../Protocol/ProtocolConstants.h"
+#include "ConnectionProfiler.h"
+#include "LinkParameters.h"
+#include "LinkProfileSwitcher.h"
+#include "LinkActivityMonitor.h"
 
 namespace BMDCamera {
     class BLEConnectionManager {
@@ -41,12 +45,57 @@ namespace BMDCamera {
         // Get current camera's BLE address
         std::string getCurrentCameraAddress() const;
 
+        // MTU to request during connection (applied on the next connect,
+        // or immediately if already connected)
+        bool requestMtu(uint16_t mtu);
+
+        // Request new connection interval/latency/timeout from the camera
+        bool requestConnectionParameters(const ConnectionParameters& params);
+
+        // Switch between the configured active and idle profiles
+        bool requestActiveParameters();
+        bool requestIdleParameters();
+        void setActiveParameters(const ConnectionParameters& params) { m_linkProfile.setActiveParameters(params); }
+        void setIdleParameters(const ConnectionParameters& params) { m_linkProfile.setIdleParameters(params); }
+
+        // Prefer the 2M PHY; returns false if the controller lacks BLE 5 support
+        bool requestPhy2M();
+
+        // Automatic switching between the active and idle profiles, driven
+        // by control traffic. Senders report their queue depth with each
+        // send and again once it drains; camera reports are noted by the
+        // manager itself. loop() must be called regularly to drop to idle.
+        void setAutoLinkProfile(bool enabled, uint32_t idleTimeoutMs = 2000);
+        void noteOutgoingActivity(size_t queueDepth = 0);
+        void setQueueDepth(size_t queueDepth);
+        void noteIncomingActivity();
+        void setPendingRequests(size_t count);
+        // The profile the camera has confirmed, not merely the one requested
+        LinkProfile getLinkProfile() const { return m_linkProfile.getProfile(); }
+        void loop();
+
+        // Values in effect on the link, updated from stack events
+        const NegotiatedLinkParameters& getNegotiatedParameters() const { return m_negotiated; }
+        void setLinkParametersCallback(LinkParametersCallback cb) {
+            m_linkParametersCallback = std::move(cb);
+        }
+
+        // Connection setup profiling. Every stage is timed here; the attempt
+        // finishes successfully on the camera's first report, or fails at
+        // FirstReport if loop() sees none within BMD_FIRST_REPORT_TIMEOUT_MS.
+        ConnectionProfiler& getProfiler() { return m_profiler; }
+        ConnectionReport getConnectionReport() const { return m_profiler.getLastReport(); }
+        void setConnectionReportCallback(ConnectionReportCallback cb) {
+            m_profiler.setReportCallback(std::move(cb));
+        }
+
     private:
         // BLE Client for connection
         BLEClient* m_pClient = nullptr;
 
-        // Saved camera address
+        // Saved camera address (loaded lazily from preferences)
         std::string m_savedCameraAddress;
+        bool m_savedAddressLoaded = false;
 
         // Discovered camera address during scan
         std::string m_discoveredCameraAddress;
@@ -60,6 +109,29 @@ namespace BMDCamera {
         // PIN input method
         PinInputMethodPtr m_pinInputMethod;
 
+        // Connection setup stage timings
+        ConnectionProfiler m_profiler;
+
+        // Link negotiation state
+        uint16_t m_preferredMtu = BLE_DEFAULT_MTU;
+        bool m_prefer2MPhy = false;
+        NegotiatedLinkParameters m_negotiated;
+        LinkParametersCallback m_linkParametersCallback;
+
+        // Activity-driven profile switching
+        LinkActivityMonitor m_activityMonitor;
+        bool m_autoLinkProfile = false;
+        LinkProfileSwitcher m_linkProfile;
+        void updateLinkProfile();
+
+        // The stack's custom event hooks are plain function pointers, so
+        // events are routed to the manager that most recently connected
+        static BLEConnectionManager* s_activeManager;
+        static void gapEventHandler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t* param);
+        static void gattcEventHandler(esp_gattc_cb_event_t event, esp_gatt_if_t gattcIf, esp_ble_gattc_cb_param_t* param);
+        void applyLinkPreferences();
+        void notifyLinkParameters();
+
         // Internal scan callback
         class ScanCallback : public BLEAdvertisedDeviceCallbacks {
         public:
@@ -86,9 +158,14 @@ namespace BMDCamera {
         };
 
         // Internal methods
+        void loadSavedAddress();
         void saveBondingInformation();
         void clearBondingInformation();
         void setupBLESecurity();
+        
+        // Service discovery and report subscription after link-up
+        bool subscribeToCamera();
+        static void incomingNotifyHandler(BLERemoteCharacteristic* characteristic, uint8_t* data, size_t length, bool isNotify);
 
         // Scan callback instance
         std::unique_ptr<ScanCallback> m_scanCallback;
@@ -0,0 +1,235 @@
+#include "ConnectionProfiler.h"
+
+namespace BMDCamera {
+
+void ConnectionProfiler::beginAttempt() {
+    portENTER_CRITICAL(&m_lock);
+    m_current = ConnectionReport();
+    m_current.attemptStartUs = micros();
+    m_active = true;
+    portEXIT_CRITICAL(&m_lock);
+}
+
+void ConnectionProfiler::ensureAttempt() {
+    portENTER_CRITICAL(&m_lock);
+    if (!m_active) {
+        m_current = ConnectionReport();
+        m_current.attemptStartUs = micros();
+        m_active = true;
+    }
+    portEXIT_CRITICAL(&m_lock);
+}
+
+void ConnectionProfiler::startStage(ConnectionStage stage) {
+    if (stage == ConnectionStage::Count) {
+        return;
+    }
+
+    portENTER_CRITICAL(&m_lock);
+    if (m_active) {
+        StageTiming& timing = m_current.stages[static_cast<size_t>(stage)];
+        timing.startUs = elapsedUs();
+        timing.started = true;
+        timing.completed = false;
+    }
+    portEXIT_CRITICAL(&m_lock);
+}
+
+void ConnectionProfiler::endStage(ConnectionStage stage, bool success) {
+    if (stage == ConnectionStage::Count) {
+        return;
+    }
+
+    ConnectionReport report;
+    CallbackPtr callback;
+    bool finished = false;
+
+    portENTER_CRITICAL(&m_lock);
+    if (m_active) {
+        StageTiming& timing = m_current.stages[static_cast<size_t>(stage)];
+        uint32_t now = elapsedUs();
+
+        // A stage that was never explicitly started is treated as instantaneous
+        if (!timing.started) {
+            timing.startUs = now;
+            timing.started = true;
+        }
+
+        timing.endUs = now;
+        timing.completed = true;
+        timing.succeeded = success;
+
+        if (!success) {
+            m_current.failedStage = stage;
+            finished = close(false, report, callback);
+        }
+    }
+    portEXIT_CRITICAL(&m_lock);
+
+    if (finished && callback) {
+        (*callback)(report);
+    }
+}
+
+void ConnectionProfiler::finish(bool success) {
+    ConnectionReport report;
+    CallbackPtr callback;
+
+    portENTER_CRITICAL(&m_lock);
+    bool finished = close(success, report, callback);
+    portEXIT_CRITICAL(&m_lock);
+
+    if (finished && callback) {
+        (*callback)(report);
+    }
+}
+
+void ConnectionProfiler::finishWithStage(ConnectionStage stage) {
+    if (stage == ConnectionStage::Count) {
+        return;
+    }
+
+    ConnectionReport report;
+    CallbackPtr callback;
+    bool finished = false;
+
+    portENTER_CRITICAL(&m_lock);
+    StageTiming& timing = m_current.stages[static_cast<size_t>(stage)];
+    if (m_active && timing.started && !timing.completed) {
+        timing.endUs = elapsedUs();
+        timing.completed = true;
+        timing.succeeded = true;
+        finished = close(true, report, callback);
+    }
+    portEXIT_CRITICAL(&m_lock);
+
+    if (finished && callback) {
+        (*callback)(report);
+    }
+}
+
+void ConnectionProfiler::poll() {
+    ConnectionReport report;
+    CallbackPtr callback;
+    bool finished = false;
+
+    portENTER_CRITICAL(&m_lock);
+    StageTiming& timing = m_current.stages[static_cast<size_t>(ConnectionStage::FirstReport)];
+    uint32_t now = elapsedUs();
+    if (m_active && timing.started && !timing.completed && now - timing.startUs >= m_firstReportTimeoutUs) {
+        timing.endUs = now;
+        timing.completed = true;
+        timing.succeeded = false;
+        m_current.failedStage = ConnectionStage::FirstReport;
+        finished = close(false, report, callback);
+    }
+    portEXIT_CRITICAL(&m_lock);
+
+    if (finished && callback) {
+        (*callback)(report);
+    }
+}
+
+void ConnectionProfiler::setFirstReportTimeout(uint32_t timeoutMs) {
+    portENTER_CRITICAL(&m_lock);
+    m_firstReportTimeoutUs = timeoutMs * 1000u;
+    portEXIT_CRITICAL(&m_lock);
+}
+
+bool ConnectionProfiler::close(bool success, ConnectionReport& report, CallbackPtr& callback) {
+    if (!m_active) {
+        return false;
+    }
+
+    m_current.totalUs = elapsedUs();
+    m_current.success = success;
+    m_active = false;
+
+    m_lastReport = m_current;
+    report = m_current;
+    callback = m_reportCallback;
+    return true;
+}
+
+bool ConnectionProfiler::isActive() const {
+    portENTER_CRITICAL(&m_lock);
+    bool active = m_active;
+    portEXIT_CRITICAL(&m_lock);
+    return active;
+}
+
+bool ConnectionProfiler::hasCompleted(ConnectionStage stage) const {
+    if (stage == ConnectionStage::Count) {
+        return false;
+    }
+
+    portENTER_CRITICAL(&m_lock);
+    bool completed = m_active && m_current.stage(stage).completed;
+    portEXIT_CRITICAL(&m_lock);
+    return completed;
+}
+
+ConnectionReport ConnectionProfiler::getLastReport() const {
+    portENTER_CRITICAL(&m_lock);
+    ConnectionReport report = m_lastReport;
+    portEXIT_CRITICAL(&m_lock);
+    return report;
+}
+
+void ConnectionProfiler::setReportCallback(ConnectionReportCallback cb) {
+    // Allocate outside the lock; a report being published on another task
+    // keeps the old callback alive until it returns
+    CallbackPtr replacement;
+    if (cb) {
+        replacement = std::make_shared<const ConnectionReportCallback>(std::move(cb));
+    }
+
+    portENTER_CRITICAL(&m_lock);
+    m_reportCallback.swap(replacement);
+    portEXIT_CRITICAL(&m_lock);
+}
+
+const char* ConnectionProfiler::getStageName(ConnectionStage stage) {
+    switch (stage) {
+        case ConnectionStage::Scan: return "Scan";
+        case ConnectionStage::LinkUp: return "Link Up";
+        case ConnectionStage::ServiceDiscovery: return "Service Discovery";
+        case ConnectionStage::CharacteristicLookup: return "Characteristic Lookup";
+        case ConnectionStage::Authentication: return "Authentication";
+        case ConnectionStage::NotificationSubscription: return "Notification Subscription";
+        case ConnectionStage::FirstReport: return "First Report";
+        default: return "Unknown";
+    }
+}
+
+void ConnectionProfiler::printReport(const ConnectionReport& report, Print& out) {
+    out.printf("Connection %s in %lu us\n",
+        report.success ? "succeeded" : "failed",
+        static_cast<unsigned long>(report.totalUs));
+
+    for (size_t i = 0; i < CONNECTION_STAGE_COUNT; i++) {
+        const StageTiming& timing = report.stages[i];
+        if (!timing.started) {
+            continue;
+        }
+
+        ConnectionStage stage = static_cast<ConnectionStage>(i);
+        if (timing.completed) {
+            out.printf("  %-26s +%8lu us  %8lu us%s\n",
+                getStageName(stage),
+                static_cast<unsigned long>(timing.startUs),
+                static_cast<unsigned long>(timing.durationUs()),
+                timing.succeeded ? "" : "  FAILED");
+        } else {
+            out.printf("  %-26s +%8lu us  (incomplete)\n",
+                getStageName(stage),
+                static_cast<unsigned long>(timing.startUs));
+        }
+    }
+}
+
+uint32_t ConnectionProfiler::elapsedUs() const {
+    return micros() - m_current.attemptStartUs;
+}
+
+} // namespace BMDCamera
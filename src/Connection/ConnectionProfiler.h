@@ -0,0 +1,123 @@
+#ifndef BMD_CONNECTION_PROFILER_H
+#define BMD_CONNECTION_PROFILER_H
+
+#include <Arduino.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+// How long the first report may take after subscribing before the attempt
+// is recorded as failed at that stage
+#ifndef BMD_FIRST_REPORT_TIMEOUT_MS
+#define BMD_FIRST_REPORT_TIMEOUT_MS 5000
+#endif
+
+namespace BMDCamera {
+    // Stages of bringing a camera link up, in the order they normally occur.
+    // Authentication runs asynchronously and may overlap discovery.
+    enum class ConnectionStage : uint8_t {
+        Scan = 0,
+        LinkUp,
+        ServiceDiscovery,
+        CharacteristicLookup,
+        Authentication,
+        NotificationSubscription,
+        FirstReport,
+        Count
+    };
+
+    constexpr size_t CONNECTION_STAGE_COUNT = static_cast<size_t>(ConnectionStage::Count);
+
+    // Timing of a single stage, relative to the start of the attempt
+    struct StageTiming {
+        uint32_t startUs = 0;
+        uint32_t endUs = 0;
+        bool started = false;
+        bool completed = false;
+        bool succeeded = false;
+
+        uint32_t durationUs() const {
+            return completed ? endUs - startUs : 0;
+        }
+    };
+
+    // Structured report for one connection attempt
+    struct ConnectionReport {
+        StageTiming stages[CONNECTION_STAGE_COUNT];
+        uint32_t attemptStartUs = 0;   // micros() when the attempt began
+        uint32_t totalUs = 0;          // Time from attempt start to finish
+        bool success = false;
+        ConnectionStage failedStage = ConnectionStage::Count;  // Count if nothing failed
+
+        const StageTiming& stage(ConnectionStage s) const {
+            return stages[static_cast<size_t>(s)];
+        }
+    };
+
+    // Callback fired once per attempt, when it succeeds or fails
+    using ConnectionReportCallback = std::function<void(const ConnectionReport& report)>;
+
+    // Stages are marked from the sketch's task and from BLE stack callbacks,
+    // so the attempt is kept under a lock. The report callback runs
+    // unlocked, once per attempt, on whichever task finished it.
+    class ConnectionProfiler {
+    public:
+        // Start a new attempt, discarding any unfinished one
+        void beginAttempt();
+
+        // Begin an attempt only if none is in progress
+        void ensureAttempt();
+
+        // Mark stage boundaries; a failed stage finishes the attempt
+        void startStage(ConnectionStage stage);
+        void endStage(ConnectionStage stage, bool success = true);
+
+        // Finish the attempt and publish the report; later calls for the
+        // same attempt do nothing
+        void finish(bool success);
+
+        // End a stage in progress and finish the attempt successfully, in
+        // one step. For the last stage, which several tasks may see end.
+        void finishWithStage(ConnectionStage stage);
+
+        // Fail the attempt at FirstReport if no report arrived in time.
+        // Call regularly, e.g. from loop().
+        void poll();
+        void setFirstReportTimeout(uint32_t timeoutMs);
+
+        // True between beginAttempt() and finish()
+        bool isActive() const;
+
+        // True if the stage has ended in the current attempt
+        bool hasCompleted(ConnectionStage stage) const;
+
+        // Most recently published report
+        ConnectionReport getLastReport() const;
+
+        void setReportCallback(ConnectionReportCallback cb);
+
+        // Human-readable stage name
+        static const char* getStageName(ConnectionStage stage);
+
+        // Print a report as one line per stage
+        static void printReport(const ConnectionReport& report, Print& out);
+
+    private:
+        using CallbackPtr = std::shared_ptr<const ConnectionReportCallback>;
+
+        uint32_t elapsedUs() const;
+
+        // Close the attempt under m_lock. True if it was open, with the
+        // report and callback to publish once unlocked.
+        bool close(bool success, ConnectionReport& report, CallbackPtr& callback);
+
+        ConnectionReport m_current;
+        ConnectionReport m_lastReport;
+        bool m_active = false;
+        uint32_t m_firstReportTimeoutUs = BMD_FIRST_REPORT_TIMEOUT_MS * 1000u;
+        CallbackPtr m_reportCallback; // Swapped under m_lock
+        mutable portMUX_TYPE m_lock = portMUX_INITIALIZER_UNLOCKED;
+    };
+}
+
+#endif // BMD_CONNECTION_PROFILER_H
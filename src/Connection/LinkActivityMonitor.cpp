@@ -0,0 +1,33 @@
+#include "LinkActivityMonitor.h"
+
+namespace BMDCamera {
+
+LinkActivityMonitor::LinkActivityMonitor(uint32_t idleTimeoutMs)
+    : m_idleTimeoutMs(idleTimeoutMs) {
+}
+
+void LinkActivityMonitor::noteOutgoing(uint32_t nowMs, size_t queueDepth) {
+    m_lastActivityMs = nowMs;
+    m_seenActivity = true;
+    m_queueDepth = queueDepth;
+}
+
+void LinkActivityMonitor::noteIncoming(uint32_t nowMs) {
+    m_lastActivityMs = nowMs;
+    m_seenActivity = true;
+}
+
+LinkProfile LinkActivityMonitor::desiredProfile(uint32_t nowMs) const {
+    // Queued work always wants the fast profile
+    if (m_queueDepth > 0 || m_pendingRequests > 0) {
+        return LinkProfile::Active;
+    }
+
+    if (m_seenActivity && (nowMs - m_lastActivityMs) < m_idleTimeoutMs) {
+        return LinkProfile::Active;
+    }
+
+    return LinkProfile::Idle;
+}
+
+} // namespace BMDCamera
@@ -0,0 +1,50 @@
+#ifndef BMD_LINK_ACTIVITY_MONITOR_H
+#define BMD_LINK_ACTIVITY_MONITOR_H
+
+#include <cstdint>
+#include <cstddef>
+
+namespace BMDCamera {
+    // Which connection parameter profile the link should be using
+    enum class LinkProfile : uint8_t {
+        Unknown = 0,
+        Active,   // Short interval for low-latency control
+        Idle      // Long interval with slave latency to save power
+    };
+
+    // Decides between the active and idle profiles from control traffic.
+    // The link is kept active while commands are queued or requests are
+    // outstanding, and drops to idle after a quiet period.
+    class LinkActivityMonitor {
+    public:
+        explicit LinkActivityMonitor(uint32_t idleTimeoutMs = 2000);
+
+        // Record outgoing traffic and the depth of the sender's queue
+        void noteOutgoing(uint32_t nowMs, size_t queueDepth);
+
+        // Update the queue depth without counting it as traffic, e.g. once
+        // the sender's queue has drained
+        void setQueueDepth(size_t queueDepth) { m_queueDepth = queueDepth; }
+
+        // Record traffic received from the camera
+        void noteIncoming(uint32_t nowMs);
+
+        // Outstanding requests awaiting a report keep the link active
+        void setPendingRequests(size_t count) { m_pendingRequests = count; }
+
+        // Profile the link should be in at this time
+        LinkProfile desiredProfile(uint32_t nowMs) const;
+
+        void setIdleTimeout(uint32_t idleTimeoutMs) { m_idleTimeoutMs = idleTimeoutMs; }
+        uint32_t getIdleTimeout() const { return m_idleTimeoutMs; }
+
+    private:
+        uint32_t m_idleTimeoutMs;
+        uint32_t m_lastActivityMs = 0;
+        bool m_seenActivity = false;
+        size_t m_queueDepth = 0;
+        size_t m_pendingRequests = 0;
+    };
+}
+
+#endif // BMD_LINK_ACTIVITY_MONITOR_H
@@ -0,0 +1,86 @@
+#ifndef BMD_LINK_PARAMETERS_H
+#define BMD_LINK_PARAMETERS_H
+
+#include <cstdint>
+#include <functional>
+
+namespace BMDCamera {
+    // Default ATT MTU before any exchange
+    constexpr uint16_t BLE_DEFAULT_MTU = 23;
+
+    // Largest MTU the ESP32 stack accepts
+    constexpr uint16_t BLE_MAX_MTU = 517;
+
+    // Requested connection timing. Intervals are in 1.25 ms units and the
+    // supervision timeout in 10 ms units, as used on the air.
+    struct ConnectionParameters {
+        uint16_t minInterval;
+        uint16_t maxInterval;
+        uint16_t slaveLatency;
+        uint16_t supervisionTimeout;
+
+        // Build from milliseconds
+        static constexpr ConnectionParameters fromMillis(
+            float minIntervalMs,
+            float maxIntervalMs,
+            uint16_t slaveLatency,
+            uint16_t supervisionTimeoutMs
+        ) {
+            return ConnectionParameters{
+                static_cast<uint16_t>(minIntervalMs / 1.25f),
+                static_cast<uint16_t>(maxIntervalMs / 1.25f),
+                slaveLatency,
+                static_cast<uint16_t>(supervisionTimeoutMs / 10)
+            };
+        }
+
+        // Within the ranges the specification allows
+        constexpr bool isValid() const {
+            return minInterval >= 6 && maxInterval <= 3200 && minInterval <= maxInterval &&
+                   slaveLatency <= 499 && supervisionTimeout >= 10 && supervisionTimeout <= 3200;
+        }
+
+        // True if values the link reports are the ones asked for here
+        constexpr bool accepts(uint16_t interval, uint16_t latency, uint16_t timeout) const {
+            return interval >= minInterval && interval <= maxInterval &&
+                   latency == slaveLatency && timeout == supervisionTimeout;
+        }
+    };
+
+    // Short interval for responsive control (7.5-15 ms, no latency)
+    constexpr ConnectionParameters ACTIVE_CONNECTION_PARAMETERS =
+        ConnectionParameters::fromMillis(7.5f, 15.0f, 0, 2000);
+
+    // Long interval with slave latency for when the link is parked
+    constexpr ConnectionParameters IDLE_CONNECTION_PARAMETERS =
+        ConnectionParameters::fromMillis(100.0f, 200.0f, 4, 6000);
+
+    // PHY identifiers as reported by the controller
+    enum class BLEPhy : uint8_t {
+        Unknown = 0,
+        LE1M = 1,
+        LE2M = 2,
+        LECoded = 3
+    };
+
+    // Values actually in effect on the link, as reported by the stack
+    struct NegotiatedLinkParameters {
+        uint16_t mtu = BLE_DEFAULT_MTU;
+        uint16_t interval = 0;            // 1.25 ms units, 0 if not yet reported
+        uint16_t slaveLatency = 0;
+        uint16_t supervisionTimeout = 0;  // 10 ms units
+        BLEPhy txPhy = BLEPhy::LE1M;
+        BLEPhy rxPhy = BLEPhy::LE1M;
+
+        float intervalMs() const { return interval * 1.25f; }
+        uint32_t supervisionTimeoutMs() const { return supervisionTimeout * 10u; }
+
+        // Largest attribute value that fits in one write or notification
+        uint16_t maxPayloadSize() const { return mtu > 3 ? mtu - 3 : 0; }
+    };
+
+    // Callback fired whenever the stack reports a change to the link
+    using LinkParametersCallback = std::function<void(const NegotiatedLinkParameters& params)>;
+}
+
+#endif // BMD_LINK_PARAMETERS_H
@@ -0,0 +1,94 @@
+#include "LinkProfileSwitcher.h"
+#include <BLEDevice.h>
+#include <cstring>
+
+namespace BMDCamera {
+
+void LinkProfileSwitcher::update(LinkProfile desired, const uint8_t* address, uint32_t nowMs) {
+    if (address == nullptr || desired == LinkProfile::Unknown) {
+        return;
+    }
+
+    // Going to a new profile is never held back. A parameter update takes
+    // several connection events, so a request that is refused or left
+    // unanswered is repeated at most every RETRY_MS rather than on every call.
+    portENTER_CRITICAL(&m_lock);
+    bool wanted = desired != m_profile &&
+                  (desired != m_requested || nowMs - m_requestMs >= RETRY_MS);
+    ConnectionParameters params = desired == LinkProfile::Active ? m_active : m_idle;
+    if (wanted) {
+        m_requested = desired;
+        m_requestMs = nowMs;
+    }
+    portEXIT_CRITICAL(&m_lock);
+
+    if (wanted) {
+        request(address, params);
+    }
+}
+
+void LinkProfileSwitcher::onParametersUpdated(bool success, uint16_t interval, uint16_t latency, uint16_t timeout) {
+    // A refusal changes nothing; update() repeats the request
+    if (!success) {
+        return;
+    }
+
+    portENTER_CRITICAL(&m_lock);
+    if (m_active.accepts(interval, latency, timeout)) {
+        m_profile = LinkProfile::Active;
+    } else if (m_idle.accepts(interval, latency, timeout)) {
+        m_profile = LinkProfile::Idle;
+    } else {
+        m_profile = LinkProfile::Unknown;  // Neither: the camera chose its own
+    }
+    portEXIT_CRITICAL(&m_lock);
+}
+
+void LinkProfileSwitcher::reset() {
+    portENTER_CRITICAL(&m_lock);
+    m_profile = LinkProfile::Unknown;
+    m_requested = LinkProfile::Unknown;
+    portEXIT_CRITICAL(&m_lock);
+}
+
+LinkProfile LinkProfileSwitcher::getProfile() const {
+    portENTER_CRITICAL(&m_lock);
+    LinkProfile profile = m_profile;
+    portEXIT_CRITICAL(&m_lock);
+    return profile;
+}
+
+void LinkProfileSwitcher::setActiveParameters(const ConnectionParameters& params) {
+    portENTER_CRITICAL(&m_lock);
+    m_active = params;
+    portEXIT_CRITICAL(&m_lock);
+}
+
+void LinkProfileSwitcher::setIdleParameters(const ConnectionParameters& params) {
+    portENTER_CRITICAL(&m_lock);
+    m_idle = params;
+    portEXIT_CRITICAL(&m_lock);
+}
+
+ConnectionParameters LinkProfileSwitcher::getParameters(LinkProfile profile) const {
+    portENTER_CRITICAL(&m_lock);
+    ConnectionParameters params = profile == LinkProfile::Idle ? m_idle : m_active;
+    portEXIT_CRITICAL(&m_lock);
+    return params;
+}
+
+bool LinkProfileSwitcher::request(const uint8_t* address, const ConnectionParameters& params) {
+    if (address == nullptr || !params.isValid()) {
+        return false;
+    }
+
+    esp_ble_conn_update_params_t update = {};
+    memcpy(update.bda, address, sizeof(esp_bd_addr_t));
+    update.min_int = params.minInterval;
+    update.max_int = params.maxInterval;
+    update.latency = params.slaveLatency;
+    update.timeout = params.supervisionTimeout;
+    return esp_ble_gap_update_conn_params(&update) == ESP_OK;
+}
+
+} // namespace BMDCamera
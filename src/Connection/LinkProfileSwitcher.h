@@ -0,0 +1,52 @@
+#ifndef BMD_LINK_PROFILE_SWITCHER_H
+#define BMD_LINK_PROFILE_SWITCHER_H
+
+#include <Arduino.h>
+#include <cstdint>
+#include "LinkActivityMonitor.h"
+#include "LinkParameters.h"
+
+namespace BMDCamera {
+    // Moves the link between the active and idle parameter profiles. A
+    // profile only counts as switched once the stack reports values
+    // within it (ESP_GAP_BLE_UPDATE_CONN_PARAMS_EVT); a request the camera
+    // turns down or answers with other values is retried later.
+    //
+    // update() runs on the sketch's or a sending task, the event on the BLE
+    // task, so the state is kept under a lock.
+    class LinkProfileSwitcher {
+    public:
+        // Ask for the desired profile if the link isn't in it and it isn't
+        // already requested. address is the peer's 6-byte address.
+        void update(LinkProfile desired, const uint8_t* address, uint32_t nowMs);
+
+        // Values reported by the stack for a parameter update
+        void onParametersUpdated(bool success, uint16_t interval, uint16_t latency, uint16_t timeout);
+
+        // Forget the profile, e.g. on disconnect
+        void reset();
+
+        LinkProfile getProfile() const;
+
+        void setActiveParameters(const ConnectionParameters& params);
+        void setIdleParameters(const ConnectionParameters& params);
+        ConnectionParameters getParameters(LinkProfile profile) const;
+
+        // Validated request to the stack; false if out of range or refused
+        static bool request(const uint8_t* address, const ConnectionParameters& params);
+
+        // A request refused, unanswered or answered with other values is
+        // repeated after this
+        static constexpr uint32_t RETRY_MS = 250;
+
+    private:
+        ConnectionParameters m_active = ACTIVE_CONNECTION_PARAMETERS;
+        ConnectionParameters m_idle = IDLE_CONNECTION_PARAMETERS;
+        LinkProfile m_profile = LinkProfile::Unknown;
+        LinkProfile m_requested = LinkProfile::Unknown;  // Last asked for, at m_requestMs
+        uint32_t m_requestMs = 0;
+        mutable portMUX_TYPE m_lock = portMUX_INITIALIZER_UNLOCKED;
+    };
+}
+
+#endif // BMD_LINK_PROFILE_SWITCHER_H
@@ -0,0 +1,197 @@
+#ifndef BMD_APERTURE_TABLE_H
+#define BMD_APERTURE_TABLE_H
+
+// The constexpr tables below need C++17
+#if __cplusplus < 201703L
+#error "BMDBLEController requires C++17 (arduino-esp32 3.x, or -std=gnu++17)"
+#endif
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+namespace BMDCamera {
+
+// Fixed-point aperture conversions. The f-stop curve
+//   fStop = minFStop * (maxFStop / minFStop) ^ normalized
+// is tabulated at compile time and linearly interpolated with integer
+// arithmetic, so setting or reading the iris never calls pow()/log().
+namespace ApertureTable {
+
+    constexpr double MIN_FSTOP = 1.8;   // Typical minimum f-stop
+    constexpr double MAX_FSTOP = 22.0;  // Typical maximum f-stop
+
+    // Normalized values are carried as fixed16 (5.11), so 1.0 == 2048
+    constexpr uint32_t FIXED16_ONE = 2048;
+
+    // F-stops are stored as unsigned Q10 (f-stop * 1024)
+    constexpr uint32_t FSTOP_SCALE = 1024;
+
+    // 64 segments of 32 fixed16 steps each
+    constexpr uint32_t SEGMENT_SHIFT = 5;
+    constexpr uint32_t SEGMENT_STEPS = 1u << SEGMENT_SHIFT;
+    constexpr size_t TABLE_SIZE = FIXED16_ONE / SEGMENT_STEPS + 1;
+
+    namespace detail {
+        // exp() usable in constant expressions: halve the argument into the
+        // fast-converging range, sum the series, then square back up
+        constexpr double exp(double x) {
+            int halvings = 0;
+            while (x > 0.5 || x < -0.5) {
+                x *= 0.5;
+                halvings++;
+            }
+            double term = 1.0;
+            double sum = 1.0;
+            for (int n = 1; n < 24; n++) {
+                term *= x / n;
+                sum += term;
+            }
+            while (halvings-- > 0) {
+                sum *= sum;
+            }
+            return sum;
+        }
+
+        // log() usable in constant expressions, via 2 * atanh((y - 1) / (y + 1))
+        constexpr double log(double x) {
+            constexpr double LN2 = 0.69314718055994530942;
+            int exponent = 0;
+            while (x > 2.0) {
+                x *= 0.5;
+                exponent++;
+            }
+            while (x < 0.5) {
+                x *= 2.0;
+                exponent--;
+            }
+            double z = (x - 1.0) / (x + 1.0);
+            double z2 = z * z;
+            double term = z;
+            double sum = 0.0;
+            for (int n = 1; n < 60; n += 2) {
+                sum += term / n;
+                term *= z2;
+            }
+            return 2.0 * sum + exponent * LN2;
+        }
+
+        constexpr double LOG_RANGE = log(MAX_FSTOP / MIN_FSTOP);
+
+        // Reference curve, evaluated in double precision
+        constexpr double referenceFStop(double normalized) {
+            return MIN_FSTOP * exp(normalized * LOG_RANGE);
+        }
+
+        constexpr std::array<uint16_t, TABLE_SIZE> buildTable() {
+            std::array<uint16_t, TABLE_SIZE> table{};
+            for (size_t i = 0; i < TABLE_SIZE; i++) {
+                double normalized = static_cast<double>(i) / (TABLE_SIZE - 1);
+                table[i] = static_cast<uint16_t>(referenceFStop(normalized) * FSTOP_SCALE + 0.5);
+            }
+            return table;
+        }
+    }
+
+    // F-stop (Q10) at each segment boundary
+    constexpr std::array<uint16_t, TABLE_SIZE> FSTOP_TABLE = detail::buildTable();
+
+    // Normalized fixed16 (0-2048) to f-stop in Q10
+    constexpr uint32_t fixed16ToFStopQ10(uint32_t fixed16) {
+        if (fixed16 >= FIXED16_ONE) {
+            return FSTOP_TABLE[TABLE_SIZE - 1];
+        }
+        uint32_t index = fixed16 >> SEGMENT_SHIFT;
+        uint32_t fraction = fixed16 & (SEGMENT_STEPS - 1);
+        uint32_t low = FSTOP_TABLE[index];
+        uint32_t high = FSTOP_TABLE[index + 1];
+        return low + (((high - low) * fraction + SEGMENT_STEPS / 2) >> SEGMENT_SHIFT);
+    }
+
+    // F-stop in Q10 to normalized fixed16 (0-2048), clamped to the lens range
+    constexpr uint32_t fStopQ10ToFixed16(uint32_t fStopQ10) {
+        if (fStopQ10 <= FSTOP_TABLE[0]) {
+            return 0;
+        }
+        if (fStopQ10 >= FSTOP_TABLE[TABLE_SIZE - 1]) {
+            return FIXED16_ONE;
+        }
+
+        // Binary search for the segment; the table is strictly increasing
+        size_t low = 0;
+        size_t high = TABLE_SIZE - 1;
+        while (high - low > 1) {
+            size_t mid = (low + high) / 2;
+            if (FSTOP_TABLE[mid] <= fStopQ10) {
+                low = mid;
+            } else {
+                high = mid;
+            }
+        }
+
+        uint32_t span = FSTOP_TABLE[high] - FSTOP_TABLE[low];
+        uint32_t offset = fStopQ10 - FSTOP_TABLE[low];
+        return (static_cast<uint32_t>(low) << SEGMENT_SHIFT) +
+               ((offset << SEGMENT_SHIFT) + span / 2) / span;
+    }
+
+    // Float convenience wrappers for LensControl
+    inline float normalizedToFStop(float normalized) {
+        float clamped = normalized < 0.0f ? 0.0f : (normalized > 1.0f ? 1.0f : normalized);
+        uint32_t fixed16 = static_cast<uint32_t>(clamped * FIXED16_ONE + 0.5f);
+        return static_cast<float>(fixed16ToFStopQ10(fixed16)) * (1.0f / FSTOP_SCALE);
+    }
+
+    inline uint16_t fStopToFixed16(float fStop) {
+        if (!(fStop > 0.0f)) {
+            return 0;
+        }
+        return static_cast<uint16_t>(fStopQ10ToFixed16(static_cast<uint32_t>(fStop * FSTOP_SCALE + 0.5f)));
+    }
+
+    inline float fStopToNormalized(float fStop) {
+        return static_cast<float>(fStopToFixed16(fStop)) * (1.0f / FIXED16_ONE);
+    }
+
+    namespace detail {
+        constexpr double abs(double x) { return x < 0.0 ? -x : x; }
+
+        // Largest |table - reference| f-stop error over every fixed16 input
+        constexpr double maxForwardError() {
+            double worst = 0.0;
+            for (uint32_t fixed16 = 0; fixed16 <= FIXED16_ONE; fixed16++) {
+                double expected = referenceFStop(static_cast<double>(fixed16) / FIXED16_ONE);
+                double actual = static_cast<double>(fixed16ToFStopQ10(fixed16)) / FSTOP_SCALE;
+                double error = abs(actual - expected);
+                worst = error > worst ? error : worst;
+            }
+            return worst;
+        }
+
+        // Largest round-trip error in fixed16 steps (fixed16 -> f-stop -> fixed16)
+        constexpr uint32_t maxRoundTripError() {
+            uint32_t worst = 0;
+            for (uint32_t fixed16 = 0; fixed16 <= FIXED16_ONE; fixed16++) {
+                uint32_t back = fStopQ10ToFixed16(fixed16ToFStopQ10(fixed16));
+                uint32_t error = back > fixed16 ? back - fixed16 : fixed16 - back;
+                worst = error > worst ? error : worst;
+            }
+            return worst;
+        }
+    }
+
+    // Bounded-error checks against the double-precision reference curve
+    static_assert(FSTOP_TABLE[0] == static_cast<uint16_t>(MIN_FSTOP * FSTOP_SCALE + 0.5),
+                  "Aperture table must start at the minimum f-stop");
+    static_assert(FSTOP_TABLE[TABLE_SIZE - 1] == static_cast<uint16_t>(MAX_FSTOP * FSTOP_SCALE + 0.5),
+                  "Aperture table must end at the maximum f-stop");
+    static_assert(detail::maxForwardError() < 0.005,
+                  "Aperture table interpolation exceeds 0.005 f-stop error");
+    static_assert(detail::maxRoundTripError() <= 1,
+                  "Aperture table round trip exceeds 1 fixed16 step");
+
+} // namespace ApertureTable
+
+} // namespace BMDCamera
+
+#endif // BMD_APERTURE_TABLE_H
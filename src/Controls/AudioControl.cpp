@@ -2,6 +2,7 @@
 #include "AudioControl.h"
 #include "../BMDBLEController.h"
 #include "../Protocol/ProtocolUtils.h"
+#include "../Protocol/Parameters.h"
 #include <cmath>
 
 namespace BMDCamera {
@@ -69,7 +70,7 @@ bool AudioControl::setChannelInput(uint8_t channelIndex, InputType inputType) {
     return m_controller->sendCommand(
         Category::Audio,
         channelIndex,
-        DataType::UTF8String,
+        DataType::String,
         OperationType::Assign,
         payload
     );
@@ -121,31 +122,31 @@ bool AudioControl::getInputDescription(uint8_t channelIndex, InputDescription& d
     // Parameter code is channel_index + 1 to get description
     auto param = m_controller->getParameter(Category::Audio, channelIndex + 1);
     
-    if (!param || param->data.size() < 12) {
+    if (!param || param->rawData.size() < 12) {
         return false;
     }
     
     // Parse binary data for description
     // First 4 bytes: gain range min/max (2 float16 values)
-    uint16_t minRaw = param->data[0] | (param->data[1] << 8);
-    uint16_t maxRaw = param->data[2] | (param->data[3] << 8);
+    uint16_t minRaw = param->rawData[0] | (param->rawData[1] << 8);
+    uint16_t maxRaw = param->rawData[2] | (param->rawData[3] << 8);
     
     description.gainRange.min = static_cast<float>(minRaw) / 256.0f; // Convert to dB
     description.gainRange.max = static_cast<float>(maxRaw) / 256.0f;
     
     // Capabilities flags
-    uint8_t capFlags = param->data[4];
+    uint8_t capFlags = param->rawData[4];
     description.capabilities.supportsPhantomPower = (capFlags & 0x01) != 0;
     description.capabilities.supportsLowCutFilter = (capFlags & 0x02) != 0;
     
     // Padding info
-    uint8_t padFlags = param->data[5];
+    uint8_t padFlags = param->rawData[5];
     description.capabilities.padding.available = (padFlags & 0x01) != 0;
     description.capabilities.padding.forced = (padFlags & 0x02) != 0;
     
     // Padding value (if available)
     if (description.capabilities.padding.available) {
-        uint16_t padValueRaw = param->data[6] | (param->data[7] << 8);
+        uint16_t padValueRaw = param->rawData[6] | (param->rawData[7] << 8);
         description.capabilities.padding.value = static_cast<float>(padValueRaw) / 256.0f;
     } else {
         description.capabilities.padding.value = 0.0f;
@@ -158,7 +159,7 @@ bool AudioControl::getSupportedInputs(uint8_t channelIndex, std::vector<InputAva
     // Parameter code is channel_index + 2 to get supported inputs
     auto param = m_controller->getParameter(Category::Audio, channelIndex + 2);
     
-    if (!param || param->data.size() < 2) {
+    if (!param || param->rawData.size() < 2) {
         return false;
     }
     
@@ -167,16 +168,16 @@ bool AudioControl::getSupportedInputs(uint8_t channelIndex, std::vector<InputAva
     
     // Parse binary data for supported inputs
     // Each input is represented by a pair of values: input type and availability
-    for (size_t i = 0; i < param->data.size(); i += 2) {
-        if (i + 1 >= param->data.size()) break;
+    for (size_t i = 0; i < param->rawData.size(); i += 2) {
+        if (i + 1 >= param->rawData.size()) break;
         
         InputAvailability input;
-        uint8_t inputTypeValue = param->data[i];
+        uint8_t inputTypeValue = param->rawData[i];
         
         // Convert raw value to enum
         if (inputTypeValue < 14) {
             input.inputType = static_cast<InputType>(inputTypeValue);
-            input.available = param->data[i + 1] != 0;
+            input.available = param->rawData[i + 1] != 0;
             inputs.push_back(input);
         }
     }
@@ -221,15 +222,15 @@ bool AudioControl::getChannelLevel(uint8_t channelIndex, float& gain, float& nor
     
     auto param = m_controller->getParameter(Category::Audio, parameter);
     
-    if (!param || param->data.size() < 4) {
+    if (!param || param->rawData.size() < 4) {
         return false;
     }
     
     // First 2 bytes: gain in fixed16 format
-    uint16_t gainRaw = param->data[0] | (param->data[1] << 8);
+    uint16_t gainRaw = param->rawData[0] | (param->rawData[1] << 8);
     
     // Next 2 bytes: normalized value in fixed16 format
-    uint16_t normalizedRaw = param->data[2] | (param->data[3] << 8);
+    uint16_t normalizedRaw = param->rawData[2] | (param->rawData[3] << 8);
     
     // Convert to float
     gain = static_cast<float>(gainRaw) / 256.0f;
@@ -243,7 +244,7 @@ bool AudioControl::setPhantomPower(uint8_t channelIndex, bool enabled) {
     uint8_t parameter = channelIndex + 4;
     
     // Create boolean payload
-    std::vector<uint8_t> payload = { enabled ? 0x01 : 0x00 };
+    std::vector<uint8_t> payload = { static_cast<uint8_t>(enabled ? 0x01 : 0x00) };
     
     return m_controller->sendCommand(
         Category::Audio,
@@ -273,7 +274,7 @@ bool AudioControl::setPadding(uint8_t channelIndex, bool enabled) {
     uint8_t parameter = channelIndex + 5;
     
     // Create boolean payload
-    std::vector<uint8_t> payload = { enabled ? 0x01 : 0x00 };
+    std::vector<uint8_t> payload = { static_cast<uint8_t>(enabled ? 0x01 : 0x00) };
     
     return m_controller->sendCommand(
         Category::Audio,
@@ -303,7 +304,7 @@ bool AudioControl::setLowCutFilter(uint8_t channelIndex, bool enabled) {
     uint8_t parameter = channelIndex + 6;
     
     // Create boolean payload
-    std::vector<uint8_t> payload = { enabled ? 0x01 : 0x00 };
+    std::vector<uint8_t> payload = { static_cast<uint8_t>(enabled ? 0x01 : 0x00) };
     
     return m_controller->sendCommand(
         Category::Audio,
@@ -348,27 +349,11 @@ bool AudioControl::setMicLevel(float level) {
         return false;
     }
     
-    // Convert to fixed16 format
-    uint16_t fixed16Value = static_cast<uint16_t>(level * 2048.0f);
-    
-    // Create payload (16-bit little-endian)
-    std::vector<uint8_t> payload = {
-        static_cast<uint8_t>(fixed16Value & 0xFF),
-        static_cast<uint8_t>((fixed16Value >> 8) & 0xFF)
-    };
-    
-    return sendCommand(0x00, DataType::Fixed16, OperationType::Assign, payload);
+    return m_controller->set<Audio::MicLevel>(level);
 }
 
 bool AudioControl::getMicLevel(float& level) const {
-    auto param = m_controller->getParameter(Category::Audio, 0x00);
-    
-    if (!param) {
-        return false;
-    }
-    
-    level = param->toFloat();
-    return true;
+    return m_controller->tryGet<Audio::MicLevel>(level);
 }
 
 bool AudioControl::setHeadphoneLevel(float level) {
@@ -377,27 +362,11 @@ bool AudioControl::setHeadphoneLevel(float level) {
         return false;
     }
     
-    // Convert to fixed16 format
-    uint16_t fixed16Value = static_cast<uint16_t>(level * 2048.0f);
-    
-    // Create payload (16-bit little-endian)
-    std::vector<uint8_t> payload = {
-        static_cast<uint8_t>(fixed16Value & 0xFF),
-        static_cast<uint8_t>((fixed16Value >> 8) & 0xFF)
-    };
-    
-    return sendCommand(0x01, DataType::Fixed16, OperationType::Assign, payload);
+    return m_controller->set<Audio::HeadphoneLevel>(level);
 }
 
 bool AudioControl::getHeadphoneLevel(float& level) const {
-    auto param = m_controller->getParameter(Category::Audio, 0x01);
-    
-    if (!param) {
-        return false;
-    }
-    
-    level = param->toFloat();
-    return true;
+    return m_controller->tryGet<Audio::HeadphoneLevel>(level);
 }
 
 bool AudioControl::setHeadphoneProgramMix(float mix) {
@@ -406,27 +375,11 @@ bool AudioControl::setHeadphoneProgramMix(float mix) {
         return false;
     }
     
-    // Convert to fixed16 format
-    uint16_t fixed16Value = static_cast<uint16_t>(mix * 2048.0f);
-    
-    // Create payload (16-bit little-endian)
-    std::vector<uint8_t> payload = {
-        static_cast<uint8_t>(fixed16Value & 0xFF),
-        static_cast<uint8_t>((fixed16Value >> 8) & 0xFF)
-    };
-    
-    return sendCommand(0x02, DataType::Fixed16, OperationType::Assign, payload);
+    return m_controller->set<Audio::HeadphoneProgramMix>(mix);
 }
 
 bool AudioControl::getHeadphoneProgramMix(float& mix) const {
-    auto param = m_controller->getParameter(Category::Audio, 0x02);
-    
-    if (!param) {
-        return false;
-    }
-    
-    mix = param->toFloat();
-    return true;
+    return m_controller->tryGet<Audio::HeadphoneProgramMix>(mix);
 }
 
 bool AudioControl::setSpeakerLevel(float level) {
@@ -435,43 +388,11 @@ bool AudioControl::setSpeakerLevel(float level) {
         return false;
     }
     
-    // Convert to fixed16 format
-    uint16_t fixed16Value = static_cast<uint16_t>(level * 2048.0f);
-    
-    // Create payload (16-bit little-endian)
-    std::vector<uint8_t> payload = {
-        static_cast<uint8_t>(fixed16Value & 0xFF),
-        static_cast<uint8_t>((fixed16Value >> 8) & 0xFF)
-    };
-    
-    return sendCommand(0x03, DataType::Fixed16, OperationType::Assign, payload);
+    return m_controller->set<Audio::SpeakerLevel>(level);
 }
 
 bool AudioControl::getSpeakerLevel(float& level) const {
-    auto param = m_controller->getParameter(Category::Audio, 0x03);
-    
-    if (!param) {
-        return false;
-    }
-    
-    level = param->toFloat();
-    return true;
-}
-
-bool AudioControl::sendCommand(
-    uint8_t parameter,
-    DataType dataType,
-    OperationType operation,
-    const std::vector<uint8_t>& payload
-) {
-    // Use the controller to send the command
-    return m_controller->sendCommand(
-        Category::Audio,
-        parameter,
-        dataType,
-        operation,
-        payload
-    );
+    return m_controller->tryGet<Audio::SpeakerLevel>(level);
 }
 
 } // namespace BMDCamera
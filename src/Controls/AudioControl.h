@@ -8,9 +8,9 @@
 #include <vector>
 #include "../Protocol/ProtocolConstants.h"
 
-namespace BMDCamera {
+class BMDBLEController; // Forward declaration; the controller is not in the namespace
 
-class BMDBLEController; // Forward declaration
+namespace BMDCamera {
 
 class AudioControl {
 public:
@@ -106,14 +106,6 @@ public:
 private:
     // Parent controller reference
     BMDBLEController* m_controller;
-    
-    // Utility method to send commands
-    bool sendCommand(
-        uint8_t parameter,
-        DataType dataType,
-        OperationType operation,
-        const std::vector<uint8_t>& payload
-    );
 };
 
 } // namespace BMDCamera
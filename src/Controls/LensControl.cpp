@@ -1,7 +1,9 @@
 #include "LensControl.h"
 #include "../BMDBLEController.h"
 #include "../Protocol/ProtocolUtils.h"
-#include <cmath>
+#include "../Protocol/Fixed16.h"
+#include "../Protocol/Parameters.h"
+#include "ApertureTable.h"
 
 namespace BMDCamera {
 
@@ -16,60 +18,31 @@ bool LensControl::setFocus(float normalizedValue) {
         return false;
     }
     
-    // Convert normalized value to fixed16 format
-    uint16_t fixed16Value = floatToFixed16(normalizedValue);
-    
-    // Create payload (16-bit little-endian)
-    std::vector<uint8_t> payload = {
-        static_cast<uint8_t>(fixed16Value & 0xFF),
-        static_cast<uint8_t>((fixed16Value >> 8) & 0xFF)
-    };
-    
-    // Send focus command
-    return sendCommand(0x00, DataType::Fixed16, OperationType::Assign, payload);
+    return m_controller->set<Lens::Focus>(normalizedValue);
 }
 
 bool LensControl::setFocusRaw(uint16_t rawValue) {
-    // rawValue is already in fixed16 format (0-2048)
-    // Create payload (16-bit little-endian)
-    std::vector<uint8_t> payload = {
-        static_cast<uint8_t>(rawValue & 0xFF),
-        static_cast<uint8_t>((rawValue >> 8) & 0xFF)
-    };
-    
-    // Send focus command
-    return sendCommand(0x00, DataType::Fixed16, OperationType::Assign, payload);
+    // rawValue is already in fixed16 format (0-2048); the round trip is exact
+    return m_controller->set<Lens::Focus>(Fixed16::toFloat(static_cast<int16_t>(rawValue)));
 }
 
 bool LensControl::getFocus(float& normalizedValue) const {
-    // Get parameter from controller
-    auto param = m_controller->getParameter(Category::Lens, 0x00);
-    
-    if (!param) {
-        return false;
-    }
-    
-    // Convert to float
-    normalizedValue = param->toFloat();
-    return true;
+    return m_controller->tryGet<Lens::Focus>(normalizedValue);
 }
 
 bool LensControl::getFocusRaw(uint16_t& rawValue) const {
-    // Get parameter from controller
-    auto param = m_controller->getParameter(Category::Lens, 0x00);
-    
-    if (!param) {
+    float value;
+    if (!m_controller->tryGet<Lens::Focus>(value)) {
         return false;
     }
     
-    // Convert to integer and truncate to 16-bit
-    rawValue = static_cast<uint16_t>(param->toInteger() & 0xFFFF);
+    rawValue = static_cast<uint16_t>(Fixed16::fromFloat(value));
     return true;
 }
 
 bool LensControl::triggerAutoFocus() {
     // Auto focus is triggered with an empty (void) command
-    return sendCommand(0x01, DataType::Void, OperationType::Assign, {});
+    return m_controller->set<Lens::AutoFocus>();
 }
 
 bool LensControl::setAperture(float fStopValue) {
@@ -78,11 +51,8 @@ bool LensControl::setAperture(float fStopValue) {
         return false;
     }
     
-    // Convert f-stop to normalized value
-    float normalizedValue = fStopToNormalized(fStopValue);
-    
-    // Set aperture using normalized value
-    return setApertureNormalized(normalizedValue);
+    // Convert f-stop straight to fixed16 through the aperture table
+    return sendApertureFixed16(ApertureTable::fStopToFixed16(fStopValue));
 }
 
 bool LensControl::setApertureNormalized(float normalizedValue) {
@@ -91,28 +61,16 @@ bool LensControl::setApertureNormalized(float normalizedValue) {
         return false;
     }
     
-    // Convert to fixed16 format
-    uint16_t fixed16Value = floatToFixed16(normalizedValue);
-    
-    // Create payload (16-bit little-endian)
-    std::vector<uint8_t> payload = {
-        static_cast<uint8_t>(fixed16Value & 0xFF),
-        static_cast<uint8_t>((fixed16Value >> 8) & 0xFF)
-    };
-    
-    // Send aperture command (parameter 0x03 is normalized aperture)
-    return sendCommand(0x03, DataType::Fixed16, OperationType::Assign, payload);
+    return m_controller->set<Lens::ApertureNormalized>(normalizedValue);
+}
+
+bool LensControl::sendApertureFixed16(uint16_t fixed16Value) {
+    // Parameter 0x03 is normalized aperture
+    return m_controller->set<Lens::ApertureNormalized>(Fixed16::toFloat(static_cast<int16_t>(fixed16Value)));
 }
 
 bool LensControl::setApertureOrdinal(uint8_t ordinalValue) {
-    // Ordinal aperture uses 16-bit integer type
-    std::vector<uint8_t> payload = {
-        static_cast<uint8_t>(ordinalValue),
-        0x00  // High byte is 0 for small values
-    };
-    
-    // Send aperture command (parameter 0x04 is ordinal aperture)
-    return sendCommand(0x04, DataType::SignedInt16, OperationType::Assign, payload);
+    return m_controller->set<Lens::ApertureOrdinal>(ordinalValue);
 }
 
 bool LensControl::getAperture(float& fStopValue) const {
@@ -128,29 +86,12 @@ bool LensControl::getAperture(float& fStopValue) const {
 }
 
 bool LensControl::getApertureNormalized(float& normalizedValue) const {
-    // Get parameter from controller (parameter 0x03 is normalized aperture)
-    auto param = m_controller->getParameter(Category::Lens, 0x03);
-    
-    if (!param) {
-        return false;
-    }
-    
-    // Convert to float
-    normalizedValue = param->toFloat();
-    return true;
+    return m_controller->tryGet<Lens::ApertureNormalized>(normalizedValue);
 }
 
 bool LensControl::getApertureOrdinal(uint8_t& ordinalValue) const {
-    // Get parameter from controller (parameter 0x04 is ordinal aperture)
-    auto param = m_controller->getParameter(Category::Lens, 0x04);
-    
-    if (!param) {
-        return false;
-    }
-    
-    // Convert to integer and ensure it fits in uint8_t
-    int64_t value = param->toInteger();
-    if (value < 0 || value > 255) {
+    int16_t value;
+    if (!m_controller->tryGet<Lens::ApertureOrdinal>(value) || value < 0 || value > 255) {
         return false;
     }
     
@@ -160,39 +101,19 @@ bool LensControl::getApertureOrdinal(uint8_t& ordinalValue) const {
 
 bool LensControl::triggerAutoAperture() {
     // Auto aperture is triggered with an empty (void) command
-    return sendCommand(0x05, DataType::Void, OperationType::Assign, {});
+    return m_controller->set<Lens::AutoAperture>();
 }
 
 bool LensControl::setOpticalImageStabilization(bool enabled) {
-    // Create boolean payload
-    std::vector<uint8_t> payload = { enabled ? 0x01 : 0x00 };
-    
-    // Send OIS command (parameter 0x06)
-    return sendCommand(0x06, DataType::Void, OperationType::Assign, payload);
+    return m_controller->set<Lens::ImageStabilization>(enabled);
 }
 
 bool LensControl::getOpticalImageStabilization(bool& enabled) const {
-    // Get parameter from controller
-    auto param = m_controller->getParameter(Category::Lens, 0x06);
-    
-    if (!param) {
-        return false;
-    }
-    
-    // Convert to boolean
-    enabled = param->toBoolean();
-    return true;
+    return m_controller->tryGet<Lens::ImageStabilization>(enabled);
 }
 
 bool LensControl::setZoomAbsolute(uint16_t focalLengthMm) {
-    // Create payload (16-bit little-endian)
-    std::vector<uint8_t> payload = {
-        static_cast<uint8_t>(focalLengthMm & 0xFF),
-        static_cast<uint8_t>((focalLengthMm >> 8) & 0xFF)
-    };
-    
-    // Send zoom command (parameter 0x07 is absolute zoom in mm)
-    return sendCommand(0x07, DataType::SignedInt16, OperationType::Assign, payload);
+    return m_controller->set<Lens::ZoomMillimeters>(static_cast<int16_t>(focalLengthMm));
 }
 
 bool LensControl::setZoomNormalized(float normalizedValue) {
@@ -201,17 +122,7 @@ bool LensControl::setZoomNormalized(float normalizedValue) {
         return false;
     }
     
-    // Convert to fixed16 format
-    uint16_t fixed16Value = floatToFixed16(normalizedValue);
-    
-    // Create payload (16-bit little-endian)
-    std::vector<uint8_t> payload = {
-        static_cast<uint8_t>(fixed16Value & 0xFF),
-        static_cast<uint8_t>((fixed16Value >> 8) & 0xFF)
-    };
-    
-    // Send zoom command (parameter 0x08 is normalized zoom)
-    return sendCommand(0x08, DataType::Fixed16, OperationType::Assign, payload);
+    return m_controller->set<Lens::ZoomNormalized>(normalizedValue);
 }
 
 bool LensControl::setZoomContinuous(float speed) {
@@ -220,30 +131,12 @@ bool LensControl::setZoomContinuous(float speed) {
         return false;
     }
     
-    // Convert to fixed16 format
-    uint16_t fixed16Value = floatToFixed16(speed);
-    
-    // Create payload (16-bit little-endian)
-    std::vector<uint8_t> payload = {
-        static_cast<uint8_t>(fixed16Value & 0xFF),
-        static_cast<uint8_t>((fixed16Value >> 8) & 0xFF)
-    };
-    
-    // Send zoom command (parameter 0x09 is continuous zoom)
-    return sendCommand(0x09, DataType::Fixed16, OperationType::Assign, payload);
+    return m_controller->set<Lens::ContinuousZoom>(speed);
 }
 
 bool LensControl::getZoomAbsolute(uint16_t& focalLengthMm) const {
-    // Get parameter from controller
-    auto param = m_controller->getParameter(Category::Lens, 0x07);
-    
-    if (!param) {
-        return false;
-    }
-    
-    // Convert to integer and ensure it fits in uint16_t
-    int64_t value = param->toInteger();
-    if (value < 0 || value > UINT16_MAX) {
+    int16_t value;
+    if (!m_controller->tryGet<Lens::ZoomMillimeters>(value) || value < 0) {
         return false;
     }
     
@@ -252,16 +145,7 @@ bool LensControl::getZoomAbsolute(uint16_t& focalLengthMm) const {
 }
 
 bool LensControl::getZoomNormalized(float& normalizedValue) const {
-    // Get parameter from controller
-    auto param = m_controller->getParameter(Category::Lens, 0x08);
-    
-    if (!param) {
-        return false;
-    }
-    
-    // Convert to float
-    normalizedValue = param->toFloat();
-    return true;
+    return m_controller->tryGet<Lens::ZoomNormalized>(normalizedValue);
 }
 
 bool LensControl::getLensModel(std::string& model) const {
@@ -303,57 +187,16 @@ bool LensControl::getFocusDistance(std::string& distance) const {
     return true;
 }
 
-bool LensControl::sendCommand(
-    uint8_t parameter,
-    DataType dataType,
-    OperationType operation,
-    const std::vector<uint8_t>& payload
-) {
-    // Use the controller to send the command
-    return m_controller->sendCommand(
-        Category::Lens,
-        parameter,
-        dataType,
-        operation,
-        payload
-    );
+float LensControl::getLinkIntervalMs() const {
+    return m_controller->getNegotiatedLinkParameters().intervalMs();
 }
 
 float LensControl::normalizedToFStop(float normalizedValue) {
-    // This is an approximation based on typical lens behavior
-    // F-stop follows a geometric progression
+    // F-stop follows a geometric progression between the typical lens
+    // limits; the curve is precomputed in ApertureTable
     // normalizedValue 0.0 = minimum f-stop (widest aperture)
     // normalizedValue 1.0 = maximum f-stop (narrowest aperture)
-    
-    const float minFStop = 1.8f;  // Typical minimum f-stop
-    const float maxFStop = 22.0f; // Typical maximum f-stop
-    const float steps = 8.0f;     // Typical number of full stops
-    
-    // Calculate f-stop value using geometric progression
-    return minFStop * std::pow(maxFStop / minFStop, normalizedValue);
-}
-
-float LensControl::fStopToNormalized(float fStopValue) {
-    // Inverse of normalizedToFStop
-    const float minFStop = 1.8f;
-    const float maxFStop = 22.0f;
-    
-    // Calculate normalized value
-    float normalized = std::log(fStopValue / minFStop) / std::log(maxFStop / minFStop);
-    
-    // Clamp to 0.0-1.0 range
-    return std::max(0.0f, std::min(1.0f, normalized));
-}
-
-uint16_t LensControl::floatToFixed16(float value) {
-    // Convert normalized float (typically 0.0-1.0) to fixed16 format
-    // Fixed16 format: 5 bits integer, 11 bits fractional
-    return static_cast<uint16_t>(value * 2048.0f);
-}
-
-float LensControl::fixed16ToFloat(uint16_t value) {
-    // Convert fixed16 to float
-    return static_cast<float>(value) / 2048.0f;
+    return ApertureTable::normalizedToFStop(normalizedValue);
 }
 
 } // namespace BMDCamera
@@ -5,9 +5,9 @@
 #include <string>
 #include "../Protocol/ProtocolConstants.h"
 
-namespace BMDCamera {
+class BMDBLEController; // Forward declaration; the controller is not in the namespace
 
-class BMDBLEController; // Forward declaration
+namespace BMDCamera {
 
 class LensControl {
 public:
@@ -51,24 +51,19 @@ public:
     bool getLensModel(std::string& model) const;
     bool getFocalLength(std::string& focalLength) const;
     bool getFocusDistance(std::string& distance) const;
+
+    // Connection interval the link negotiated, in ms; 0 until reported
+    float getLinkIntervalMs() const;
     
 private:
     // Parent controller reference
     BMDBLEController* m_controller;
     
     // Utility methods
-    bool sendCommand(
-        uint8_t parameter,
-        DataType dataType,
-        OperationType operation,
-        const std::vector<uint8_t>& payload
-    );
+    bool sendApertureFixed16(uint16_t fixed16Value);
     
     // Conversion utilities
     static float normalizedToFStop(float normalizedValue);
-    static float fStopToNormalized(float fStopValue);
-    static uint16_t floatToFixed16(float value);
-    static float fixed16ToFloat(uint16_t value);
 };
 
 } // namespace BMDCamera
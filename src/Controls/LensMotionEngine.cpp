@@ -0,0 +1,303 @@
+#include "LensMotionEngine.h"
+#include "LensControl.h"
+#include <cmath>
+#include "../Protocol/Fixed16.h"
+#include "../Diagnostics/Metrics.h"
+
+namespace BMDCamera {
+
+LensMotionEngine::LensMotionEngine(LensControl* lens)
+    : m_lens(lens) {
+}
+
+bool LensMotionEngine::play(Axis axis, const Keyframe* keyframes, size_t count, uint32_t startMs) {
+    if (count > MAX_KEYFRAMES || !validKeyframes(keyframes, count)) {
+        return false;
+    }
+
+    AxisState& axisState = state(axis);
+    for (size_t i = 0; i < count; i++) {
+        axisState.keyframes[i] = keyframes[i];
+    }
+    axisState.keyframeCount = count;
+    axisState.startMs = startMs;
+    axisState.lastSendMs = 0;
+    axisState.moving = true;
+    axisState.landing = false;
+
+    return true;
+}
+
+bool LensMotionEngine::moveTo(Axis axis, float target, uint32_t durationMs, Easing easing, uint32_t nowMs) {
+    if (!validValue(target)) {
+        return false;
+    }
+
+    // Start from where the axis is right now, mid-move or not
+    Keyframe keyframes[2] = {
+        { 0, currentPosition(axis, nowMs), Easing::Linear },
+        { durationMs, target, easing }
+    };
+
+    return play(axis, keyframes, 2, nowMs);
+}
+
+void LensMotionEngine::cancel(Axis axis) {
+    state(axis).moving = false;
+}
+
+void LensMotionEngine::cancelAll() {
+    for (auto& axisState : m_axes) {
+        axisState.moving = false;
+    }
+}
+
+bool LensMotionEngine::isMoving(Axis axis) const {
+    return state(axis).moving;
+}
+
+void LensMotionEngine::setCommandRate(uint16_t hz) {
+    m_commandRateHz = hz > 0 ? hz : 1;
+}
+
+uint32_t LensMotionEngine::commandPeriodMs() const {
+    uint32_t periodMs = 1000u / m_commandRateHz;
+
+    // The link carries at most one command per axis per connection event;
+    // sampling faster only queues commands behind the radio
+    float intervalMs = m_lens->getLinkIntervalMs();
+    uint32_t linkPeriodMs = static_cast<uint32_t>(std::ceil(intervalMs));
+    return linkPeriodMs > periodMs ? linkPeriodMs : periodMs;
+}
+
+void LensMotionEngine::update(uint32_t nowMs) {
+    const uint32_t periodMs = commandPeriodMs();
+
+    for (size_t i = 0; i < AXIS_COUNT; i++) {
+        Axis axis = static_cast<Axis>(i);
+        AxisState& axisState = m_axes[i];
+
+        // Camera reports arrive independently of our commands
+        float reported;
+        if (axisState.hasCommanded && readReported(axis, reported)) {
+            axisState.trackingError = reported - axisState.commanded;
+        }
+
+        if (!axisState.moving) {
+            continue;
+        }
+
+        // Not started yet
+        if (static_cast<int32_t>(nowMs - axisState.startMs) < 0) {
+            continue;
+        }
+
+        uint32_t elapsedMs = nowMs - axisState.startMs;
+        const Keyframe& last = axisState.keyframes[axisState.keyframeCount - 1];
+        bool finished = elapsedMs >= last.timeMs;
+
+        // Hold to the command rate, except for the first try at the final
+        // value; retries of a refused final value are held too
+        bool held = axisState.hasCommanded && nowMs - axisState.lastSendMs < periodMs;
+        if (held && !(finished && !axisState.landing)) {
+            continue;
+        }
+
+        float value = finished ? last.value : sample(axisState, elapsedMs);
+        bool sent = send(axis, value);
+        axisState.lastSendMs = nowMs;
+
+        // The move is only done once the link has taken the final value
+        if (finished) {
+            axisState.landing = true;
+            axisState.moving = !sent;
+        }
+    }
+}
+
+void LensMotionEngine::reportPosition(Axis axis, float value) {
+    AxisState& axisState = state(axis);
+    if (axisState.hasCommanded && std::isfinite(value)) {
+        axisState.trackingError = value - axisState.commanded;
+    }
+}
+
+float LensMotionEngine::getTrackingError(Axis axis) const {
+    return state(axis).trackingError;
+}
+
+float LensMotionEngine::getCommandedValue(Axis axis) const {
+    return state(axis).commanded;
+}
+
+bool LensMotionEngine::validValue(float value) {
+    // NaN fails every comparison, so test it explicitly
+    return std::isfinite(value) && value >= 0.0f && value <= 1.0f;
+}
+
+bool LensMotionEngine::validKeyframes(const Keyframe* keyframes, size_t count) {
+    if (keyframes == nullptr || count == 0) {
+        return false;
+    }
+
+    // Keyframes must be in time order and in range
+    for (size_t i = 0; i < count; i++) {
+        if (!validValue(keyframes[i].value)) {
+            return false;
+        }
+        if (i > 0 && keyframes[i].timeMs < keyframes[i - 1].timeMs) {
+            return false;
+        }
+    }
+    return true;
+}
+
+float LensMotionEngine::ease(Easing easing, float t) {
+    if (t <= 0.0f) {
+        return 0.0f;
+    }
+    if (t >= 1.0f) {
+        return 1.0f;
+    }
+
+    switch (easing) {
+        case Easing::EaseIn:
+            return t * t * t;
+        case Easing::EaseOut: {
+            float inv = 1.0f - t;
+            return 1.0f - inv * inv * inv;
+        }
+        case Easing::EaseInOut: {
+            if (t < 0.5f) {
+                return 4.0f * t * t * t;
+            }
+            float inv = -2.0f * t + 2.0f;
+            return 1.0f - inv * inv * inv * 0.5f;
+        }
+        case Easing::Step:
+            return 0.0f;
+        case Easing::Linear:
+        default:
+            return t;
+    }
+}
+
+float LensMotionEngine::sample(const AxisState& axisState, uint32_t elapsedMs) const {
+    return sampleKeyframes(axisState.keyframes.data(), axisState.keyframeCount, elapsedMs);
+}
+
+float LensMotionEngine::sampleKeyframes(const Keyframe* keys, size_t count, uint32_t elapsedMs) {
+    if (elapsedMs <= keys[0].timeMs) {
+        return keys[0].value;
+    }
+
+    // Find the segment containing elapsedMs
+    for (size_t i = 1; i < count; i++) {
+        if (elapsedMs < keys[i].timeMs) {
+            const Keyframe& from = keys[i - 1];
+            const Keyframe& to = keys[i];
+            float t = static_cast<float>(elapsedMs - from.timeMs) /
+                      static_cast<float>(to.timeMs - from.timeMs);
+            return from.value + (to.value - from.value) * ease(to.easing, t);
+        }
+    }
+
+    return keys[count - 1].value;
+}
+
+size_t LensMotionEngine::renderCurve(
+    const Keyframe* keyframes,
+    size_t count,
+    uint32_t stepMs,
+    int16_t* out,
+    size_t maxSamples
+) {
+    if (stepMs == 0 || out == nullptr || !validKeyframes(keyframes, count)) {
+        return 0;
+    }
+
+    // One sample per step up to and including the last keyframe
+    size_t total = keyframes[count - 1].timeMs / stepMs + 1;
+    if (total > maxSamples) {
+        total = maxSamples;
+    }
+
+    // Sample a block at a time, then encode the block in one batch
+    constexpr size_t BLOCK = 32;
+    float values[BLOCK];
+
+    for (size_t start = 0; start < total; start += BLOCK) {
+        size_t n = total - start < BLOCK ? total - start : BLOCK;
+        for (size_t i = 0; i < n; i++) {
+            values[i] = sampleKeyframes(keyframes, count, static_cast<uint32_t>((start + i) * stepMs));
+        }
+        Fixed16::fromFloat(values, out + start, n);
+    }
+
+    return total;
+}
+
+float LensMotionEngine::currentPosition(Axis axis, uint32_t nowMs) const {
+    const AxisState& axisState = state(axis);
+
+    if (axisState.moving && static_cast<int32_t>(nowMs - axisState.startMs) >= 0) {
+        return sample(axisState, nowMs - axisState.startMs);
+    }
+    if (axisState.hasCommanded) {
+        return axisState.commanded;
+    }
+
+    // Nothing commanded yet; fall back to what the camera last reported
+    float reported = 0.0f;
+    readReported(axis, reported);
+    return reported;
+}
+
+bool LensMotionEngine::readReported(Axis axis, float& value) const {
+    switch (axis) {
+        case Axis::Focus:
+            return m_lens->getFocus(value);
+        case Axis::Zoom:
+            return m_lens->getZoomNormalized(value);
+        case Axis::Iris:
+            return m_lens->getApertureNormalized(value);
+    }
+    return false;
+}
+
+bool LensMotionEngine::send(Axis axis, float value) {
+    AxisState& axisState = state(axis);
+
+    // Coalesce samples that encode to the command already sent; the
+    // camera already has this value
+    int32_t fixed16 = Fixed16::fromFloat(value);
+    if (axisState.hasCommanded && fixed16 == axisState.lastFixed16) {
+        m_commandsCoalesced++;
+        MetricsRegistry::instance().increment(Counter::CommandsCoalesced);
+        return true;
+    }
+
+    bool sent = false;
+    switch (axis) {
+        case Axis::Focus:
+            sent = m_lens->setFocus(value);
+            break;
+        case Axis::Zoom:
+            sent = m_lens->setZoomNormalized(value);
+            break;
+        case Axis::Iris:
+            sent = m_lens->setApertureNormalized(value);
+            break;
+    }
+
+    if (sent) {
+        axisState.commanded = value;
+        axisState.lastFixed16 = fixed16;
+        axisState.hasCommanded = true;
+        m_commandsSent++;
+    }
+
+    return sent;
+}
+
+} // namespace BMDCamera
@@ -0,0 +1,135 @@
+#ifndef BMD_LENS_MOTION_ENGINE_H
+#define BMD_LENS_MOTION_ENGINE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+namespace BMDCamera {
+
+class LensControl; // Forward declaration
+
+// Plays keyframed focus/zoom/iris curves through LensControl. Curves are
+// sampled at the link's command rate and only values that change the
+// encoded fixed16 command are sent.
+class LensMotionEngine {
+public:
+    enum class Axis : uint8_t {
+        Focus = 0,
+        Zoom = 1,
+        Iris = 2
+    };
+    static constexpr size_t AXIS_COUNT = 3;
+
+    // Shape of the segment arriving at a keyframe
+    enum class Easing : uint8_t {
+        Linear = 0,
+        EaseIn,
+        EaseOut,
+        EaseInOut,
+        Step          // Hold the previous value, then jump
+    };
+
+    struct Keyframe {
+        uint32_t timeMs;  // Offset from the start of the move
+        float value;      // Normalized 0.0-1.0
+        Easing easing;
+    };
+
+    static constexpr size_t MAX_KEYFRAMES = 16;
+
+    // Constructor requires the lens control to drive
+    explicit LensMotionEngine(LensControl* lens);
+
+    // Start a keyframed move at startMs. Keyframe times must be ascending
+    // and values finite and in range; the first keyframe is where the move
+    // begins.
+    bool play(Axis axis, const Keyframe* keyframes, size_t count, uint32_t startMs);
+
+    // Move from the current position to target over durationMs. Calling this
+    // mid-move retargets smoothly from wherever the axis currently is.
+    bool moveTo(Axis axis, float target, uint32_t durationMs, Easing easing, uint32_t nowMs);
+
+    // Stop an axis where it is
+    void cancel(Axis axis);
+    void cancelAll();
+
+    bool isMoving(Axis axis) const;
+
+    // Highest sampling rate in commands per second per axis. Once the link
+    // has reported its connection interval, the rate is also held to one
+    // command per axis per connection event.
+    void setCommandRate(uint16_t hz);
+    uint16_t getCommandRate() const { return m_commandRateHz; }
+
+    // Time between commands on one axis, from both limits above
+    uint32_t commandPeriodMs() const;
+
+    // Sample all moving axes and send commands that are due. A final value
+    // the link refuses is retried at the command rate until it is sent.
+    // Also measures tracking error against the lens positions the camera
+    // last reported, from the controller's parameter cache.
+    void update(uint32_t nowMs);
+
+    // Feed a position measured elsewhere, for an axis the camera doesn't
+    // report; update() replaces it once the camera reports the axis
+    void reportPosition(Axis axis, float value);
+
+    // Last reported position minus last commanded position
+    float getTrackingError(Axis axis) const;
+    float getCommandedValue(Axis axis) const;
+
+    // Commands emitted, and samples dropped because the encoded value
+    // had not changed
+    uint32_t getCommandsSent() const { return m_commandsSent; }
+    uint32_t getCommandsCoalesced() const { return m_commandsCoalesced; }
+
+    // Apply an easing curve to t in [0, 1]
+    static float ease(Easing easing, float t);
+
+    // Sample a keyframed curve every stepMs and encode it to fixed16 in one
+    // pass, e.g. to export a whole move. Returns the number of samples
+    // written, 0 if the keyframes are invalid.
+    static size_t renderCurve(
+        const Keyframe* keyframes,
+        size_t count,
+        uint32_t stepMs,
+        int16_t* out,
+        size_t maxSamples
+    );
+
+private:
+    struct AxisState {
+        std::array<Keyframe, MAX_KEYFRAMES> keyframes;
+        size_t keyframeCount = 0;
+        uint32_t startMs = 0;
+        uint32_t lastSendMs = 0;
+        bool moving = false;
+        bool landing = false;     // The final value has been tried at least once
+        bool hasCommanded = false;
+        float commanded = 0.0f;
+        int32_t lastFixed16 = -1;
+        float trackingError = 0.0f;
+    };
+
+    AxisState& state(Axis axis) { return m_axes[static_cast<size_t>(axis)]; }
+    const AxisState& state(Axis axis) const { return m_axes[static_cast<size_t>(axis)]; }
+
+    static bool validValue(float value);
+    static bool validKeyframes(const Keyframe* keyframes, size_t count);
+    float sample(const AxisState& axisState, uint32_t elapsedMs) const;
+    static float sampleKeyframes(const Keyframe* keys, size_t count, uint32_t elapsedMs);
+    float currentPosition(Axis axis, uint32_t nowMs) const;
+    bool readReported(Axis axis, float& value) const;
+    bool send(Axis axis, float value);
+
+    LensControl* m_lens;
+    std::array<AxisState, AXIS_COUNT> m_axes;
+    uint16_t m_commandRateHz = 50;
+    uint32_t m_commandsSent = 0;
+    uint32_t m_commandsCoalesced = 0;
+};
+
+} // namespace BMDCamera
+
+#endif // BMD_LENS_MOTION_ENGINE_H
@@ -35,19 +35,19 @@ std::optional<TransportControl::TransportMode> TransportControl::getTransportMod
 bool TransportControl::getTransportState(TransportState& state) const {
     auto param = m_controller->getParameter(Category::Transport, 0x01);
     
-    if (!param || param->data.size() < 5) {
+    if (!param || param->rawData.size() < 5) {
         return false;
     }
     
     // Byte 0: Mode
-    state.mode = static_cast<TransportMode>(param->data[0] & 0x03);
+    state.mode = static_cast<TransportMode>(param->rawData[0] & 0x03);
     
     // Byte 1: Speed (signed)
-    int8_t speedValue = static_cast<int8_t>(param->data[1]);
+    int8_t speedValue = static_cast<int8_t>(param->rawData[1]);
     state.speed = static_cast<float>(speedValue);
     
     // Byte 2: Flags
-    uint8_t flags = param->data[2];
+    uint8_t flags = param->rawData[2];
     state.loop = (flags & 0x01) != 0;
     state.playAll = (flags & 0x02) != 0;
     state.disk1Active = (flags & 0x20) != 0;
@@ -55,8 +55,8 @@ bool TransportControl::getTransportState(TransportState& state) const {
     state.timeLapseRecording = (flags & 0x80) != 0;
     
     // Byte 3-4: Storage medium
-    state.slot1Medium = static_cast<TransportState::StorageMedium>(param->data[3] & 0x03);
-    state.slot2Medium = static_cast<TransportState::StorageMedium>(param->data[4] & 0x03);
+    state.slot1Medium = static_cast<TransportState::StorageMedium>(param->rawData[3] & 0x03);
+    state.slot2Medium = static_cast<TransportState::StorageMedium>(param->rawData[4] & 0x03);
     
     return true;
 }
@@ -140,35 +140,9 @@ bool TransportControl::skipClip(PlaybackDirection direction) {
 }
 
 bool TransportControl::setPlaybackState(const PlaybackState& state) {
+    // Padded to a whole 32-bit word
     std::vector<uint8_t> payload(12, 0);
-    
-    // Byte 0: Type
-    payload[0] = static_cast<uint8_t>(state.type);
-    
-    // Byte 1: Loop
-    payload[1] = state.loop ? 0x01 : 0x00;
-    
-    // Byte 2: Single clip
-    payload[2] = state.singleClip ? 0x01 : 0x00;
-    
-    // Bytes 3-6: Speed (float32)
-    // Convert float to IEEE 754 format
-    union {
-        float f;
-        uint32_t i;
-    } converter;
-    converter.f = state.speed;
-    
-    payload[3] = static_cast<uint8_t>(converter.i & 0xFF);
-    payload[4] = static_cast<uint8_t>((converter.i >> 8) & 0xFF);
-    payload[5] = static_cast<uint8_t>((converter.i >> 16) & 0xFF);
-    payload[6] = static_cast<uint8_t>((converter.i >> 24) & 0xFF);
-    
-    // Bytes 7-10: Position (int32)
-    payload[7] = static_cast<uint8_t>(state.position & 0xFF);
-    payload[8] = static_cast<uint8_t>((state.position >> 8) & 0xFF);
-    payload[9] = static_cast<uint8_t>((state.position >> 16) & 0xFF);
-    payload[10] = static_cast<uint8_t>((state.position >> 24) & 0xFF);
+    PlaybackState::encode(state, payload.data());
     
     return m_controller->sendCommand(
         Category::Transport,
@@ -182,45 +156,16 @@ bool TransportControl::setPlaybackState(const PlaybackState& state) {
 std::optional<TransportControl::PlaybackState> TransportControl::getPlaybackState() const {
     auto param = m_controller->getParameter(Category::Transport, 0x05);
     
-    if (!param || param->data.size() < 11) {
+    PlaybackState state;
+    if (!param || !PlaybackState::decode(param->rawData.data(), param->rawData.size(), state)) {
         return std::nullopt;
     }
     
-    PlaybackState state;
-    
-    // Byte 0: Type
-    state.type = static_cast<PlaybackType>(param->data[0]);
-    
-    // Byte 1: Loop
-    state.loop = param->data[1] != 0;
-    
-    // Byte 2: Single clip
-    state.singleClip = param->data[2] != 0;
-    
-    // Bytes 3-6: Speed (float32)
-    union {
-        uint32_t i;
-        float f;
-    } converter;
-    converter.i = 
-        static_cast<uint32_t>(param->data[3]) |
-        (static_cast<uint32_t>(param->data[4]) << 8) |
-        (static_cast<uint32_t>(param->data[5]) << 16) |
-        (static_cast<uint32_t>(param->data[6]) << 24);
-    state.speed = converter.f;
-    
-    // Bytes 7-10: Position (int32)
-    state.position = 
-        static_cast<int32_t>(param->data[7]) |
-        (static_cast<int32_t>(param->data[8]) << 8) |
-        (static_cast<int32_t>(param->data[9]) << 16) |
-        (static_cast<int32_t>(param->data[10]) << 24);
-    
     return state;
 }
 
 bool TransportControl::setStreamEnabled(bool enabled) {
-    std::vector<uint8_t> payload = { enabled ? 0x01 : 0x00 };
+    std::vector<uint8_t> payload = { static_cast<uint8_t>(enabled ? 0x01 : 0x00) };
     
     return sendCommand(0x05, DataType::Void, OperationType::Assign, payload);
 }
@@ -236,7 +181,7 @@ bool TransportControl::isStreamEnabled() const {
 }
 
 bool TransportControl::setStreamInfo(bool enabled) {
-    std::vector<uint8_t> payload = { enabled ? 0x01 : 0x00 };
+    std::vector<uint8_t> payload = { static_cast<uint8_t>(enabled ? 0x01 : 0x00) };
     
     return sendCommand(0x06, DataType::Void, OperationType::Assign, payload);
 }
@@ -253,7 +198,7 @@ bool TransportControl::getStreamInfo(bool& enabled) const {
 }
 
 bool TransportControl::setStreamDisplay3DLUT(bool enabled) {
-    std::vector<uint8_t> payload = { enabled ? 0x01 : 0x00 };
+    std::vector<uint8_t> payload = { static_cast<uint8_t>(enabled ? 0x01 : 0x00) };
     
     return sendCommand(0x07, DataType::Void, OperationType::Assign, payload);
 }
@@ -297,26 +242,28 @@ bool TransportControl::setCodecFormat(const CodecFormat& format) {
 std::optional<TransportControl::CodecFormat> TransportControl::getCodecFormat() const {
     auto param = m_controller->getParameter(Category::Transport, 0x00);
     
-    if (!param || param->data.size() < 2) {
+    if (!param || param->rawData.size() < 2) {
         return std::nullopt;
     }
     
     CodecFormat format;
     
     // Byte 0: Codec
-    format.codec = static_cast<CodecType>(param->data[0]);
+    format.codec = static_cast<CodecType>(param->rawData[0]);
     
     // Byte 1: Variant
     switch (format.codec) {
         case CodecType::CinemaDNG:
-            format.cinemaDNG.variant = static_cast<CodecFormat::cinemaDNG::Variant>(param->data[1]);
+            format.cinemaDNG.variant = static_cast<decltype(format.cinemaDNG.variant)>(param->rawData[1]);
             break;
         case CodecType::ProRes:
-            format.prores.variant = static_cast<CodecFormat::prores::Variant>(param->data[1]);
+            format.prores.variant = static_cast<decltype(format.prores.variant)>(param->rawData[1]);
             break;
         case CodecType::BlackmagicRAW:
-            format.braw.variant = static_cast<CodecFormat::braw::Variant>(param->data[1]);
+            format.braw.variant = static_cast<decltype(format.braw.variant)>(param->rawData[1]);
             break;
+        default:
+            break; // No variant for DNxHD
     }
     
     return format;
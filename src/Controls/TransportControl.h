@@ -7,10 +7,11 @@
 #include <optional>
 #include <vector>
 #include "../Protocol/ProtocolConstants.h"
+#include "../Protocol/PlaybackState.h"
 
-namespace BMDCamera {
+class BMDBLEController; // Forward declaration; the controller is not in the namespace
 
-class BMDBLEController; // Forward declaration
+namespace BMDCamera {
 
 class TransportControl {
 public:
@@ -68,21 +69,9 @@ public:
     
     bool skipClip(PlaybackDirection direction);
     
-    // Playback state
-    enum class PlaybackType : uint8_t {
-        Play = 0,
-        Jog = 1,
-        Shuttle = 2,
-        Var = 3
-    };
-    
-    struct PlaybackState {
-        PlaybackType type;
-        bool loop;
-        bool singleClip;
-        float speed;
-        int32_t position; // frame position
-    };
+    // Playback state; the payload format is in PlaybackState.h
+    using PlaybackType = BMDCamera::PlaybackType;
+    using PlaybackState = BMDCamera::PlaybackState;
     
     bool setPlaybackState(const PlaybackState& state);
     std::optional<PlaybackState> getPlaybackState() const;
@@ -1,6 +1,7 @@
 #include "VideoControl.h"
 #include "../BMDBLEController.h"
 #include "../Protocol/ProtocolUtils.h"
+#include "../Protocol/Parameters.h"
 #include <cmath>
 
 namespace BMDCamera {
@@ -11,112 +12,77 @@ VideoControl::VideoControl(BMDBLEController* controller)
 }
 
 bool VideoControl::setVideoMode(const VideoMode& mode) {
-    // Pack mode data into payload
-    std::vector<uint8_t> payload = {
-        mode.frameRate,
-        static_cast<uint8_t>(mode.isMRate ? 1 : 0),
-        mode.dimensions,
-        static_cast<uint8_t>(mode.isInterlaced ? 1 : 0),
-        mode.colorSpace
-    };
-    
-    return sendCommand(0x00, DataType::SignedByte, OperationType::Assign, payload);
+    return m_controller->set<Video::Mode>({
+        static_cast<int8_t>(mode.frameRate),
+        static_cast<int8_t>(mode.isMRate ? 1 : 0),
+        static_cast<int8_t>(mode.dimensions),
+        static_cast<int8_t>(mode.isInterlaced ? 1 : 0),
+        static_cast<int8_t>(mode.colorSpace)
+    });
 }
 
 std::optional<VideoControl::VideoMode> VideoControl::getVideoMode() const {
-    auto param = m_controller->getParameter(Category::Video, 0x00);
-    
-    if (!param || param->data.size() < 5) {
+    Video::Mode::Value values;
+    if (!m_controller->tryGet<Video::Mode>(values)) {
         return std::nullopt;
     }
     
     VideoMode mode;
-    mode.frameRate = param->data[0];
-    mode.isMRate = param->data[1] != 0;
-    mode.dimensions = param->data[2];
-    mode.isInterlaced = param->data[3] != 0;
-    mode.colorSpace = param->data[4];
+    mode.frameRate = static_cast<uint8_t>(values[0]);
+    mode.isMRate = values[1] != 0;
+    mode.dimensions = static_cast<uint8_t>(values[2]);
+    mode.isInterlaced = values[3] != 0;
+    mode.colorSpace = static_cast<uint8_t>(values[4]);
     
     return mode;
 }
 
 bool VideoControl::setWhiteBalance(uint16_t kelvin, int16_t tint) {
-    // Create payload (4 bytes: kelvin and tint as 16-bit integers)
-    std::vector<uint8_t> payload = {
-        static_cast<uint8_t>(kelvin & 0xFF),
-        static_cast<uint8_t>((kelvin >> 8) & 0xFF),
-        static_cast<uint8_t>(tint & 0xFF),
-        static_cast<uint8_t>((tint >> 8) & 0xFF)
-    };
-    
-    return sendCommand(0x02, DataType::SignedInt16, OperationType::Assign, payload);
+    return m_controller->set<Video::WhiteBalance>({ static_cast<int16_t>(kelvin), tint });
 }
 
 bool VideoControl::getWhiteBalance(uint16_t& kelvin, int16_t& tint) const {
-    auto param = m_controller->getParameter(Category::Video, 0x02);
-    
-    if (!param || param->data.size() < 4) {
+    Video::WhiteBalance::Value values;
+    if (!m_controller->tryGet<Video::WhiteBalance>(values)) {
         return false;
     }
     
-    kelvin = static_cast<uint16_t>(param->data[0] | (param->data[1] << 8));
-    tint = static_cast<int16_t>(param->data[2] | (param->data[3] << 8));
+    kelvin = static_cast<uint16_t>(values[0]);
+    tint = values[1];
     
     return true;
 }
 
 bool VideoControl::triggerAutoWhiteBalance() {
     // Auto white balance is triggered with an empty command
-    return sendCommand(0x03, DataType::Void, OperationType::Assign, {});
+    return m_controller->set<Video::SetAutoWhiteBalance>();
 }
 
 bool VideoControl::restoreAutoWhiteBalance() {
-    // Restore auto white balance is parameter 0x04
-    return sendCommand(0x04, DataType::Void, OperationType::Assign, {});
+    return m_controller->set<Video::RestoreAutoWhiteBalance>();
 }
 
 bool VideoControl::setExposure(uint32_t microseconds) {
-    // Create payload (32-bit integer, little-endian)
-    std::vector<uint8_t> payload = {
-        static_cast<uint8_t>(microseconds & 0xFF),
-        static_cast<uint8_t>((microseconds >> 8) & 0xFF),
-        static_cast<uint8_t>((microseconds >> 16) & 0xFF),
-        static_cast<uint8_t>((microseconds >> 24) & 0xFF)
-    };
-    
-    return sendCommand(0x05, DataType::SignedInt32, OperationType::Assign, payload);
+    return m_controller->set<Video::Exposure>(static_cast<int32_t>(microseconds));
 }
 
 bool VideoControl::getExposure(uint32_t& microseconds) const {
-    auto param = m_controller->getParameter(Category::Video, 0x05);
-    
-    if (!param) {
+    int32_t value;
+    if (!m_controller->tryGet<Video::Exposure>(value)) {
         return false;
     }
     
-    microseconds = static_cast<uint32_t>(param->toInteger());
+    microseconds = static_cast<uint32_t>(value);
     return true;
 }
 
 bool VideoControl::setExposureOrdinal(uint16_t ordinalValue) {
-    // Create payload (16-bit integer, little-endian)
-    std::vector<uint8_t> payload = {
-        static_cast<uint8_t>(ordinalValue & 0xFF),
-        static_cast<uint8_t>((ordinalValue >> 8) & 0xFF)
-    };
-    
-    return sendCommand(0x06, DataType::SignedInt16, OperationType::Assign, payload);
+    return m_controller->set<Video::ExposureOrdinal>(static_cast<int16_t>(ordinalValue));
 }
 
 bool VideoControl::getExposureOrdinal(uint16_t& ordinalValue) const {
-    auto param = m_controller->getParameter(Category::Video, 0x06);
-    
-    if (!param) {
-        return false;
-    }
-    
-    int64_t value = param->toInteger();
-    if (value < 0 || value > UINT16_MAX) {
+    int16_t value;
+    if (!m_controller->tryGet<Video::ExposureOrdinal>(value) || value < 0) {
         return false;
     }
     
@@ -125,21 +91,12 @@ bool VideoControl::getExposureOrdinal(uint16_t& ordinalValue) const {
 }
 
 bool VideoControl::setDynamicRangeMode(DynamicRangeMode mode) {
-    // Create payload (single byte)
-    std::vector<uint8_t> payload = { static_cast<uint8_t>(mode) };
-    
-    return sendCommand(0x07, DataType::SignedByte, OperationType::Assign, payload);
+    return m_controller->set<Video::DynamicRange>(static_cast<int8_t>(mode));
 }
 
 std::optional<VideoControl::DynamicRangeMode> VideoControl::getDynamicRangeMode() const {
-    auto param = m_controller->getParameter(Category::Video, 0x07);
-    
-    if (!param) {
-        return std::nullopt;
-    }
-    
-    int64_t value = param->toInteger();
-    if (value < 0 || value > 2) {
+    int8_t value;
+    if (!m_controller->tryGet<Video::DynamicRange>(value) || value < 0 || value > 2) {
         return std::nullopt;
     }
     
@@ -147,21 +104,12 @@ std::optional<VideoControl::DynamicRangeMode> VideoControl::getDynamicRangeMode(
 }
 
 bool VideoControl::setSharpeningLevel(SharpeningLevel level) {
-    // Create payload (single byte)
-    std::vector<uint8_t> payload = { static_cast<uint8_t>(level) };
-    
-    return sendCommand(0x08, DataType::SignedByte, OperationType::Assign, payload);
+    return m_controller->set<Video::Sharpening>(static_cast<int8_t>(level));
 }
 
 std::optional<VideoControl::SharpeningLevel> VideoControl::getSharpeningLevel() const {
-    auto param = m_controller->getParameter(Category::Video, 0x08);
-    
-    if (!param) {
-        return std::nullopt;
-    }
-    
-    int64_t value = param->toInteger();
-    if (value < 0 || value > 3) {
+    int8_t value;
+    if (!m_controller->tryGet<Video::Sharpening>(value) || value < 0 || value > 3) {
         return std::nullopt;
     }
     
@@ -169,48 +117,37 @@ std::optional<VideoControl::SharpeningLevel> VideoControl::getSharpeningLevel()
 }
 
 bool VideoControl::setRecordingFormat(const RecordingFormat& format) {
-    // Pack format data into payload (9 values, but using bit flags for booleans)
-    std::vector<uint8_t> payload = {
-        static_cast<uint8_t>(format.fileFrameRate & 0xFF),
-        static_cast<uint8_t>((format.fileFrameRate >> 8) & 0xFF),
-        
-        static_cast<uint8_t>(format.sensorFrameRate & 0xFF),
-        static_cast<uint8_t>((format.sensorFrameRate >> 8) & 0xFF),
-        
-        static_cast<uint8_t>(format.frameWidth & 0xFF),
-        static_cast<uint8_t>((format.frameWidth >> 8) & 0xFF),
-        
-        static_cast<uint8_t>(format.frameHeight & 0xFF),
-        static_cast<uint8_t>((format.frameHeight >> 8) & 0xFF),
-        
-        // Pack boolean flags into a single byte
-        static_cast<uint8_t>(
-            (format.isFileMRate ? 0x01 : 0) |
-            (format.isSensorMRate ? 0x02 : 0) |
-            (format.isSensorOffSpeed ? 0x04 : 0) |
-            (format.isInterlaced ? 0x08 : 0) |
-            (format.isWindowed ? 0x10 : 0)
-        )
-    };
-    
-    return sendCommand(0x09, DataType::SignedInt16, OperationType::Assign, payload);
+    // Four dimensions followed by the boolean flags packed into the fifth value
+    int16_t flags =
+        (format.isFileMRate ? 0x01 : 0) |
+        (format.isSensorMRate ? 0x02 : 0) |
+        (format.isSensorOffSpeed ? 0x04 : 0) |
+        (format.isInterlaced ? 0x08 : 0) |
+        (format.isWindowed ? 0x10 : 0);
+    
+    return m_controller->set<Video::RecordingFormat>({
+        static_cast<int16_t>(format.fileFrameRate),
+        static_cast<int16_t>(format.sensorFrameRate),
+        static_cast<int16_t>(format.frameWidth),
+        static_cast<int16_t>(format.frameHeight),
+        flags
+    });
 }
 
 std::optional<VideoControl::RecordingFormat> VideoControl::getRecordingFormat() const {
-    auto param = m_controller->getParameter(Category::Video, 0x09);
-    
-    if (!param || param->data.size() < 9) {
+    Video::RecordingFormat::Value values;
+    if (!m_controller->tryGet<Video::RecordingFormat>(values)) {
         return std::nullopt;
     }
     
     RecordingFormat format;
-    format.fileFrameRate = static_cast<uint16_t>(param->data[0] | (param->data[1] << 8));
-    format.sensorFrameRate = static_cast<uint16_t>(param->data[2] | (param->data[3] << 8));
-    format.frameWidth = static_cast<uint16_t>(param->data[4] | (param->data[5] << 8));
-    format.frameHeight = static_cast<uint16_t>(param->data[6] | (param->data[7] << 8));
+    format.fileFrameRate = static_cast<uint16_t>(values[0]);
+    format.sensorFrameRate = static_cast<uint16_t>(values[1]);
+    format.frameWidth = static_cast<uint16_t>(values[2]);
+    format.frameHeight = static_cast<uint16_t>(values[3]);
     
-    // Unpack boolean flags from byte
-    uint8_t flags = param->data[8];
+    // Unpack boolean flags
+    int16_t flags = values[4];
     format.isFileMRate = (flags & 0x01) != 0;
     format.isSensorMRate = (flags & 0x02) != 0;
     format.isSensorOffSpeed = (flags & 0x04) != 0;
@@ -221,21 +158,12 @@ std::optional<VideoControl::RecordingFormat> VideoControl::getRecordingFormat()
 }
 
 bool VideoControl::setAutoExposureMode(AutoExposureMode mode) {
-    // Create payload (single byte)
-    std::vector<uint8_t> payload = { static_cast<uint8_t>(mode) };
-    
-    return sendCommand(0x0A, DataType::SignedByte, OperationType::Assign, payload);
+    return m_controller->set<Video::AutoExposureMode>(static_cast<int8_t>(mode));
 }
 
 std::optional<VideoControl::AutoExposureMode> VideoControl::getAutoExposureMode() const {
-    auto param = m_controller->getParameter(Category::Video, 0x0A);
-    
-    if (!param) {
-        return std::nullopt;
-    }
-    
-    int64_t value = param->toInteger();
-    if (value < 0 || value > 4) {
+    int8_t value;
+    if (!m_controller->tryGet<Video::AutoExposureMode>(value) || value < 0 || value > 4) {
         return std::nullopt;
     }
     
@@ -243,96 +171,53 @@ std::optional<VideoControl::AutoExposureMode> VideoControl::getAutoExposureMode(
 }
 
 bool VideoControl::setShutterAngle(uint32_t angleHundredths) {
-    // Create payload (32-bit integer, little-endian)
-    std::vector<uint8_t> payload = {
-        static_cast<uint8_t>(angleHundredths & 0xFF),
-        static_cast<uint8_t>((angleHundredths >> 8) & 0xFF),
-        static_cast<uint8_t>((angleHundredths >> 16) & 0xFF),
-        static_cast<uint8_t>((angleHundredths >> 24) & 0xFF)
-    };
-    
-    return sendCommand(0x0B, DataType::SignedInt32, OperationType::Assign, payload);
+    return m_controller->set<Video::ShutterAngle>(static_cast<int32_t>(angleHundredths));
 }
 
 bool VideoControl::getShutterAngle(uint32_t& angleHundredths) const {
-    auto param = m_controller->getParameter(Category::Video, 0x0B);
-    
-    if (!param) {
+    int32_t value;
+    if (!m_controller->tryGet<Video::ShutterAngle>(value)) {
         return false;
     }
     
-    angleHundredths = static_cast<uint32_t>(param->toInteger());
+    angleHundredths = static_cast<uint32_t>(value);
     return true;
 }
 
 bool VideoControl::setShutterSpeed(uint32_t speed) {
-    // Create payload (32-bit integer, little-endian)
-    std::vector<uint8_t> payload = {
-        static_cast<uint8_t>(speed & 0xFF),
-        static_cast<uint8_t>((speed >> 8) & 0xFF),
-        static_cast<uint8_t>((speed >> 16) & 0xFF),
-        static_cast<uint8_t>((speed >> 24) & 0xFF)
-    };
-    
-    return sendCommand(0x0C, DataType::SignedInt32, OperationType::Assign, payload);
+    return m_controller->set<Video::ShutterSpeed>(static_cast<int32_t>(speed));
 }
 
 bool VideoControl::getShutterSpeed(uint32_t& speed) const {
-    auto param = m_controller->getParameter(Category::Video, 0x0C);
-    
-    if (!param) {
+    int32_t value;
+    if (!m_controller->tryGet<Video::ShutterSpeed>(value)) {
         return false;
     }
     
-    speed = static_cast<uint32_t>(param->toInteger());
+    speed = static_cast<uint32_t>(value);
     return true;
 }
 
 bool VideoControl::setISO(uint32_t iso) {
-    // Create payload (32-bit integer, little-endian)
-    std::vector<uint8_t> payload = {
-        static_cast<uint8_t>(iso & 0xFF),
-        static_cast<uint8_t>((iso >> 8) & 0xFF),
-        static_cast<uint8_t>((iso >> 16) & 0xFF),
-        static_cast<uint8_t>((iso >> 24) & 0xFF)
-    };
-    
-    return sendCommand(0x0E, DataType::SignedInt32, OperationType::Assign, payload);
+    return m_controller->set<Video::ISO>(static_cast<int32_t>(iso));
 }
 
 bool VideoControl::getISO(uint32_t& iso) const {
-    auto param = m_controller->getParameter(Category::Video, 0x0E);
-    
-    if (!param) {
+    int32_t value;
+    if (!m_controller->tryGet<Video::ISO>(value)) {
         return false;
     }
     
-    iso = static_cast<uint32_t>(param->toInteger());
+    iso = static_cast<uint32_t>(value);
     return true;
 }
 
 bool VideoControl::setGain(int8_t gainDB) {
-    // Create payload (single byte)
-    std::vector<uint8_t> payload = { static_cast<uint8_t>(gainDB) };
-    
-    return sendCommand(0x0D, DataType::SignedByte, OperationType::Assign, payload);
+    return m_controller->set<Video::Gain>(gainDB);
 }
 
 bool VideoControl::getGain(int8_t& gainDB) const {
-    auto param = m_controller->getParameter(Category::Video, 0x0D);
-    
-    if (!param) {
-        return false;
-    }
-    
-    int64_t value = param->toInteger();
-    // Ensure it fits in int8_t range
-    if (value < -128 || value > 127) {
-        return false;
-    }
-    
-    gainDB = static_cast<int8_t>(value);
-    return true;
+    return m_controller->tryGet<Video::Gain>(gainDB);
 }
 
 bool VideoControl::setNDFilter(float stop) {
@@ -382,31 +267,21 @@ std::optional<VideoControl::NDFilterDisplayMode> VideoControl::getNDFilterDispla
 }
 
 bool VideoControl::setDisplayLUT(const LUTSettings& settings) {
-    // Create payload (2 bytes)
-    std::vector<uint8_t> payload = {
-        static_cast<uint8_t>(settings.selectedLUT),
-        static_cast<uint8_t>(settings.enabled ? 1 : 0)
-    };
-    
-    return sendCommand(0x0F, DataType::SignedByte, OperationType::Assign, payload);
+    return m_controller->set<Video::DisplayLUT>({
+        static_cast<int8_t>(settings.selectedLUT),
+        static_cast<int8_t>(settings.enabled ? 1 : 0)
+    });
 }
 
 std::optional<VideoControl::LUTSettings> VideoControl::getDisplayLUT() const {
-    auto param = m_controller->getParameter(Category::Video, 0x0F);
-    
-    if (!param || param->data.size() < 2) {
+    Video::DisplayLUT::Value values;
+    if (!m_controller->tryGet<Video::DisplayLUT>(values) || values[0] < 0 || values[0] > 3) {
         return std::nullopt;
     }
     
     LUTSettings settings;
-    
-    uint8_t lutValue = param->data[0];
-    if (lutValue > 3) {
-        return std::nullopt;
-    }
-    
-    settings.selectedLUT = static_cast<DisplayLUT>(lutValue);
-    settings.enabled = param->data[1] != 0;
+    settings.selectedLUT = static_cast<DisplayLUT>(values[0]);
+    settings.enabled = values[1] != 0;
     
     return settings;
 }
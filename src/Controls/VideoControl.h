@@ -7,9 +7,9 @@
 #include <vector>
 #include "../Protocol/ProtocolConstants.h"
 
-namespace BMDCamera {
+class BMDBLEController; // Forward declaration; the controller is not in the namespace
 
-class BMDBLEController; // Forward declaration
+namespace BMDCamera {
 
 class VideoControl {
 public:
@@ -0,0 +1,198 @@
+#include "Metrics.h"
+#include <cstdio>
+
+namespace BMDCamera {
+
+namespace {
+    constexpr const char* COUNTER_NAMES[COUNTER_COUNT] = {
+        "packets_incoming_control", "packets_timecode", "packets_camera_status",
+        "packets_rejected", "duplicates_suppressed", "callbacks_deferred",
+        "callbacks_dropped", "slow_callbacks", "commands_sent", "commands_coalesced",
+        "commands_dropped", "connection_attempts", "reconnects"
+    };
+
+    constexpr const char* GAUGE_NAMES[GAUGE_COUNT] = {
+        "scheduled_commands", "free_heap", "heap_low_water"
+    };
+
+    constexpr const char* HISTOGRAM_NAMES[HISTOGRAM_COUNT] = {
+        "callback_us"
+    };
+
+    size_t bucketFor(uint32_t value) {
+        size_t bucket = 0;
+        while (value != 0 && bucket < HISTOGRAM_BUCKETS - 1) {
+            value >>= 1;
+            bucket++;
+        }
+        return bucket;
+    }
+
+    // Raise target to value if it is lower
+    template <typename T>
+    void storeMax(std::atomic<T>& target, T value) {
+        T current = target.load(std::memory_order_relaxed);
+        while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    template <typename T>
+    void storeMin(std::atomic<T>& target, T value) {
+        T current = target.load(std::memory_order_relaxed);
+        while (value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+}
+
+uint32_t HistogramSnapshot::percentile(uint8_t percent) const {
+    if (count == 0) {
+        return 0;
+    }
+
+    uint64_t threshold = (static_cast<uint64_t>(count) * percent + 99) / 100;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        seen += buckets[i];
+        if (seen >= threshold && buckets[i] > 0) {
+            if (i == HISTOGRAM_BUCKETS - 1) {
+                return max; // Open-ended bucket
+            }
+            uint32_t upper = i == 0 ? 0 : (1u << i) - 1;
+            return upper < max ? upper : max;
+        }
+    }
+    return max;
+}
+
+MetricsRegistry& MetricsRegistry::instance() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+void MetricsRegistry::setGauge(Gauge gauge, int32_t value) {
+    AtomicGauge& g = m_gauges[static_cast<size_t>(gauge)];
+    g.value.store(value, std::memory_order_relaxed);
+    storeMin(g.min, value);
+    storeMax(g.max, value);
+    g.set.store(true, std::memory_order_relaxed);
+}
+
+void MetricsRegistry::record(Histogram histogram, uint32_t value) {
+    AtomicHistogram& h = m_histograms[static_cast<size_t>(histogram)];
+    h.count.fetch_add(1, std::memory_order_relaxed);
+    storeMax(h.max, value);
+
+    // Carry into the high word when the low word wraps
+    uint32_t previous = h.sumLow.fetch_add(value, std::memory_order_relaxed);
+    if (previous + value < previous) {
+        h.sumHigh.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    h.buckets[bucketFor(value)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void MetricsRegistry::snapshot(MetricsSnapshot& out) const {
+    out.timestampMs = millis();
+
+    for (size_t i = 0; i < COUNTER_COUNT; i++) {
+        out.counters[i] = m_counters[i].load(std::memory_order_relaxed);
+    }
+
+    for (size_t i = 0; i < GAUGE_COUNT; i++) {
+        const AtomicGauge& g = m_gauges[i];
+        GaugeSnapshot& s = out.gauges[i];
+        s.set = g.set.load(std::memory_order_relaxed);
+        s.value = g.value.load(std::memory_order_relaxed);
+        s.min = s.set ? g.min.load(std::memory_order_relaxed) : 0;
+        s.max = s.set ? g.max.load(std::memory_order_relaxed) : 0;
+    }
+
+    for (size_t i = 0; i < HISTOGRAM_COUNT; i++) {
+        const AtomicHistogram& h = m_histograms[i];
+        HistogramSnapshot& s = out.histograms[i];
+        s.count = h.count.load(std::memory_order_relaxed);
+        s.max = h.max.load(std::memory_order_relaxed);
+        s.sum = (static_cast<uint64_t>(h.sumHigh.load(std::memory_order_relaxed)) << 32) |
+                h.sumLow.load(std::memory_order_relaxed);
+        for (size_t b = 0; b < HISTOGRAM_BUCKETS; b++) {
+            s.buckets[b] = h.buckets[b].load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void MetricsRegistry::reset() {
+    for (auto& counter : m_counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+
+    // Gauges keep their current value but restart their water marks
+    for (auto& g : m_gauges) {
+        int32_t value = g.value.load(std::memory_order_relaxed);
+        bool set = g.set.load(std::memory_order_relaxed);
+        g.min.store(set ? value : INT32_MAX, std::memory_order_relaxed);
+        g.max.store(set ? value : INT32_MIN, std::memory_order_relaxed);
+    }
+
+    for (auto& h : m_histograms) {
+        h.count.store(0, std::memory_order_relaxed);
+        h.max.store(0, std::memory_order_relaxed);
+        h.sumLow.store(0, std::memory_order_relaxed);
+        h.sumHigh.store(0, std::memory_order_relaxed);
+        for (auto& bucket : h.buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+void MetricsRegistry::dump(Print& out) const {
+    MetricsSnapshot s;
+    snapshot(s);
+
+    char field[64];
+    snprintf(field, sizeof(field), "metrics,t=%lu", static_cast<unsigned long>(s.timestampMs));
+    out.print(field);
+
+    for (size_t i = 0; i < COUNTER_COUNT; i++) {
+        snprintf(field, sizeof(field), ",%s=%lu", COUNTER_NAMES[i], static_cast<unsigned long>(s.counters[i]));
+        out.print(field);
+    }
+
+    // Gauges as value/min/max
+    for (size_t i = 0; i < GAUGE_COUNT; i++) {
+        const GaugeSnapshot& g = s.gauges[i];
+        if (!g.set) {
+            continue;
+        }
+        snprintf(field, sizeof(field), ",%s=%ld/%ld/%ld", GAUGE_NAMES[i],
+                 static_cast<long>(g.value), static_cast<long>(g.min), static_cast<long>(g.max));
+        out.print(field);
+    }
+
+    // Histograms as count/mean/p99/max
+    for (size_t i = 0; i < HISTOGRAM_COUNT; i++) {
+        const HistogramSnapshot& h = s.histograms[i];
+        snprintf(field, sizeof(field), ",%s=%lu/%lu/%lu/%lu", HISTOGRAM_NAMES[i],
+                 static_cast<unsigned long>(h.count), static_cast<unsigned long>(h.mean()),
+                 static_cast<unsigned long>(h.percentile(99)), static_cast<unsigned long>(h.max));
+        out.print(field);
+    }
+
+    out.println();
+}
+
+const char* MetricsRegistry::counterName(Counter counter) {
+    size_t index = static_cast<size_t>(counter);
+    return index < COUNTER_COUNT ? COUNTER_NAMES[index] : "unknown";
+}
+
+const char* MetricsRegistry::gaugeName(Gauge gauge) {
+    size_t index = static_cast<size_t>(gauge);
+    return index < GAUGE_COUNT ? GAUGE_NAMES[index] : "unknown";
+}
+
+const char* MetricsRegistry::histogramName(Histogram histogram) {
+    size_t index = static_cast<size_t>(histogram);
+    return index < HISTOGRAM_COUNT ? HISTOGRAM_NAMES[index] : "unknown";
+}
+
+} // namespace BMDCamera
@@ -0,0 +1,141 @@
+#ifndef BMD_METRICS_H
+#define BMD_METRICS_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace BMDCamera {
+    enum class Counter : uint8_t {
+        PacketsIncomingControl,  // Notifications received per characteristic
+        PacketsTimecode,
+        PacketsCameraStatus,
+        PacketsRejected,         // Failed packet validation
+        DuplicatesSuppressed,    // Unchanged reports held back from subscribers
+        CallbacksDeferred,       // Reports queued for a deferred or worker subscriber
+        CallbacksDropped,        // Not queued because the executor's queue was full
+        SlowCallbacks,           // Callbacks that overran the time budget
+        CommandsSent,            // Accepted by the outgoing characteristic
+        CommandsCoalesced,       // Skipped because they repeated the last command
+        CommandsDropped,         // Refused because the link was down
+        ConnectionAttempts,
+        Reconnects,              // Successful connections after the first
+        Count
+    };
+
+    enum class Gauge : uint8_t {
+        ScheduledCommands,       // TimecodeScheduler queue depth
+        FreeHeap,                // Bytes
+        HeapLowWater,            // Lowest free heap since boot
+        Count
+    };
+
+    enum class Histogram : uint8_t {
+        CallbackMicros,          // Time spent in application notification callbacks
+        Count
+    };
+
+    constexpr size_t COUNTER_COUNT = static_cast<size_t>(Counter::Count);
+    constexpr size_t GAUGE_COUNT = static_cast<size_t>(Gauge::Count);
+    constexpr size_t HISTOGRAM_COUNT = static_cast<size_t>(Histogram::Count);
+
+    // Power-of-two buckets: bucket 0 holds 0, bucket n holds [2^(n-1), 2^n),
+    // and the last bucket everything from 2^(BUCKETS-2) up
+    constexpr size_t HISTOGRAM_BUCKETS = 18;
+
+    struct HistogramSnapshot {
+        uint32_t count = 0;
+        uint32_t max = 0;
+        uint64_t sum = 0;
+        uint32_t buckets[HISTOGRAM_BUCKETS] = {};
+
+        uint32_t mean() const { return count > 0 ? static_cast<uint32_t>(sum / count) : 0; }
+
+        // Upper bound of the bucket holding the given percentile (0-100)
+        uint32_t percentile(uint8_t percent) const;
+    };
+
+    struct GaugeSnapshot {
+        int32_t value = 0;
+        int32_t min = 0;
+        int32_t max = 0;
+        bool set = false;
+    };
+
+    // Point-in-time copy of every metric
+    struct MetricsSnapshot {
+        uint32_t timestampMs = 0;
+        uint32_t counters[COUNTER_COUNT] = {};
+        GaugeSnapshot gauges[GAUGE_COUNT];
+        HistogramSnapshot histograms[HISTOGRAM_COUNT];
+
+        uint32_t counter(Counter c) const { return counters[static_cast<size_t>(c)]; }
+        const GaugeSnapshot& gauge(Gauge g) const { return gauges[static_cast<size_t>(g)]; }
+        const HistogramSnapshot& histogram(Histogram h) const { return histograms[static_cast<size_t>(h)]; }
+    };
+
+    // Fixed-memory metrics shared by the whole pipeline. Updates are relaxed
+    // atomics, safe from BLE callbacks and other tasks; a snapshot is not a
+    // single atomic cut but each value in it is consistent.
+    class MetricsRegistry {
+    public:
+        static MetricsRegistry& instance();
+
+        void increment(Counter counter, uint32_t amount = 1) {
+            m_counters[static_cast<size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+        }
+
+        // Set a gauge, tracking its low and high water marks
+        void setGauge(Gauge gauge, int32_t value);
+
+        void record(Histogram histogram, uint32_t value);
+
+        void snapshot(MetricsSnapshot& out) const;
+        void reset();
+
+        // One compact line: "metrics,t=..,packets_incoming_control=..,..."
+        // with histograms as name=count/mean/p99/max
+        void dump(Print& out) const;
+
+        static const char* counterName(Counter counter);
+        static const char* gaugeName(Gauge gauge);
+        static const char* histogramName(Histogram histogram);
+
+    private:
+        struct AtomicGauge {
+            std::atomic<int32_t> value{0};
+            std::atomic<int32_t> min{INT32_MAX};
+            std::atomic<int32_t> max{INT32_MIN};
+            std::atomic<bool> set{false};
+        };
+
+        struct AtomicHistogram {
+            std::atomic<uint32_t> count{0};
+            std::atomic<uint32_t> max{0};
+            std::atomic<uint32_t> sumLow{0};   // 64-bit sum split for 32-bit targets
+            std::atomic<uint32_t> sumHigh{0};
+            std::atomic<uint32_t> buckets[HISTOGRAM_BUCKETS];
+        };
+
+        std::atomic<uint32_t> m_counters[COUNTER_COUNT] = {};
+        AtomicGauge m_gauges[GAUGE_COUNT];
+        AtomicHistogram m_histograms[HISTOGRAM_COUNT] = {};
+    };
+
+    // Records the lifetime of a scope into a histogram, in microseconds
+    class ScopedMetricsTimer {
+    public:
+        explicit ScopedMetricsTimer(Histogram histogram)
+            : m_histogram(histogram), m_startUs(micros()) {}
+        ~ScopedMetricsTimer() {
+            MetricsRegistry::instance().record(m_histogram, micros() - m_startUs);
+        }
+
+    private:
+        Histogram m_histogram;
+        uint32_t m_startUs;
+    };
+}
+
+#endif // BMD_METRICS_H
@@ -0,0 +1,232 @@
+#include "TraceLog.h"
+#include "../Protocol/HexCodec.h"
+#include <cstdio>
+
+namespace BMDCamera {
+
+namespace {
+    constexpr const char* EVENT_NAMES[TRACE_EVENT_COUNT] = {
+        "dropped", "device_found", "camera_found", "passkey_request",
+        "auth_success", "auth_failed", "notify", "slow_callback"
+    };
+
+    constexpr char LEVEL_LETTERS[] = "?EWID";
+
+    // Longest formatted line, including the terminator
+    constexpr size_t LINE_SIZE = 96;
+
+    // Unpack bytes stored with traceBytes()
+    void unpackBytes(const uint32_t* args, uint8_t* out, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            out[i] = static_cast<uint8_t>(args[i / 4] >> (8 * (i % 4)));
+        }
+    }
+}
+
+TraceLog& TraceLog::instance() {
+    static TraceLog log;
+    return log;
+}
+
+TraceLog::TraceLog() {
+    for (size_t i = 0; i < CAPACITY; i++) {
+        m_slots[i].sequence.store(static_cast<uint32_t>(i), std::memory_order_relaxed);
+    }
+}
+
+bool TraceLog::write(TraceLevel level, TraceEvent event, uint32_t a, uint32_t b, uint32_t c) {
+    // Claim a slot. Each slot's sequence says whose turn it is: equal to the
+    // position when free for that write, position + 1 once it holds a record.
+    uint32_t position = m_head.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+        slot = &m_slots[position & (CAPACITY - 1)];
+        uint32_t sequence = slot->sequence.load(std::memory_order_acquire);
+        int32_t difference = static_cast<int32_t>(sequence - position);
+        if (difference == 0) {
+            if (m_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            // The consumer hasn't freed this slot yet: the ring is full
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            position = m_head.load(std::memory_order_relaxed);
+        }
+    }
+
+    TraceRecord& record = slot->record;
+    record.timestampUs = micros();
+    record.event = event;
+    record.level = static_cast<uint8_t>(level);
+    record.reserved = 0;
+    record.args[0] = a;
+    record.args[1] = b;
+    record.args[2] = c;
+
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+bool TraceLog::read(TraceRecord& record) {
+    Slot& slot = m_slots[m_tail & (CAPACITY - 1)];
+    uint32_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (static_cast<int32_t>(sequence - (m_tail + 1)) < 0) {
+        return false;
+    }
+
+    record = slot.record;
+    slot.sequence.store(m_tail + CAPACITY, std::memory_order_release);
+    m_tail++;
+    return true;
+}
+
+size_t TraceLog::drain(Print& out, TraceFormat format, size_t maxRecords) {
+    uint32_t dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped != m_reportedDropped) {
+        TraceRecord record = {};
+        record.timestampUs = micros();
+        record.event = TRACE_DROPPED;
+        record.level = static_cast<uint8_t>(TraceLevel::Warn);
+        record.args[0] = dropped - m_reportedDropped;
+        output(out, format, record);
+        m_reportedDropped = dropped;
+    }
+
+    size_t written = 0;
+    TraceRecord record;
+    while (written < maxRecords && read(record)) {
+        output(out, format, record);
+        written++;
+    }
+    return written;
+}
+
+void TraceLog::output(Print& out, TraceFormat outputFormat, const TraceRecord& record) {
+    if (outputFormat == TraceFormat::Binary) {
+        uint8_t frame[FRAME_SIZE];
+        frame[0] = FRAME_SYNC_0;
+        frame[1] = FRAME_SYNC_1;
+        memcpy(frame + 2, &record, sizeof(record));
+        uint8_t checksum = 0;
+        for (size_t i = 0; i < sizeof(record); i++) {
+            checksum += frame[2 + i];
+        }
+        frame[FRAME_SIZE - 1] = checksum;
+        out.write(frame, sizeof(frame));
+        return;
+    }
+
+    char line[LINE_SIZE];
+    format(record, line, sizeof(line));
+    out.println(line);
+}
+
+size_t TraceLog::format(const TraceRecord& record, char* buffer, size_t size) {
+    if (buffer == nullptr || size == 0) {
+        return 0;
+    }
+
+    char level = record.level < sizeof(LEVEL_LETTERS) - 1 ? LEVEL_LETTERS[record.level] : '?';
+    int written = snprintf(buffer, size, "%10lu %c %s", static_cast<unsigned long>(record.timestampUs),
+                           level, eventName(record.event));
+    if (written < 0 || static_cast<size_t>(written) >= size) {
+        return written < 0 ? 0 : size - 1;
+    }
+
+    char* cursor = buffer + written;
+    size_t remaining = size - written;
+    const uint32_t* args = record.args;
+    uint8_t bytes[6];
+
+    switch (record.event) {
+        case TRACE_DROPPED:
+            written = snprintf(cursor, remaining, " count=%lu", static_cast<unsigned long>(args[0]));
+            break;
+        case TRACE_DEVICE_FOUND:
+        case TRACE_CAMERA_FOUND:
+            if (remaining < 2) {
+                written = 0;
+                break;
+            }
+            unpackBytes(args, bytes, 6);
+            *cursor++ = ' ';
+            remaining--;
+            written = static_cast<int>(HexCodec::encode(bytes, 6, cursor, remaining, ':'));
+            if (record.event == TRACE_DEVICE_FOUND) {
+                cursor += written;
+                remaining -= written;
+                written = snprintf(cursor, remaining, " rssi=%ld", static_cast<long>(static_cast<int32_t>(args[2])));
+            }
+            break;
+        case TRACE_PASSKEY_REQUEST:
+            written = snprintf(cursor, remaining, " pin=%lu", static_cast<unsigned long>(args[0]));
+            break;
+        case TRACE_AUTH_FAILED:
+            written = snprintf(cursor, remaining, " reason=%lu", static_cast<unsigned long>(args[0]));
+            break;
+        case TRACE_NOTIFY: {
+            size_t count = args[1] < 4 ? args[1] : 4;
+            written = snprintf(cursor, remaining, " source=%lu length=%lu data=",
+                               static_cast<unsigned long>(args[0]), static_cast<unsigned long>(args[1]));
+            if (written > 0 && static_cast<size_t>(written) < remaining) {
+                cursor += written;
+                remaining -= written;
+                unpackBytes(&args[2], bytes, count);
+                written = static_cast<int>(HexCodec::encode(bytes, count, cursor, remaining, '\0'));
+            }
+            break;
+        }
+        case TRACE_SLOW_CALLBACK:
+            written = snprintf(cursor, remaining, " subscription=%lu us=%lu budget=%lu", static_cast<unsigned long>(args[0]),
+                               static_cast<unsigned long>(args[1]), static_cast<unsigned long>(args[2]));
+            break;
+        case TRACE_AUTH_SUCCESS:
+            written = 0;
+            break;
+        default:
+            written = snprintf(cursor, remaining, " %08lx %08lx %08lx", static_cast<unsigned long>(args[0]),
+                               static_cast<unsigned long>(args[1]), static_cast<unsigned long>(args[2]));
+            break;
+    }
+
+    if (written < 0) {
+        written = 0;
+    }
+    size_t total = static_cast<size_t>(cursor - buffer) + static_cast<size_t>(written);
+    return total < size ? total : size - 1;
+}
+
+const char* TraceLog::eventName(uint8_t event) {
+    return event < TRACE_EVENT_COUNT ? EVENT_NAMES[event] : "unknown";
+}
+
+bool TraceLog::startDrainTask(Print& out, TraceFormat format, uint32_t idleDelayMs) {
+    bool expected = false;
+    if (!m_drainStarted.compare_exchange_strong(expected, true)) {
+        return true; // Already running
+    }
+
+    m_drainOutput = &out;
+    m_drainFormat = format;
+    m_drainIdleMs = idleDelayMs > 0 ? idleDelayMs : 1;
+
+    // Idle priority: records are only formatted when nothing else wants the CPU
+    if (xTaskCreate(drainTask, "bmd_trace", 3072, this, tskIDLE_PRIORITY, nullptr) != pdPASS) {
+        m_drainStarted.store(false);
+        return false;
+    }
+    return true;
+}
+
+void TraceLog::drainTask(void* param) {
+    TraceLog* log = static_cast<TraceLog*>(param);
+    for (;;) {
+        if (log->drain(*log->m_drainOutput, log->m_drainFormat) == 0) {
+            vTaskDelay(pdMS_TO_TICKS(log->m_drainIdleMs));
+        }
+    }
+}
+
+} // namespace BMDCamera
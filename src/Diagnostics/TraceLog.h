@@ -0,0 +1,160 @@
+#ifndef BMD_TRACE_LOG_H
+#define BMD_TRACE_LOG_H
+
+#include <Arduino.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+// Compile-time trace level. Calls above this level compile to nothing, so
+// define it (e.g. -DBMD_TRACE_LEVEL=BMD_TRACE_LEVEL_WARN) before including
+// the library to strip debug tracing from a build.
+#define BMD_TRACE_LEVEL_NONE 0
+#define BMD_TRACE_LEVEL_ERROR 1
+#define BMD_TRACE_LEVEL_WARN 2
+#define BMD_TRACE_LEVEL_INFO 3
+#define BMD_TRACE_LEVEL_DEBUG 4
+
+#ifndef BMD_TRACE_LEVEL
+#define BMD_TRACE_LEVEL BMD_TRACE_LEVEL_INFO
+#endif
+
+// Records held between drains; must be a power of two
+#ifndef BMD_TRACE_CAPACITY
+#define BMD_TRACE_CAPACITY 128
+#endif
+
+namespace BMDCamera {
+    enum class TraceLevel : uint8_t {
+        Error = BMD_TRACE_LEVEL_ERROR,
+        Warn = BMD_TRACE_LEVEL_WARN,
+        Info = BMD_TRACE_LEVEL_INFO,
+        Debug = BMD_TRACE_LEVEL_DEBUG
+    };
+
+    // Event ids. Values are part of the binary format read by
+    // tools/decode_trace.py; append new events and keep both in sync.
+    enum TraceEvent : uint8_t {
+        TRACE_DROPPED = 0,          // count (written by the drain, not callers)
+        TRACE_DEVICE_FOUND = 1,     // address bytes 0-3, address bytes 4-5, rssi
+        TRACE_CAMERA_FOUND = 2,     // address bytes 0-3, address bytes 4-5
+        TRACE_PASSKEY_REQUEST = 3,  // pin
+        TRACE_AUTH_SUCCESS = 4,
+        TRACE_AUTH_FAILED = 5,      // reason
+        TRACE_NOTIFY = 6,           // source, length, first 4 bytes
+        TRACE_SLOW_CALLBACK = 7,    // subscription id, elapsed us, budget us
+        TRACE_EVENT_COUNT
+    };
+
+    // One fixed-size record: no strings, nothing to format on the hot path
+    struct TraceRecord {
+        uint32_t timestampUs;
+        uint8_t event;
+        uint8_t level;
+        uint16_t reserved;
+        uint32_t args[3];
+    };
+
+    static_assert(sizeof(TraceRecord) == 20, "TraceRecord layout is part of the binary format");
+
+    // Pack up to four bytes into one argument, first byte lowest
+    inline uint32_t traceBytes(const uint8_t* data, size_t length) {
+        uint32_t packed = 0;
+        for (size_t i = 0; i < length && i < 4; i++) {
+            packed |= static_cast<uint32_t>(data[i]) << (8 * i);
+        }
+        return packed;
+    }
+
+    enum class TraceFormat : uint8_t {
+        Text,   // One human-readable line per record
+        Binary  // Framed records for tools/decode_trace.py
+    };
+
+    // Bounded lock-free trace buffer. Any task or callback may write; one
+    // consumer (the drain task or the sketch's loop) formats and outputs.
+    // Writes never block: when the ring is full the record is counted as
+    // dropped and discarded.
+    class TraceLog {
+    public:
+        static constexpr size_t CAPACITY = BMD_TRACE_CAPACITY;
+        static_assert((CAPACITY & (CAPACITY - 1)) == 0, "BMD_TRACE_CAPACITY must be a power of two");
+
+        // Binary framing: sync bytes, the record, then a sum of its bytes
+        static constexpr uint8_t FRAME_SYNC_0 = 0xBD;
+        static constexpr uint8_t FRAME_SYNC_1 = 0x7E;
+        static constexpr size_t FRAME_SIZE = 2 + sizeof(TraceRecord) + 1;
+
+        static TraceLog& instance();
+
+        TraceLog();
+
+        // Copy a record into the ring; false if it was full
+        bool write(TraceLevel level, TraceEvent event, uint32_t a = 0, uint32_t b = 0, uint32_t c = 0);
+
+        // Take the oldest record, if any (single consumer)
+        bool read(TraceRecord& record);
+
+        // Output up to maxRecords, reporting any drops first. Returns the
+        // number of records written.
+        size_t drain(Print& out, TraceFormat format = TraceFormat::Text, size_t maxRecords = CAPACITY);
+
+        // Drain from a low-priority task whenever the ring has records.
+        // Only one drain task runs; later calls change nothing.
+        bool startDrainTask(Print& out, TraceFormat format = TraceFormat::Text, uint32_t idleDelayMs = 20);
+
+        uint32_t getDropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+        // Format a record as text; returns the characters written
+        static size_t format(const TraceRecord& record, char* buffer, size_t size);
+        static const char* eventName(uint8_t event);
+
+    private:
+        struct Slot {
+            std::atomic<uint32_t> sequence;
+            TraceRecord record;
+        };
+
+        static void drainTask(void* param);
+        void output(Print& out, TraceFormat outputFormat, const TraceRecord& record);
+
+        std::array<Slot, CAPACITY> m_slots;
+        std::atomic<uint32_t> m_head{0};  // Next position to write
+        uint32_t m_tail = 0;              // Next position to read (consumer only)
+        std::atomic<uint32_t> m_dropped{0};
+        uint32_t m_reportedDropped = 0;
+
+        Print* m_drainOutput = nullptr;
+        TraceFormat m_drainFormat = TraceFormat::Text;
+        uint32_t m_drainIdleMs = 20;
+        std::atomic<bool> m_drainStarted{false};
+    };
+}
+
+// Leveled trace macros: BMD_TRACE_INFO(BMDCamera::TRACE_NOTIFY, source, length)
+#if BMD_TRACE_LEVEL >= BMD_TRACE_LEVEL_ERROR
+#define BMD_TRACE_ERROR(...) BMDCamera::TraceLog::instance().write(BMDCamera::TraceLevel::Error, __VA_ARGS__)
+#else
+#define BMD_TRACE_ERROR(...) ((void)0)
+#endif
+
+#if BMD_TRACE_LEVEL >= BMD_TRACE_LEVEL_WARN
+#define BMD_TRACE_WARN(...) BMDCamera::TraceLog::instance().write(BMDCamera::TraceLevel::Warn, __VA_ARGS__)
+#else
+#define BMD_TRACE_WARN(...) ((void)0)
+#endif
+
+#if BMD_TRACE_LEVEL >= BMD_TRACE_LEVEL_INFO
+#define BMD_TRACE_INFO(...) BMDCamera::TraceLog::instance().write(BMDCamera::TraceLevel::Info, __VA_ARGS__)
+#else
+#define BMD_TRACE_INFO(...) ((void)0)
+#endif
+
+#if BMD_TRACE_LEVEL >= BMD_TRACE_LEVEL_DEBUG
+#define BMD_TRACE_DEBUG(...) BMDCamera::TraceLog::instance().write(BMDCamera::TraceLevel::Debug, __VA_ARGS__)
+#else
+#define BMD_TRACE_DEBUG(...) ((void)0)
+#endif
+
+#endif // BMD_TRACE_LOG_H
@@ -1,16 +1,18 @@
 #ifndef BMD_CALLBACK_INTERFACE_H
-#define BMD_CAMERA_CALLBACK_INTERFACE_H
+#define BMD_CALLBACK_INTERFACE_H
 
 #include <functional>
 #include <string>
+#include <vector>
 #include "../Protocol/ProtocolConstants.h"
 
 namespace BMDCamera {
     // Callback for connection state changes
     using ConnectionCallback = std::function<void(bool isConnected)>;
 
-    // Callback for parameter updates
-    using ParameterUpdateCallback = std::function<void(
+    // Callback for parameter reports (ParameterCache has its own
+    // ParameterUpdateCallback for schema parameters)
+    using ParameterDataCallback = std::function<void(
         Category category, 
         uint8_t parameterID, 
         const std::vector<uint8_t>& data
@@ -29,7 +31,7 @@ namespace BMDCamera {
             m_connectionCallback = std::move(cb);
         }
 
-        void setParameterUpdateCallback(ParameterUpdateCallback cb) {
+        void setParameterUpdateCallback(ParameterDataCallback cb) {
             m_parameterUpdateCallback = std::move(cb);
         }
 
@@ -72,7 +74,7 @@ namespace BMDCamera {
 
     private:
         ConnectionCallback m_connectionCallback;
-        ParameterUpdateCallback m_parameterUpdateCallback;
+        ParameterDataCallback m_parameterUpdateCallback;
         StatusUpdateCallback m_statusUpdateCallback;
         ErrorCallback m_errorCallback;
     };
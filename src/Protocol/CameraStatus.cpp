@@ -0,0 +1,76 @@
+#include "CameraStatus.h"
+
+namespace BMDCamera {
+
+bool CameraStatus::decode(const uint8_t* data, size_t length, CameraStatus& out) {
+    if (data == nullptr || length < 1) {
+        return false;
+    }
+
+    out.flags = data[0];
+    return true;
+}
+
+const char* CameraStatus::getFlagName(CameraStatusFlag flag) {
+    switch (flag) {
+        case STATUS_POWER_ON: return "Power";
+        case STATUS_CONNECTED: return "Connected";
+        case STATUS_PAIRED: return "Paired";
+        case STATUS_VERSIONS_CHECKED: return "Versions Checked";
+        case STATUS_INITIALISATION_COMPLETE: return "Initialisation Complete";
+        case STATUS_CAMERA_READY: return "Camera Ready";
+        default: return "Unknown";
+    }
+}
+
+uint8_t CameraStatusTracker::update(const CameraStatus& status) {
+    // The first report counts as a change from all bits clear
+    portENTER_CRITICAL(&m_lock);
+    uint8_t changed = status.flags ^ m_status.flags;
+    m_status = status;
+    m_known = true;
+    std::shared_ptr<const CameraStatusChangeCallback> callback = m_changeCallback;
+    portEXIT_CRITICAL(&m_lock);
+
+    if (changed != 0 && callback) {
+        (*callback)(changed, status);
+    }
+
+    return changed;
+}
+
+CameraStatus CameraStatusTracker::getStatus() const {
+    portENTER_CRITICAL(&m_lock);
+    CameraStatus status = m_status;
+    portEXIT_CRITICAL(&m_lock);
+    return status;
+}
+
+bool CameraStatusTracker::isKnown() const {
+    portENTER_CRITICAL(&m_lock);
+    bool known = m_known;
+    portEXIT_CRITICAL(&m_lock);
+    return known;
+}
+
+void CameraStatusTracker::reset() {
+    portENTER_CRITICAL(&m_lock);
+    m_status = CameraStatus();
+    m_known = false;
+    portEXIT_CRITICAL(&m_lock);
+}
+
+void CameraStatusTracker::setChangeCallback(CameraStatusChangeCallback cb) {
+    // Allocate outside the lock; the old callback is released after it,
+    // or by a call still running on the BLE task
+    std::shared_ptr<const CameraStatusChangeCallback> replacement;
+    if (cb) {
+        replacement = std::make_shared<const CameraStatusChangeCallback>(std::move(cb));
+    }
+
+    portENTER_CRITICAL(&m_lock);
+    m_changeCallback.swap(replacement);
+    portEXIT_CRITICAL(&m_lock);
+}
+
+} // namespace BMDCamera
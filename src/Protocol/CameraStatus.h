@@ -0,0 +1,71 @@
+#ifndef BMD_CAMERA_STATUS_H
+#define BMD_CAMERA_STATUS_H
+
+#include <Arduino.h>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace BMDCamera {
+    // Bits of the camera status characteristic
+    enum CameraStatusFlag : uint8_t {
+        STATUS_POWER_ON = 0x01,
+        STATUS_CONNECTED = 0x02,
+        STATUS_PAIRED = 0x04,
+        STATUS_VERSIONS_CHECKED = 0x08,
+        STATUS_INITIALISATION_COMPLETE = 0x10,
+        STATUS_CAMERA_READY = 0x20
+    };
+
+    // Decoded camera status
+    struct CameraStatus {
+        uint8_t flags = 0;
+
+        bool has(CameraStatusFlag flag) const { return (flags & flag) != 0; }
+        bool isPowerOn() const { return has(STATUS_POWER_ON); }
+        bool isConnected() const { return has(STATUS_CONNECTED); }
+        bool isPaired() const { return has(STATUS_PAIRED); }
+        bool isVersionsChecked() const { return has(STATUS_VERSIONS_CHECKED); }
+        bool isInitialisationComplete() const { return has(STATUS_INITIALISATION_COMPLETE); }
+        bool isCameraReady() const { return has(STATUS_CAMERA_READY); }
+
+        // Decode the first byte of a camera status notification
+        static bool decode(const uint8_t* data, size_t length, CameraStatus& out);
+
+        // Human-readable name for a single flag
+        static const char* getFlagName(CameraStatusFlag flag);
+    };
+
+    // Called with the bits that changed and the new status
+    using CameraStatusChangeCallback = std::function<void(uint8_t changedMask, const CameraStatus& status)>;
+
+    // Tracks the camera status and reports only the bits that change.
+    // Updated on the BLE task; the getters and setChangeCallback() may be
+    // called from any task.
+    class CameraStatusTracker {
+    public:
+        // Apply a new status; returns the mask of bits that changed
+        uint8_t update(const CameraStatus& status);
+
+        CameraStatus getStatus() const;
+
+        // False until the first notification has been seen
+        bool isKnown() const;
+
+        // Forget the status, e.g. on disconnect; the next report counts
+        // as a change from all bits clear
+        void reset();
+
+        // A call already running on the BLE task finishes with the old callback
+        void setChangeCallback(CameraStatusChangeCallback cb);
+
+    private:
+        CameraStatus m_status;
+        bool m_known = false;
+        std::shared_ptr<const CameraStatusChangeCallback> m_changeCallback; // Swapped under m_lock
+        mutable portMUX_TYPE m_lock = portMUX_INITIALIZER_UNLOCKED;
+    };
+}
+
+#endif // BMD_CAMERA_STATUS_H
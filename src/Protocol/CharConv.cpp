@@ -0,0 +1,242 @@
+#include "CharConv.h"
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace BMDCamera {
+
+namespace {
+    // Exact in a double up to 1e22
+    constexpr double POWERS_OF_TEN[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    constexpr int MAX_EXACT_POWER = 22;
+
+    // More significant digits than a float can use are dropped
+    constexpr uint64_t MANTISSA_LIMIT = 100000000000000000ULL;
+
+    // Exponents beyond this already saturate to zero or infinity
+    constexpr int EXPONENT_LIMIT = 9999;
+
+    constexpr uint8_t MAX_DECIMALS = 9;
+
+    bool isSpace(char c) {
+        return c == ' ' || (c >= '\t' && c <= '\r');
+    }
+
+    bool isDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    const char* skipSign(const char* p, const char* last, bool& negative) {
+        negative = false;
+        if (p < last && (*p == '+' || *p == '-')) {
+            negative = *p == '-';
+            p++;
+        }
+        return p;
+    }
+
+    size_t copyText(const char* text, char* out, size_t outSize) {
+        size_t length = strlen(text);
+        if (out == nullptr || length >= outSize) {
+            return 0;
+        }
+        memcpy(out, text, length + 1);
+        return length;
+    }
+
+    // Digits of value written backwards from end; returns the first digit
+    char* writeDigits(uint64_t value, char* end) {
+        do {
+            *--end = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+        return end;
+    }
+}
+
+CharConvResult CharConv::parseInteger(const char* first, const char* last, int64_t& value) {
+    if (first == nullptr || last < first) {
+        return { first, false };
+    }
+
+    const char* p = first;
+    while (p < last && isSpace(*p)) {
+        p++;
+    }
+
+    bool negative;
+    p = skipSign(p, last, negative);
+
+    const uint64_t limit = negative ? uint64_t(INT64_MAX) + 1 : uint64_t(INT64_MAX);
+    const char* digits = p;
+    uint64_t magnitude = 0;
+
+    while (p < last && isDigit(*p)) {
+        uint64_t digit = static_cast<uint64_t>(*p - '0');
+        if (magnitude > (limit - digit) / 10) {
+            return { first, false };
+        }
+        magnitude = magnitude * 10 + digit;
+        p++;
+    }
+
+    if (p == digits) {
+        return { first, false };
+    }
+
+    value = negative ? static_cast<int64_t>(0 - magnitude) : static_cast<int64_t>(magnitude);
+    return { p, true };
+}
+
+CharConvResult CharConv::parseFloat(const char* first, const char* last, float& value) {
+    if (first == nullptr || last < first) {
+        return { first, false };
+    }
+
+    const char* p = first;
+    while (p < last && isSpace(*p)) {
+        p++;
+    }
+
+    bool negative;
+    p = skipSign(p, last, negative);
+
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    bool anyDigits = false;
+
+    for (; p < last && isDigit(*p); p++) {
+        anyDigits = true;
+        if (mantissa < MANTISSA_LIMIT) {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+        } else {
+            exponent++;
+        }
+    }
+
+    if (p < last && *p == '.') {
+        p++;
+        for (; p < last && isDigit(*p); p++) {
+            anyDigits = true;
+            if (mantissa < MANTISSA_LIMIT) {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+                exponent--;
+            }
+        }
+    }
+
+    if (!anyDigits) {
+        return { first, false };
+    }
+
+    // The exponent is only consumed if it has digits ("2e" parses as 2)
+    if (p < last && (*p == 'e' || *p == 'E')) {
+        bool exponentNegative;
+        const char* e = skipSign(p + 1, last, exponentNegative);
+        if (e < last && isDigit(*e)) {
+            int written = 0;
+            for (; e < last && isDigit(*e); e++) {
+                if (written < EXPONENT_LIMIT) {
+                    written = written * 10 + (*e - '0');
+                }
+            }
+            exponent += exponentNegative ? -written : written;
+            p = e;
+        }
+    }
+
+    double result = static_cast<double>(mantissa);
+    while (exponent > 0 && result != 0.0 && result <= FLT_MAX) {
+        int step = exponent > MAX_EXACT_POWER ? MAX_EXACT_POWER : exponent;
+        result *= POWERS_OF_TEN[step];
+        exponent -= step;
+    }
+    while (exponent < 0 && result != 0.0) {
+        int step = -exponent > MAX_EXACT_POWER ? MAX_EXACT_POWER : -exponent;
+        result /= POWERS_OF_TEN[step];
+        exponent += step;
+    }
+
+    if (result > FLT_MAX) {
+        return { first, false };
+    }
+
+    float magnitude = static_cast<float>(result);
+    value = negative ? -magnitude : magnitude;
+    return { p, true };
+}
+
+size_t CharConv::formatInteger(int64_t value, char* out, size_t outSize) {
+    char digits[INTEGER_BUFFER];
+    char* end = digits + sizeof(digits);
+    uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    char* start = writeDigits(magnitude, end);
+    if (value < 0) {
+        *--start = '-';
+    }
+
+    size_t length = static_cast<size_t>(end - start);
+    if (out == nullptr || length >= outSize) {
+        return 0;
+    }
+    memcpy(out, start, length);
+    out[length] = '\0';
+    return length;
+}
+
+size_t CharConv::formatFloat(float value, char* out, size_t outSize, uint8_t decimals) {
+    if (std::isnan(value)) {
+        return copyText("nan", out, outSize);
+    }
+    if (std::isinf(value)) {
+        return copyText(value < 0 ? "-inf" : "inf", out, outSize);
+    }
+    if (out == nullptr || outSize == 0) {
+        return 0;
+    }
+
+    decimals = decimals > MAX_DECIMALS ? MAX_DECIMALS : decimals;
+    double scaled = std::fabs(static_cast<double>(value)) * POWERS_OF_TEN[decimals];
+
+    // Beyond 2^63 the integer path can't hold the digits; snprintf doesn't
+    // allocate either, it is just slower
+    if (scaled >= 9.2e18) {
+        int length = snprintf(out, outSize, "%.*f", decimals, static_cast<double>(value));
+        return length > 0 && static_cast<size_t>(length) < outSize ? static_cast<size_t>(length) : 0;
+    }
+
+    uint64_t units = static_cast<uint64_t>(std::nearbyint(scaled));
+    uint64_t divisor = static_cast<uint64_t>(POWERS_OF_TEN[decimals]);
+
+    // Sign, up to 19 integer digits, point, fraction
+    char text[1 + 19 + 1 + MAX_DECIMALS];
+    char* end = text + sizeof(text);
+    char* start = end;
+
+    if (decimals > 0) {
+        uint64_t fraction = units % divisor;
+        for (uint8_t i = 0; i < decimals; i++) {
+            *--start = static_cast<char>('0' + fraction % 10);
+            fraction /= 10;
+        }
+        *--start = '.';
+    }
+    start = writeDigits(units / divisor, start);
+    if (std::signbit(value)) {
+        *--start = '-';
+    }
+
+    size_t length = static_cast<size_t>(end - start);
+    if (length >= outSize) {
+        return 0;
+    }
+    memcpy(out, start, length);
+    out[length] = '\0';
+    return length;
+}
+
+} // namespace BMDCamera
@@ -0,0 +1,42 @@
+#ifndef BMD_CHAR_CONV_H
+#define BMD_CHAR_CONV_H
+
+#include <cstdint>
+#include <cstddef>
+
+namespace BMDCamera {
+    // Where parsing stopped and whether a value was produced, like
+    // std::from_chars_result. On failure the output is left untouched.
+    struct CharConvResult {
+        const char* ptr;
+        bool ok;
+    };
+
+    // Number <-> text conversions for parameter values. Like std::from_chars
+    // and std::to_chars they never throw, allocate or consult the locale, so
+    // they work with exceptions disabled and from the real-time loop. (The
+    // ESP32 toolchain's <charconv> has no floating-point support.)
+    class CharConv {
+    public:
+        // Leading whitespace and a sign are accepted, as strtoll/strtof do.
+        // Fails on no digits or on overflow.
+        static CharConvResult parseInteger(const char* first, const char* last, int64_t& value);
+
+        // Decimal with optional fraction and exponent ("-1.5", "2e3").
+        // Fails on no digits or a result outside the float range.
+        static CharConvResult parseFloat(const char* first, const char* last, float& value);
+
+        // NUL-terminated decimal text. Returns the characters written,
+        // excluding the terminator, or 0 if the buffer is too small.
+        static size_t formatInteger(int64_t value, char* out, size_t outSize);
+
+        // Fixed notation with the given number of decimals, rounded to
+        // nearest ("%.*f"); "nan", "inf" and "-inf" for non-finite values.
+        static size_t formatFloat(float value, char* out, size_t outSize, uint8_t decimals = 6);
+
+        // Buffer size that holds any formatInteger() result
+        static constexpr size_t INTEGER_BUFFER = 21;
+    };
+}
+
+#endif // BMD_CHAR_CONV_H
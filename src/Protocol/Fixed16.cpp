@@ -0,0 +1,88 @@
+#include "Fixed16.h"
+#include <cmath>
+#include <cstring>
+
+namespace BMDCamera {
+
+namespace {
+    constexpr uint32_t FLOAT_ABS_MASK = 0x7FFFFFFFu;
+    constexpr uint32_t FLOAT_SIGN_SHIFT = 31;
+    constexpr uint32_t FLOAT_16_BITS = 0x41800000u;   // 16.0f
+    constexpr uint32_t FLOAT_INF_BITS = 0x7F800000u;
+
+    // Values converted per block when encoding into a byte payload
+    constexpr size_t ENCODE_BLOCK = 32;
+}
+
+size_t Fixed16::fromFloat(const float* __restrict in, int16_t* __restrict out, size_t count) {
+    uint32_t saturated = 0;
+
+    // Range and NaN checks are done on the float's bits with integer masks
+    // rather than float compares, which keeps the loop free of branches the
+    // vectoriser would otherwise have to preserve
+    for (size_t i = 0; i < count; i++) {
+        uint32_t bits;
+        std::memcpy(&bits, &in[i], sizeof(bits));
+
+        uint32_t magnitude = bits & FLOAT_ABS_MASK;
+        uint32_t outOfRange = magnitude >= FLOAT_16_BITS;   // |x| >= 16, inf or NaN
+        uint32_t notNan = magnitude <= FLOAT_INF_BITS;
+
+        // Zero anything out of range so the conversion below can't overflow
+        uint32_t inRangeBits = bits & (outOfRange - 1u);
+        float value;
+        std::memcpy(&value, &inRangeBits, sizeof(value));
+        int32_t raw = static_cast<int32_t>(value * SCALE + std::copysign(0.5f, value));
+
+        // Out of range: the limit matching the sign, or 0 for NaN
+        int32_t limit = static_cast<int32_t>(
+            (static_cast<uint32_t>(MAX_RAW) - 65535u * (bits >> FLOAT_SIGN_SHIFT)) * notNan);
+        int32_t mask = -static_cast<int32_t>(outOfRange);
+        raw = (raw & ~mask) | (limit & mask);
+
+        // Just below 16.0 rounds up to 32768
+        uint32_t overflow = raw > MAX_RAW;
+        raw -= static_cast<int32_t>(overflow);
+
+        saturated += (outOfRange & notNan) | overflow;
+        out[i] = static_cast<int16_t>(raw);
+    }
+
+    return saturated;
+}
+
+void Fixed16::toFloat(const int16_t* __restrict in, float* __restrict out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = static_cast<float>(in[i]) * (1.0f / SCALE);
+    }
+}
+
+size_t Fixed16::encode(const float* in, uint8_t* out, size_t count) {
+    size_t saturated = 0;
+    int16_t block[ENCODE_BLOCK];
+
+    // Convert through a small stack buffer so the conversion stays vectorised
+    for (size_t start = 0; start < count; start += ENCODE_BLOCK) {
+        size_t n = count - start < ENCODE_BLOCK ? count - start : ENCODE_BLOCK;
+        saturated += fromFloat(in + start, block, n);
+
+        uint8_t* dest = out + start * 2;
+        for (size_t i = 0; i < n; i++) {
+            uint16_t raw = static_cast<uint16_t>(block[i]);
+            dest[i * 2] = static_cast<uint8_t>(raw & 0xFF);
+            dest[i * 2 + 1] = static_cast<uint8_t>(raw >> 8);
+        }
+    }
+
+    return saturated;
+}
+
+void Fixed16::decode(const uint8_t* in, float* out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        int16_t raw = static_cast<int16_t>(
+            static_cast<uint16_t>(in[i * 2]) | (static_cast<uint16_t>(in[i * 2 + 1]) << 8));
+        out[i] = static_cast<float>(raw) * (1.0f / SCALE);
+    }
+}
+
+} // namespace BMDCamera
@@ -0,0 +1,47 @@
+#ifndef BMD_FIXED16_H
+#define BMD_FIXED16_H
+
+#include <cstdint>
+#include <cstddef>
+
+namespace BMDCamera {
+    // Conversions for the protocol's signed 5.11 fixed-point type. Values are
+    // rounded to the nearest step and saturated to the representable range
+    // (-16.0 to 15.9995) instead of wrapping; NaN encodes as zero.
+    class Fixed16 {
+    public:
+        static constexpr float SCALE = 2048.0f;
+        static constexpr int32_t MIN_RAW = -32768;
+        static constexpr int32_t MAX_RAW = 32767;
+
+        static int16_t fromFloat(float value) {
+            if (value != value) {
+                return 0;
+            }
+            float scaled = value * SCALE + (value < 0.0f ? -0.5f : 0.5f);
+            if (scaled >= MAX_RAW) {
+                return MAX_RAW;
+            }
+            if (scaled <= MIN_RAW) {
+                return MIN_RAW;
+            }
+            return static_cast<int16_t>(scaled);
+        }
+
+        static float toFloat(int16_t value) {
+            return static_cast<float>(value) * (1.0f / SCALE);
+        }
+
+        // Batch conversions, bit-identical to the scalar versions. The loops
+        // are branch-free so the compiler can vectorise them; in and out must
+        // not overlap. fromFloat() returns how many inputs were saturated.
+        static size_t fromFloat(const float* in, int16_t* out, size_t count);
+        static void toFloat(const int16_t* in, float* out, size_t count);
+
+        // Convert straight to and from a little-endian payload (2 bytes per value)
+        static size_t encode(const float* in, uint8_t* out, size_t count);
+        static void decode(const uint8_t* in, float* out, size_t count);
+    };
+}
+
+#endif // BMD_FIXED16_H
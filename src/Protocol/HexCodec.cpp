@@ -0,0 +1,115 @@
+#include "HexCodec.h"
+#include <array>
+
+namespace BMDCamera {
+
+namespace {
+    constexpr uint8_t NOT_HEX = 0xFF;
+
+    // "000102...ff": both characters for every byte value
+    constexpr std::array<char, 512> buildPairs() {
+        constexpr char DIGITS[] = "0123456789abcdef";
+        std::array<char, 512> pairs{};
+        for (size_t i = 0; i < 256; i++) {
+            pairs[i * 2] = DIGITS[i >> 4];
+            pairs[i * 2 + 1] = DIGITS[i & 0x0F];
+        }
+        return pairs;
+    }
+
+    // Nibble value for every character, NOT_HEX for non-digits
+    constexpr std::array<uint8_t, 256> buildNibbles() {
+        std::array<uint8_t, 256> nibbles{};
+        for (size_t i = 0; i < 256; i++) {
+            nibbles[i] = NOT_HEX;
+        }
+        for (uint8_t i = 0; i < 10; i++) {
+            nibbles['0' + i] = i;
+        }
+        for (uint8_t i = 0; i < 6; i++) {
+            nibbles['a' + i] = 10 + i;
+            nibbles['A' + i] = 10 + i;
+        }
+        return nibbles;
+    }
+
+    constexpr std::array<char, 512> HEX_PAIRS = buildPairs();
+    constexpr std::array<uint8_t, 256> HEX_NIBBLES = buildNibbles();
+
+    static_assert(HEX_PAIRS[0x00 * 2] == '0' && HEX_PAIRS[0xAF * 2 + 1] == 'f', "Hex pair table");
+    static_assert(HEX_NIBBLES['F'] == 15 && HEX_NIBBLES['g'] == NOT_HEX, "Hex nibble table");
+
+    inline uint8_t nibble(char c) {
+        return HEX_NIBBLES[static_cast<uint8_t>(c)];
+    }
+}
+
+size_t HexCodec::encode(const uint8_t* data, size_t length, char* out, size_t outSize, char separator) {
+    if (out == nullptr || outSize == 0) {
+        return 0;
+    }
+    if (data == nullptr) {
+        length = 0;
+    }
+
+    size_t stride = separator != '\0' ? 3 : 2;
+
+    // Whole bytes that fit, leaving room for the terminator
+    size_t fit = separator != '\0' ? outSize / 3 : (outSize - 1) / 2;
+    size_t count = length < fit ? length : fit;
+
+    char* cursor = out;
+    for (size_t i = 0; i < count; i++) {
+        const char* pair = &HEX_PAIRS[data[i] * 2];
+        cursor[0] = pair[0];
+        cursor[1] = pair[1];
+        cursor[2] = separator;
+        cursor += stride;
+    }
+
+    // The last separator becomes the terminator
+    if (count > 0 && stride == 3) {
+        cursor--;
+    }
+    *cursor = '\0';
+    return static_cast<size_t>(cursor - out);
+}
+
+size_t HexCodec::decode(const char* text, size_t length, uint8_t* out, size_t outSize) {
+    if (text == nullptr || out == nullptr) {
+        return 0;
+    }
+
+    // An odd number of digits means the first one stands alone
+    size_t digits = 0;
+    for (size_t i = 0; i < length; i++) {
+        digits += nibble(text[i]) != NOT_HEX;
+    }
+
+    size_t written = 0;
+    bool high = (digits & 1) == 0;
+    uint8_t value = 0;
+    for (size_t i = 0; i < length && written < outSize; i++) {
+        uint8_t n = nibble(text[i]);
+        if (n == NOT_HEX) {
+            continue;
+        }
+        if (high) {
+            value = static_cast<uint8_t>(n << 4);
+            high = false;
+        } else {
+            out[written++] = value | n;
+            value = 0;
+            high = true;
+        }
+    }
+
+    return written;
+}
+
+int HexCodec::digitValue(char c) {
+    uint8_t n = nibble(c);
+    return n == NOT_HEX ? -1 : n;
+}
+
+} // namespace BMDCamera
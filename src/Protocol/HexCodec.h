@@ -0,0 +1,34 @@
+#ifndef BMD_HEX_CODEC_H
+#define BMD_HEX_CODEC_H
+
+#include <cstdint>
+#include <cstddef>
+
+namespace BMDCamera {
+    // Table-driven hex conversion for trace and debug output. Everything
+    // writes into caller-supplied buffers: no allocation, no locale and no
+    // exceptions, so it is safe to call from notification callbacks.
+    class HexCodec {
+    public:
+        // Buffer size needed to encode length bytes as "ff ff ff" plus the
+        // terminator (or "ffffff" when no separator is used)
+        static constexpr size_t encodedSize(size_t length, bool separated = true) {
+            return length == 0 ? 1 : (separated ? length * 3 : length * 2 + 1);
+        }
+
+        // Write lowercase hex pairs, separated by separator unless it is '\0',
+        // and NUL-terminate. Stops at the last whole byte that fits. Returns
+        // the number of characters written, excluding the terminator.
+        static size_t encode(const uint8_t* data, size_t length, char* out, size_t outSize, char separator = ' ');
+
+        // Parse hex digits, skipping anything that isn't one (spaces, ':').
+        // An odd digit count is read as if padded with a leading zero.
+        // Returns the bytes written, which stops early if out is full.
+        static size_t decode(const char* text, size_t length, uint8_t* out, size_t outSize);
+
+        // Value of a single hex digit, or -1
+        static int digitValue(char c);
+    };
+}
+
+#endif // BMD_HEX_CODEC_H
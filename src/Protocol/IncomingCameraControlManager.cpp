@@ -1,7 +1,10 @@
 // src/Protocol/IncomingCameraControlManager.cpp
 #include "IncomingCameraControlManager.h"
 #include "ProtocolUtils.h"
+#include "CharConv.h"
+#include "../Diagnostics/Metrics.h"
 #include <algorithm>
+#include <cstring>
 
 namespace BMDCamera {
 
@@ -12,6 +15,7 @@ IncomingCameraControlManager::IncomingCameraControlManager(CallbackManager* call
 void IncomingCameraControlManager::processIncomingPacket(const uint8_t* data, size_t length) {
     // Validate the packet first
     if (!validatePacket(data, length)) {
+        MetricsRegistry::instance().increment(Counter::PacketsRejected);
         return;
     }
     
@@ -26,10 +30,12 @@ void IncomingCameraControlManager::processIncomingPacket(const uint8_t* data, si
         return;
     }
     
-    // Extract the data payload (starting from byte 8)
+    // Extract the data payload (starting from byte 8). The declared length
+    // excludes the padding to 4 bytes, which must not be read as data.
     std::vector<uint8_t> payload;
-    if (length > 8) {
-        payload.assign(data + 8, data + length);
+    size_t payloadEnd = 4 + static_cast<size_t>(data[1]);
+    if (payloadEnd > 8) {
+        payload.assign(data + 8, data + payloadEnd);
     }
     
     // Create parameter data
@@ -43,7 +49,7 @@ void IncomingCameraControlManager::processIncomingPacket(const uint8_t* data, si
     
     // Notify callback if available
     if (m_callbackManager) {
-        m_callbackManager->onParameterUpdated(category, parameter, paramData);
+        m_callbackManager->notifyParameterUpdate(category, parameter, paramData.rawData);
     }
 }
 
@@ -103,14 +109,15 @@ std::vector<uint8_t> IncomingCameraControlManager::getParametersForCategory(Cate
 }
 
 uint64_t IncomingCameraControlManager::getCurrentTimestamp() const {
-    auto now = std::chrono::system_clock::now();
+    // Monotonic, so update times don't jump when the wall clock is set
+    auto now = std::chrono::steady_clock::now();
     return std::chrono::duration_cast<std::chrono::milliseconds>(
         now.time_since_epoch()).count();
 }
 
 bool IncomingCameraControlManager::validatePacket(const uint8_t* data, size_t length) const {
     // Basic packet validation
-    if (length < 8) {
+    if (data == nullptr || length < 8) {
         // Minimum packet size is 8 bytes (header + category + parameter + type + operation)
         return false;
     }
@@ -120,9 +127,11 @@ bool IncomingCameraControlManager::validatePacket(const uint8_t* data, size_t le
         return false;
     }
     
-    // Check packet length byte matches actual length
-    uint8_t declaredLength = data[1];
-    if (declaredLength != length - 2) {  // -2 because length byte doesn't include protocol ID and itself
+    // The length byte counts the command (category onwards) but not the
+    // 4-byte header or the padding to a multiple of 4 bytes. It must cover
+    // the command header and fit in the buffer with less than 4 bytes left.
+    size_t declaredLength = data[1];
+    if (declaredLength < 4 || 4 + declaredLength > length || length - (4 + declaredLength) > 3) {
         return false;
     }
     
@@ -137,26 +146,55 @@ bool IncomingCameraControlManager::validatePacket(const uint8_t* data, size_t le
 // Implementation of ParameterData conversion methods
 
 std::string IncomingCameraControlManager::ParameterData::toString() const {
+    if (dataType == DataType::String) {
+        return std::string(rawData.begin(), rawData.end());
+    }
+    
+    // Every other type fits a small stack buffer
+    char buffer[32];
+    toChars(buffer, sizeof(buffer));
+    return buffer;
+}
+
+size_t IncomingCameraControlManager::ParameterData::toChars(char* buffer, size_t size) const {
+    if (buffer == nullptr || size == 0) {
+        return 0;
+    }
+    
+    size_t written = 0;
     switch (dataType) {
         case DataType::String:
-            return std::string(rawData.begin(), rawData.end());
+            // Truncated to fit, always terminated
+            written = std::min(rawData.size(), size - 1);
+            if (written > 0) {
+                memcpy(buffer, rawData.data(), written);
+            }
+            break;
             
         case DataType::SignedByte:
         case DataType::SignedInt16:
         case DataType::SignedInt32:
         case DataType::SignedInt64:
-            return std::to_string(toInteger());
+            written = CharConv::formatInteger(toInteger(), buffer, size);
+            break;
             
         case DataType::Fixed16:
-            return std::to_string(toFloat());
+            written = CharConv::formatFloat(toFloat(), buffer, size);
+            break;
             
-        case DataType::Boolean:
-        case DataType::Void:
-            return toBoolean() ? "true" : "false";
+        case DataType::Void: {
+            const char* text = toBoolean() ? "true" : "false";
+            written = std::min(strlen(text), size - 1);
+            memcpy(buffer, text, written);
+            break;
+        }
             
         default:
-            return "";
+            break;
     }
+    
+    buffer[written] = '\0';
+    return written;
 }
 
 float IncomingCameraControlManager::ParameterData::toFloat() const {
@@ -174,17 +212,16 @@ float IncomingCameraControlManager::ParameterData::toFloat() const {
         case DataType::SignedInt64:
             return static_cast<float>(toInteger());
             
-        case DataType::Boolean:
         case DataType::Void:
             return toBoolean() ? 1.0f : 0.0f;
             
-        case DataType::String:
-            // Try to convert string to float
-            try {
-                return std::stof(toString());
-            } catch (...) {
-                return 0.0f;
-            }
+        case DataType::String: {
+            // Parsed in place; text that isn't a number reads as 0
+            float value = 0.0f;
+            const char* text = reinterpret_cast<const char*>(rawData.data());
+            CharConv::parseFloat(text, text + rawData.size(), value);
+            return value;
+        }
             
         default:
             return 0.0f;
@@ -210,9 +247,13 @@ int64_t IncomingCameraControlManager::ParameterData::toInteger() const {
             
         case DataType::SignedInt32:
             if (rawData.size() >= 4) {
+                // Assembled unsigned: rawData[3] << 24 overflows int
+                // once the top bit is set
                 int32_t value = static_cast<int32_t>(
-                    (rawData[0]) | (rawData[1] << 8) | 
-                    (rawData[2] << 16) | (rawData[3] << 24));
+                    static_cast<uint32_t>(rawData[0]) |
+                    (static_cast<uint32_t>(rawData[1]) << 8) |
+                    (static_cast<uint32_t>(rawData[2]) << 16) |
+                    (static_cast<uint32_t>(rawData[3]) << 24));
                 return static_cast<int64_t>(value);
             }
             break;
@@ -235,17 +276,16 @@ int64_t IncomingCameraControlManager::ParameterData::toInteger() const {
             }
             break;
             
-        case DataType::Boolean:
         case DataType::Void:
             return toBoolean() ? 1 : 0;
             
-        case DataType::String:
-            // Try to convert string to integer
-            try {
-                return std::stoll(toString());
-            } catch (...) {
-                return 0;
-            }
+        case DataType::String: {
+            // Parsed in place; text that isn't a number reads as 0
+            int64_t value = 0;
+            const char* text = reinterpret_cast<const char*>(rawData.data());
+            CharConv::parseInteger(text, text + rawData.size(), value);
+            return value;
+        }
     }
     
     return 0;
@@ -256,7 +296,7 @@ bool IncomingCameraControlManager::ParameterData::toBoolean() const {
         return false;
     }
     
-    // For boolean/void types, any non-zero value is true
+    // Booleans travel as void with one byte; any non-zero value is true
     return rawData[0] != 0;
 }
 
@@ -0,0 +1,142 @@
+#ifndef BMD_INPLACE_FUNCTION_H
+#define BMD_INPLACE_FUNCTION_H
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Bytes of captured state an InplaceFunction holds by default: enough for
+// a few pointers, or for a whole std::function
+#ifndef BMD_INPLACE_FUNCTION_SIZE
+#define BMD_INPLACE_FUNCTION_SIZE (sizeof(void*) * 4)
+#endif
+
+namespace BMDCamera {
+    template <typename Signature, size_t Capacity = BMD_INPLACE_FUNCTION_SIZE>
+    class InplaceFunction;
+
+    // A std::function that never allocates: the callable is stored in a
+    // fixed buffer inside the object, and one that doesn't fit is a
+    // compile error rather than a heap allocation. Copying and calling go
+    // through a per-type table of plain function pointers.
+    template <typename R, typename... Args, size_t Capacity>
+    class InplaceFunction<R(Args...), Capacity> {
+    public:
+        InplaceFunction() = default;
+        InplaceFunction(std::nullptr_t) {}
+
+        template <typename F, typename Callable = typename std::decay<F>::type,
+                  typename = typename std::enable_if<!std::is_same<Callable, InplaceFunction>::value>::type>
+        InplaceFunction(F&& callable) {
+            static_assert(sizeof(Callable) <= Capacity,
+                          "Callable is too large for InplaceFunction; capture less or raise the capacity");
+            static_assert(alignof(Callable) <= alignof(std::max_align_t),
+                          "Callable is over-aligned for InplaceFunction");
+            // A null function pointer or an empty std::function stays empty
+            if (isEmpty(callable)) {
+                return;
+            }
+            new (m_storage) Callable(std::forward<F>(callable));
+            m_ops = &Operations<Callable>::TABLE;
+        }
+
+        InplaceFunction(const InplaceFunction& other) {
+            if (other.m_ops != nullptr) {
+                other.m_ops->copy(m_storage, other.m_storage);
+                m_ops = other.m_ops;
+            }
+        }
+
+        InplaceFunction(InplaceFunction&& other) noexcept {
+            if (other.m_ops != nullptr) {
+                other.m_ops->move(m_storage, other.m_storage);
+                m_ops = other.m_ops;
+                other.reset();
+            }
+        }
+
+        ~InplaceFunction() { reset(); }
+
+        InplaceFunction& operator=(const InplaceFunction& other) {
+            if (this != &other) {
+                InplaceFunction copy(other);
+                *this = std::move(copy);
+            }
+            return *this;
+        }
+
+        InplaceFunction& operator=(InplaceFunction&& other) noexcept {
+            if (this != &other) {
+                reset();
+                if (other.m_ops != nullptr) {
+                    other.m_ops->move(m_storage, other.m_storage);
+                    m_ops = other.m_ops;
+                    other.reset();
+                }
+            }
+            return *this;
+        }
+
+        InplaceFunction& operator=(std::nullptr_t) {
+            reset();
+            return *this;
+        }
+
+        // Calling an empty function is a no-op returning R()
+        R operator()(Args... args) const {
+            if (m_ops == nullptr) {
+                return R();
+            }
+            return m_ops->invoke(const_cast<unsigned char*>(m_storage), std::forward<Args>(args)...);
+        }
+
+        explicit operator bool() const { return m_ops != nullptr; }
+
+    private:
+        struct Ops {
+            R (*invoke)(void* storage, Args&&... args);
+            void (*copy)(void* destination, const void* source);
+            void (*move)(void* destination, void* source);
+            void (*destroy)(void* storage);
+        };
+
+        template <typename Callable>
+        struct Operations {
+            static R invoke(void* storage, Args&&... args) {
+                return (*static_cast<Callable*>(storage))(std::forward<Args>(args)...);
+            }
+            static void copy(void* destination, const void* source) {
+                new (destination) Callable(*static_cast<const Callable*>(source));
+            }
+            static void move(void* destination, void* source) {
+                new (destination) Callable(std::move(*static_cast<Callable*>(source)));
+            }
+            static void destroy(void* storage) {
+                static_cast<Callable*>(storage)->~Callable();
+            }
+
+            static constexpr Ops TABLE = { invoke, copy, move, destroy };
+        };
+
+        template <typename T>
+        static bool isEmpty(const T&) { return false; }
+        template <typename T>
+        static bool isEmpty(T* pointer) { return pointer == nullptr; }
+        template <typename Signature>
+        static bool isEmpty(const std::function<Signature>& function) { return !function; }
+
+        void reset() {
+            if (m_ops != nullptr) {
+                m_ops->destroy(m_storage);
+                m_ops = nullptr;
+            }
+        }
+
+        alignas(std::max_align_t) unsigned char m_storage[Capacity];
+        const Ops* m_ops = nullptr;
+    };
+}
+
+#endif // BMD_INPLACE_FUNCTION_H
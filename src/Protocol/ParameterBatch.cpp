@@ -0,0 +1,142 @@
+#include "ParameterBatch.h"
+#include "../Diagnostics/Metrics.h"
+#include <cstring>
+
+namespace BMDCamera {
+
+void ParameterBatcher::setCallback(ParameterBatchCallback cb, uint32_t windowMs, bool coalesce, NotifyMode mode) {
+    // Allocate outside the lock; the old callback is released after it,
+    // or by a delivery still running on another task
+    std::shared_ptr<const ParameterBatchCallback> replacement;
+    if (cb) {
+        replacement = std::make_shared<const ParameterBatchCallback>(std::move(cb));
+    }
+
+    portENTER_CRITICAL(&m_lock);
+    m_callback.swap(replacement);
+    m_enabled.store(static_cast<bool>(m_callback));
+    m_windowMs = windowMs;
+    m_coalesce = coalesce;
+    m_mode = mode;
+    m_count = 0;
+    m_position.fill(NO_POSITION);
+    portEXIT_CRITICAL(&m_lock);
+}
+
+void ParameterBatcher::add(uint8_t category, uint8_t id, const uint8_t* payload, size_t length, bool changed, uint32_t nowMs) {
+    if (!m_enabled.load()) {
+        return;
+    }
+
+    int index = ParameterSchema::indexOf(category, id);
+    if (index < 0 || length > ParameterCache::MAX_PAYLOAD) {
+        return;
+    }
+
+    // Two passes at most: without a window a full batch is delivered
+    // early on this task and the change starts the next one
+    for (int attempt = 0; attempt < 2; attempt++) {
+        bool stored = true;
+
+        portENTER_CRITICAL(&m_lock);
+        if (!changed && m_mode == NotifyMode::ChangesOnly) {
+            portEXIT_CRITICAL(&m_lock);
+            return;
+        }
+        uint32_t windowMs = m_windowMs;
+        if (m_count == 0) {
+            m_openedMs = nowMs;
+        }
+
+        ParameterChange* change = nullptr;
+        if (m_coalesce && m_position[index] != NO_POSITION) {
+            change = &m_pending[m_position[index]];
+            m_coalesced.fetch_add(1, std::memory_order_relaxed);
+        } else if (m_count < CAPACITY) {
+            if (m_coalesce) {
+                m_position[index] = static_cast<uint8_t>(m_count);
+            }
+            change = &m_pending[m_count++];
+        } else {
+            stored = false;
+        }
+
+        if (change != nullptr) {
+            change->category = category;
+            change->id = id;
+            change->length = static_cast<uint8_t>(length);
+            if (length > 0) {
+                memcpy(change->payload, payload, length);
+            }
+        }
+        portEXIT_CRITICAL(&m_lock);
+
+        if (stored) {
+            return;
+        }
+        if (windowMs > 0 || !deliver()) {
+            break;
+        }
+    }
+
+    m_dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ParameterBatcher::endCycle() {
+    // The window is read under the lock, since setCallback() may change it
+    portENTER_CRITICAL(&m_lock);
+    bool due = m_windowMs == 0;
+    portEXIT_CRITICAL(&m_lock);
+
+    if (due) {
+        deliver();
+    }
+}
+
+void ParameterBatcher::poll(uint32_t nowMs) {
+    portENTER_CRITICAL(&m_lock);
+    bool due = m_windowMs > 0 && m_count > 0 && nowMs - m_openedMs >= m_windowMs;
+    portEXIT_CRITICAL(&m_lock);
+
+    if (due) {
+        deliver();
+    }
+}
+
+bool ParameterBatcher::deliver() {
+    portENTER_CRITICAL(&m_lock);
+    if (m_delivering) {
+        portEXIT_CRITICAL(&m_lock);
+        return false;
+    }
+    std::shared_ptr<const ParameterBatchCallback> callback = m_callback;
+    size_t count = m_count;
+    if (count > 0) {
+        m_delivering = true;
+        memcpy(m_delivery.data(), m_pending.data(), count * sizeof(ParameterChange));
+        if (m_coalesce) {
+            for (size_t i = 0; i < count; i++) {
+                m_position[ParameterSchema::indexOf(m_pending[i].category, m_pending[i].id)] = NO_POSITION;
+            }
+        }
+        m_count = 0;
+    }
+    portEXIT_CRITICAL(&m_lock);
+
+    if (count == 0) {
+        return true;
+    }
+
+    if (callback) {
+        m_batches.fetch_add(1, std::memory_order_relaxed);
+        ScopedMetricsTimer timer(Histogram::CallbackMicros);
+        (*callback)(m_delivery.data(), count);
+    }
+
+    portENTER_CRITICAL(&m_lock);
+    m_delivering = false;
+    portEXIT_CRITICAL(&m_lock);
+    return true;
+}
+
+} // namespace BMDCamera
@@ -0,0 +1,106 @@
+#ifndef BMD_PARAMETER_BATCH_H
+#define BMD_PARAMETER_BATCH_H
+
+#include <Arduino.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include "ParameterCache.h"
+#include "ParameterSubscriptions.h"
+
+// Changes held per batch; more arrive in a later batch or are dropped
+#ifndef BMD_PARAMETER_BATCH_CAPACITY
+#define BMD_PARAMETER_BATCH_CAPACITY 32
+#endif
+
+namespace BMDCamera {
+    // One reported parameter value in a batch
+    struct ParameterChange {
+        uint8_t category;
+        uint8_t id;
+        uint8_t length;
+        uint8_t payload[ParameterCache::MAX_PAYLOAD];
+
+        bool is(uint8_t cat, uint8_t parameterId) const { return category == cat && id == parameterId; }
+
+        // Decode through a typed descriptor; false for other parameters
+        template <typename P>
+        bool get(typename P::Value& value) const {
+            return is(P::CATEGORY, P::ID) && P::decode(payload, length, value);
+        }
+    };
+
+    // Receives every change of one batch, in arrival order
+    using ParameterBatchCallback = std::function<void(const ParameterChange* changes, size_t count)>;
+
+    // Collects parameter reports and hands them to the application in one
+    // call, so a state dump after a mode change means one UI refresh
+    // instead of dozens.
+    //
+    // With no window, a batch is everything one notification carried and
+    // is delivered from endCycle() on the ingest task. With a window, the
+    // first change opens the batch and poll() (the sketch's loop) delivers
+    // it once the window has passed; changes that don't fit by then are
+    // dropped and counted. Coalescing keeps only the latest value per
+    // parameter, in the position where it first appeared.
+    //
+    // setCallback() may be called from any task at any time, including
+    // from inside the callback; a delivery already running finishes with
+    // the callback it started with.
+    class ParameterBatcher {
+    public:
+        static constexpr size_t CAPACITY = BMD_PARAMETER_BATCH_CAPACITY;
+
+        void setCallback(ParameterBatchCallback cb, uint32_t windowMs = 0, bool coalesce = true,
+                         NotifyMode mode = NotifyMode::ChangesOnly);
+        bool isEnabled() const { return m_enabled.load(); }
+
+        // Ingest side: one stored report (see ParameterUpdateCallback)
+        void add(uint8_t category, uint8_t id, const uint8_t* payload, size_t length, bool changed, uint32_t nowMs);
+
+        // End of one notification; delivers the batch when there is no window
+        void endCycle();
+
+        // Deliver a windowed batch once it is due. Call from loop().
+        void poll(uint32_t nowMs);
+
+        uint32_t getBatchesDelivered() const { return m_batches.load(std::memory_order_relaxed); }
+        uint32_t getChangesCoalesced() const { return m_coalesced.load(std::memory_order_relaxed); }
+        uint32_t getChangesDropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    private:
+        static constexpr uint8_t NO_POSITION = 0xFF;
+        static_assert(CAPACITY < NO_POSITION, "Batch positions are stored in a uint8_t");
+
+        // Hand the pending batch to the callback. Returns false, leaving
+        // it pending, while another task is delivering.
+        bool deliver();
+
+        // Swapped under the lock and held by reference while it runs
+        std::shared_ptr<const ParameterBatchCallback> m_callback;
+        std::atomic<bool> m_enabled{false};
+        uint32_t m_windowMs = 0;
+        bool m_coalesce = true;
+        NotifyMode m_mode = NotifyMode::ChangesOnly;
+
+        // Filled by add() on the ingest task and copied out under the lock
+        // by the delivering task, so the callback runs without holding it.
+        // m_delivery belongs to whichever task set m_delivering.
+        std::array<ParameterChange, CAPACITY> m_pending{};
+        std::array<ParameterChange, CAPACITY> m_delivery{};
+        bool m_delivering = false;
+        std::array<uint8_t, PARAMETER_COUNT> m_position{};
+        size_t m_count = 0;
+        uint32_t m_openedMs = 0;
+        portMUX_TYPE m_lock = portMUX_INITIALIZER_UNLOCKED;
+
+        std::atomic<uint32_t> m_batches{0};
+        std::atomic<uint32_t> m_coalesced{0};
+        std::atomic<uint32_t> m_dropped{0};
+    };
+}
+
+#endif // BMD_PARAMETER_BATCH_H
@@ -0,0 +1,210 @@
+#include "ParameterCache.h"
+#include <cstring>
+
+namespace BMDCamera {
+
+namespace {
+    // Compile-time check that every fixed payload fits in a slot
+    constexpr size_t largestPayload() {
+        size_t largest = 0;
+        for (size_t i = 0; i < PARAMETER_COUNT; i++) {
+            size_t size = PARAMETER_TABLE[i].payloadSize();
+            largest = size > largest ? size : largest;
+        }
+        return largest;
+    }
+
+    static_assert(largestPayload() <= ParameterCache::MAX_PAYLOAD,
+                  "ParameterCache slots are too small for the schema");
+
+    // Bytes before the first command: identifier, length, command id, reserved
+    constexpr size_t PACKET_PREFIX = 4;
+    // Category, parameter, data type, operation
+    constexpr size_t COMMAND_HEADER = 4;
+}
+
+size_t ParameterCache::update(const uint8_t* packet, size_t length) {
+    if (packet == nullptr) {
+        return 0;
+    }
+
+    size_t stored = 0;
+    size_t offset = 0;
+
+    // Packets are padded to 4 bytes and may be sent back to back
+    while (offset + PACKET_PREFIX + COMMAND_HEADER <= length) {
+        const uint8_t* command = packet + offset;
+        size_t commandLength = command[1];
+        if (commandLength < COMMAND_HEADER || offset + PACKET_PREFIX + commandLength > length) {
+            break;
+        }
+
+        if (store(command[4], command[5], command[6],
+                  command + PACKET_PREFIX + COMMAND_HEADER, commandLength - COMMAND_HEADER)) {
+            stored++;
+        }
+
+        offset += (PACKET_PREFIX + commandLength + 3) & ~size_t(3);
+    }
+
+    return stored;
+}
+
+bool ParameterCache::store(uint8_t category, uint8_t id, uint8_t dataType, const uint8_t* payload, size_t length) {
+    int index = ParameterSchema::indexOf(category, id);
+    if (index < 0 || !caches(PARAMETER_TABLE[index]) || length > MAX_PAYLOAD ||
+        !ParameterSchema::validate(category, id, dataType, length)) {
+        return false;
+    }
+
+    uint64_t nowUs = m_clock != nullptr ? m_clock() : 0;
+
+    // Cameras re-report unchanged values constantly; compare before storing
+    portENTER_CRITICAL(&m_lock);
+    Entry& entry = m_entries[index];
+    bool changed = !entry.valid || entry.length != length ||
+                   (length > 0 && memcmp(entry.payload, payload, length) != 0);
+    if (changed) {
+        if (length > 0) {
+            memcpy(entry.payload, payload, length);
+        }
+        entry.length = static_cast<uint8_t>(length);
+        entry.valid = true;
+        entry.sequence = ++m_sequence;
+        entry.changedUs = nowUs;
+        touch(static_cast<size_t>(index));
+    } else {
+        m_unchanged++;
+    }
+    portEXIT_CRITICAL(&m_lock);
+
+    // Called unlocked with the caller's copy, which now equals the cached one
+    if (m_updateCallback) {
+        m_updateCallback(category, id, payload, length, changed);
+    }
+    return true;
+}
+
+void ParameterCache::touch(size_t index) {
+    uint8_t position = static_cast<uint8_t>(index);
+    if (m_newest == position) {
+        return;
+    }
+
+    Entry& entry = m_entries[index];
+    bool linked = entry.newer != NO_ENTRY || entry.older != NO_ENTRY || m_oldest == position;
+    if (linked) {
+        // Unlink; it isn't the newest, so it has a newer neighbour
+        m_entries[entry.newer].older = entry.older;
+        if (entry.older != NO_ENTRY) {
+            m_entries[entry.older].newer = entry.newer;
+        } else {
+            m_oldest = entry.newer;
+        }
+    }
+
+    entry.older = m_newest;
+    entry.newer = NO_ENTRY;
+    if (m_newest != NO_ENTRY) {
+        m_entries[m_newest].newer = position;
+    } else {
+        m_oldest = position;
+    }
+    m_newest = position;
+}
+
+uint32_t ParameterCache::getSequence() const {
+    portENTER_CRITICAL(&m_lock);
+    uint32_t sequence = m_sequence;
+    portEXIT_CRITICAL(&m_lock);
+    return sequence;
+}
+
+bool ParameterCache::getChangeInfo(uint8_t category, uint8_t id, uint32_t& sequence, uint64_t& changedUs) const {
+    int index = ParameterSchema::indexOf(category, id);
+    if (index < 0) {
+        return false;
+    }
+
+    portENTER_CRITICAL(&m_lock);
+    const Entry& entry = m_entries[index];
+    bool valid = entry.valid;
+    if (valid) {
+        sequence = entry.sequence;
+        changedUs = entry.changedUs;
+    }
+    portEXIT_CRITICAL(&m_lock);
+    return valid;
+}
+
+size_t ParameterCache::getChangesSince(uint32_t sequence, ChangedParameter* changes, size_t maxChanges) const {
+    if (changes == nullptr || maxChanges == 0) {
+        return 0;
+    }
+
+    // Walked and copied under the lock, so a store can't relink the list
+    // mid-walk. Back from the newest to the first change after sequence.
+    portENTER_CRITICAL(&m_lock);
+    uint8_t first = NO_ENTRY;
+    uint8_t position = m_newest;
+    while (position != NO_ENTRY) {
+        const Entry& entry = m_entries[position];
+        if (!entry.valid || entry.sequence <= sequence) {
+            break;
+        }
+        first = position;
+        position = entry.older;
+    }
+
+    size_t count = 0;
+    for (position = first; position != NO_ENTRY && count < maxChanges; position = m_entries[position].newer) {
+        const Entry& entry = m_entries[position];
+        const ParameterInfo& info = PARAMETER_TABLE[position];
+        changes[count++] = { info.category, info.id, entry.sequence, entry.changedUs };
+    }
+    portEXIT_CRITICAL(&m_lock);
+    return count;
+}
+
+bool ParameterCache::read(uint8_t category, uint8_t id, uint8_t* out, size_t& length) const {
+    int index = ParameterSchema::indexOf(category, id);
+    if (index < 0 || out == nullptr) {
+        return false;
+    }
+
+    portENTER_CRITICAL(&m_lock);
+    const Entry& entry = m_entries[index];
+    bool valid = entry.valid;
+    if (valid) {
+        length = entry.length;
+        memcpy(out, entry.payload, entry.length);
+    }
+    portEXIT_CRITICAL(&m_lock);
+    return valid;
+}
+
+bool ParameterCache::has(uint8_t category, uint8_t id) const {
+    int index = ParameterSchema::indexOf(category, id);
+    if (index < 0) {
+        return false;
+    }
+
+    portENTER_CRITICAL(&m_lock);
+    bool valid = m_entries[index].valid;
+    portEXIT_CRITICAL(&m_lock);
+    return valid;
+}
+
+void ParameterCache::clear() {
+    portENTER_CRITICAL(&m_lock);
+    for (Entry& entry : m_entries) {
+        entry.valid = false;
+        entry.newer = NO_ENTRY;
+        entry.older = NO_ENTRY;
+    }
+    m_newest = NO_ENTRY;
+    m_oldest = NO_ENTRY;
+    portEXIT_CRITICAL(&m_lock);
+}
+
+} // namespace BMDCamera
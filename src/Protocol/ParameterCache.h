@@ -0,0 +1,119 @@
+#ifndef BMD_PARAMETER_CACHE_H
+#define BMD_PARAMETER_CACHE_H
+
+#include <Arduino.h>
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <functional>
+#include "ParameterSchema.h"
+
+namespace BMDCamera {
+    // Called for every stored report with the cached payload. changed is
+    // false when the report repeated the cached value byte for byte.
+    using ParameterUpdateCallback = std::function<void(uint8_t category, uint8_t id, const uint8_t* payload, size_t length, bool changed)>;
+
+    // Monotonic time in microseconds (esp_timer_get_time() on device)
+    using ParameterClock = uint64_t (*)();
+
+    // A parameter changed since some sequence number, and when
+    struct ChangedParameter {
+        uint8_t category;
+        uint8_t id;
+        uint32_t sequence;   // Sequence number of its latest change
+        uint64_t changedUs;  // Clock time of that change
+    };
+
+    // Latest payload the camera reported for each parameter in the schema.
+    // Storage is one fixed slot per table entry, so updates never allocate.
+    // String parameters are not cached.
+    //
+    // Every change takes the next number of a cache-wide sequence and is
+    // stamped with the clock. The entries also form a list ordered by their
+    // last change, so getChangesSince() costs one step per changed
+    // parameter rather than a scan of the whole cache. Repeats of the
+    // cached value don't count as changes.
+    //
+    // Reads may run on any task while the BLE task stores reports: every
+    // read copies out under the cache's lock.
+    class ParameterCache {
+    public:
+        // Largest fixed payload in the schema (two int64 values)
+        static constexpr size_t MAX_PAYLOAD = 16;
+
+        // Store every command in an incoming control packet. Returns the
+        // number of commands cached; unknown or malformed ones are skipped.
+        size_t update(const uint8_t* packet, size_t length);
+
+        // Parameters the cache holds: every schema entry except strings.
+        // Only these reach the update callback.
+        static constexpr bool caches(const ParameterInfo& info) { return info.dataType != TYPE_STRING; }
+
+        // Store one payload after checking it against the schema
+        bool store(uint8_t category, uint8_t id, uint8_t dataType, const uint8_t* payload, size_t length);
+
+        // Copy the cached payload into out, which holds MAX_PAYLOAD bytes.
+        // False if nothing has been received.
+        bool read(uint8_t category, uint8_t id, uint8_t* out, size_t& length) const;
+        bool has(uint8_t category, uint8_t id) const;
+        void clear();
+
+        void setUpdateCallback(ParameterUpdateCallback cb) { m_updateCallback = std::move(cb); }
+
+        // Clock used to stamp changes; without one they are stamped 0
+        void setClock(ParameterClock clock) { m_clock = clock; }
+
+        // Sequence number of the latest change; 0 before the first
+        uint32_t getSequence() const;
+
+        // Sequence number and time of a parameter's latest change
+        bool getChangeInfo(uint8_t category, uint8_t id, uint32_t& sequence, uint64_t& changedUs) const;
+
+        // Parameters changed after sequence, oldest change first, at most
+        // maxChanges of them. To sync incrementally, pass the sequence of
+        // the last change received (or getSequence() after a full read);
+        // when the buffer fills, call again from the last one returned.
+        size_t getChangesSince(uint32_t sequence, ChangedParameter* changes, size_t maxChanges) const;
+
+        // Reports that repeated the cached value
+        uint32_t getUnchangedCount() const { return m_unchanged; }
+
+        // Decode a cached value through a typed descriptor (see Parameters.h)
+        template <typename P>
+        bool get(typename P::Value& value) const {
+            uint8_t payload[MAX_PAYLOAD];
+            size_t length = 0;
+            return read(P::CATEGORY, P::ID, payload, length) && P::decode(payload, length, value);
+        }
+
+    private:
+        static constexpr uint8_t NO_ENTRY = 0xFF;
+        static_assert(PARAMETER_COUNT < NO_ENTRY, "Change list links are stored in a uint8_t");
+
+        struct Entry {
+            uint8_t payload[MAX_PAYLOAD];
+            uint8_t length;
+            bool valid;
+            uint8_t newer = NO_ENTRY;   // Change list neighbours, by table index
+            uint8_t older = NO_ENTRY;
+            uint32_t sequence = 0;      // 0 until the first change
+            uint64_t changedUs = 0;
+        };
+
+        // Move an entry to the newest end of the change list, under m_lock
+        void touch(size_t index);
+
+        // Guards the entries, the change list and the sequence
+        mutable portMUX_TYPE m_lock = portMUX_INITIALIZER_UNLOCKED;
+
+        std::array<Entry, PARAMETER_COUNT> m_entries{};
+        uint8_t m_newest = NO_ENTRY;
+        uint8_t m_oldest = NO_ENTRY;
+        uint32_t m_sequence = 0;
+        uint32_t m_unchanged = 0;
+        ParameterUpdateCallback m_updateCallback;
+        ParameterClock m_clock = nullptr;
+    };
+}
+
+#endif // BMD_PARAMETER_CACHE_H
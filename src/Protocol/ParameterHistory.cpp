@@ -0,0 +1,244 @@
+#include "ParameterHistory.h"
+#include "Fixed16.h"
+
+namespace BMDCamera {
+
+namespace {
+    int64_t readSigned(const uint8_t* in, size_t size) {
+        uint64_t bits = 0;
+        for (size_t i = 0; i < size; i++) {
+            bits |= static_cast<uint64_t>(in[i]) << (8 * i);
+        }
+        // Sign-extend from the element's width
+        size_t unused = 64 - 8 * size;
+        return static_cast<int64_t>(bits << unused) >> unused;
+    }
+
+    float decodeElement(uint8_t dataType, const uint8_t* in) {
+        size_t size = detail::elementSize(dataType);
+        int64_t raw = readSigned(in, size);
+        return dataType == TYPE_FIXED16 ? Fixed16::toFloat(static_cast<int16_t>(raw)) : static_cast<float>(raw);
+    }
+
+    bool inWindow(uint32_t timeMs, uint32_t fromMs, uint32_t toMs) {
+        return static_cast<int32_t>(timeMs - fromMs) >= 0 && static_cast<int32_t>(toMs - timeMs) >= 0;
+    }
+}
+
+bool ParameterHistory::enable(uint8_t category, uint8_t id, size_t capacity, uint8_t element, NotifyMode mode) {
+    int index = ParameterSchema::indexOf(category, id);
+    if (index < 0 || capacity == 0) {
+        return false;
+    }
+
+    const ParameterInfo& info = PARAMETER_TABLE[index];
+    if (info.dataType == TYPE_STRING || element >= info.count) {
+        return false;
+    }
+
+    portENTER_CRITICAL(&m_lock);
+    bool ok = m_trackOf[index] == 0 && m_trackCount < MAX_TRACKS && capacity <= SAMPLE_BUDGET - m_allocated;
+    if (ok) {
+        Track& added = m_tracks[m_trackCount];
+        added.offset = static_cast<uint16_t>(m_allocated);
+        added.capacity = static_cast<uint16_t>(capacity);
+        added.written = 0;
+        added.element = element;
+        added.mode = mode;
+
+        m_allocated += capacity;
+        m_trackOf[index] = static_cast<uint8_t>(++m_trackCount);
+    }
+    portEXIT_CRITICAL(&m_lock);
+    return ok;
+}
+
+const ParameterHistory::Track* ParameterHistory::track(uint8_t category, uint8_t id) const {
+    int index = ParameterSchema::indexOf(category, id);
+    if (index < 0 || m_trackOf[index] == 0) {
+        return nullptr;
+    }
+    return &m_tracks[m_trackOf[index] - 1];
+}
+
+void ParameterHistory::record(uint8_t category, uint8_t id, const uint8_t* payload, size_t length, bool changed, uint32_t nowMs) {
+    int index = ParameterSchema::indexOf(category, id);
+    if (index < 0 || m_trackOf[index] == 0) {
+        return;
+    }
+
+    Track& tracked = m_tracks[m_trackOf[index] - 1];
+    if (!changed && tracked.mode == NotifyMode::ChangesOnly) {
+        return;
+    }
+
+    const ParameterInfo& info = PARAMETER_TABLE[index];
+    size_t size = detail::elementSize(info.dataType);
+    if (payload == nullptr || length < (tracked.element + 1u) * size) {
+        return;
+    }
+    float value = decodeElement(info.dataType, payload + tracked.element * size);
+
+    portENTER_CRITICAL(&m_lock);
+    HistorySample& sample = m_samples[tracked.offset + tracked.written % tracked.capacity];
+    sample.timeMs = nowMs;
+    sample.value = value;
+    tracked.written++;
+    portEXIT_CRITICAL(&m_lock);
+}
+
+uint32_t ParameterHistory::search(const Track& tracked, uint32_t timeMs, bool inclusive) const {
+    uint32_t first = oldest(tracked);
+    if (tracked.written == first) {
+        return first;
+    }
+
+    // Ages relative to the newest sample shrink towards the end of the
+    // ring, which keeps the search correct across a millis() wrap
+    uint32_t newest = at(tracked, tracked.written - 1).timeMs;
+    int32_t target = static_cast<int32_t>(newest - timeMs);
+    if (target < 0 || (target == 0 && !inclusive)) {
+        return tracked.written;
+    }
+
+    uint32_t low = first;
+    uint32_t high = tracked.written;
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        uint32_t age = newest - at(tracked, middle).timeMs;
+        bool after = inclusive ? age <= static_cast<uint32_t>(target) : age < static_cast<uint32_t>(target);
+        if (after) {
+            high = middle;
+        } else {
+            low = middle + 1;
+        }
+    }
+    return low;
+}
+
+bool ParameterHistory::valueAt(uint8_t category, uint8_t id, uint32_t timeMs, float& value) const {
+    const Track* tracked = track(category, id);
+    if (tracked == nullptr) {
+        return false;
+    }
+
+    portENTER_CRITICAL(&m_lock);
+    uint32_t next = search(*tracked, timeMs, false);
+    bool found = next > oldest(*tracked);
+    if (found) {
+        value = at(*tracked, next - 1).value;
+    }
+    portEXIT_CRITICAL(&m_lock);
+    return found;
+}
+
+bool ParameterHistory::latest(uint8_t category, uint8_t id, HistorySample& sample) const {
+    const Track* tracked = track(category, id);
+    if (tracked == nullptr) {
+        return false;
+    }
+
+    portENTER_CRITICAL(&m_lock);
+    bool found = tracked->written > 0;
+    if (found) {
+        sample = at(*tracked, tracked->written - 1);
+    }
+    portEXIT_CRITICAL(&m_lock);
+    return found;
+}
+
+size_t ParameterHistory::forEach(uint8_t category, uint8_t id, uint32_t fromMs, uint32_t toMs,
+                                 const HistoryVisitor& visitor) const {
+    const Track* tracked = track(category, id);
+    if (tracked == nullptr) {
+        return 0;
+    }
+
+    portENTER_CRITICAL(&m_lock);
+    uint32_t sequence = search(*tracked, fromMs, true);
+    portEXIT_CRITICAL(&m_lock);
+
+    // One sample at a time, so the visitor never runs under the lock
+    size_t visited = 0;
+    for (;;) {
+        portENTER_CRITICAL(&m_lock);
+        if (sequence < oldest(*tracked)) {
+            sequence = oldest(*tracked);
+        }
+        bool more = sequence < tracked->written;
+        HistorySample sample{};
+        if (more) {
+            sample = at(*tracked, sequence++);
+        }
+        portEXIT_CRITICAL(&m_lock);
+
+        if (!more || !inWindow(sample.timeMs, fromMs, toMs)) {
+            break;
+        }
+        visitor(sample);
+        visited++;
+    }
+    return visited;
+}
+
+bool ParameterHistory::getStats(uint8_t category, uint8_t id, uint32_t fromMs, uint32_t toMs, HistoryStats& stats) const {
+    const Track* tracked = track(category, id);
+    if (tracked == nullptr) {
+        return false;
+    }
+
+    HistoryStats result;
+    double sum = 0.0;
+
+    portENTER_CRITICAL(&m_lock);
+    for (uint32_t sequence = search(*tracked, fromMs, true); sequence < tracked->written; sequence++) {
+        const HistorySample& sample = at(*tracked, sequence);
+        if (!inWindow(sample.timeMs, fromMs, toMs)) {
+            break;
+        }
+        if (result.count == 0 || sample.value < result.minimum) {
+            result.minimum = sample.value;
+        }
+        if (result.count == 0 || sample.value > result.maximum) {
+            result.maximum = sample.value;
+        }
+        sum += sample.value;
+        result.count++;
+    }
+    portEXIT_CRITICAL(&m_lock);
+
+    if (result.count == 0) {
+        return false;
+    }
+    result.mean = static_cast<float>(sum / static_cast<double>(result.count));
+    stats = result;
+    return true;
+}
+
+size_t ParameterHistory::getSize(uint8_t category, uint8_t id) const {
+    const Track* tracked = track(category, id);
+    return tracked == nullptr ? 0 : static_cast<size_t>(tracked->written - oldest(*tracked));
+}
+
+uint32_t ParameterHistory::getRecorded(uint8_t category, uint8_t id) const {
+    const Track* tracked = track(category, id);
+    return tracked == nullptr ? 0 : tracked->written;
+}
+
+void ParameterHistory::clear() {
+    portENTER_CRITICAL(&m_lock);
+    for (size_t i = 0; i < m_trackCount; i++) {
+        m_tracks[i].written = 0;
+    }
+    portEXIT_CRITICAL(&m_lock);
+}
+
+void ParameterHistory::reset() {
+    portENTER_CRITICAL(&m_lock);
+    m_trackOf.fill(0);
+    m_trackCount = 0;
+    m_allocated = 0;
+    portEXIT_CRITICAL(&m_lock);
+}
+
+} // namespace BMDCamera
@@ -0,0 +1,132 @@
+#ifndef BMD_PARAMETER_HISTORY_H
+#define BMD_PARAMETER_HISTORY_H
+
+#include <Arduino.h>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include "InplaceFunction.h"
+#include "ParameterSchema.h"
+#include "ParameterSubscriptions.h"
+
+// Samples shared by every history track, allocated up front (8 bytes each)
+#ifndef BMD_PARAMETER_HISTORY_SAMPLES
+#define BMD_PARAMETER_HISTORY_SAMPLES 256
+#endif
+
+// Parameters that can keep a history at the same time
+#ifndef BMD_PARAMETER_HISTORY_TRACKS
+#define BMD_PARAMETER_HISTORY_TRACKS 8
+#endif
+
+namespace BMDCamera {
+    // One recorded value. Elements of every data type are widened to float.
+    struct HistorySample {
+        uint32_t timeMs;
+        float value;
+    };
+
+    // Summary of the samples in a time window
+    struct HistoryStats {
+        size_t count = 0;
+        float minimum = 0.0f;
+        float maximum = 0.0f;
+        float mean = 0.0f;
+    };
+
+    using HistoryVisitor = InplaceFunction<void(const HistorySample& sample)>;
+
+    // Recent values of selected parameters, e.g. focus over the last ten
+    // seconds or the ISO changes during a take. Tracking is opt-in per
+    // parameter: enable() reserves a ring of samples from a fixed pool, so
+    // the memory cost is known at compile time and recording never
+    // allocates. When a ring is full the oldest sample is overwritten.
+    //
+    // Times are millis() values; windows are compared wrap-safely and may
+    // span up to 24 days. Reports are recorded on the BLE task and may be
+    // queried from any task.
+    class ParameterHistory {
+    public:
+        static constexpr size_t SAMPLE_BUDGET = BMD_PARAMETER_HISTORY_SAMPLES;
+        static constexpr size_t MAX_TRACKS = BMD_PARAMETER_HISTORY_TRACKS;
+
+        // Keep the last capacity values of one element of a parameter.
+        // ChangesOnly skips reports that repeat the cached value. Fails for
+        // unknown or string parameters, an element out of range, a
+        // parameter already tracked, or when the pool or tracks run out.
+        bool enable(uint8_t category, uint8_t id, size_t capacity, uint8_t element = 0,
+                    NotifyMode mode = NotifyMode::ChangesOnly);
+        bool isEnabled(uint8_t category, uint8_t id) const { return track(category, id) != nullptr; }
+
+        // Ingest side: one stored report (see ParameterUpdateCallback)
+        void record(uint8_t category, uint8_t id, const uint8_t* payload, size_t length, bool changed, uint32_t nowMs);
+
+        // The value in effect at timeMs: the latest sample at or before it.
+        // False if the history doesn't reach back that far.
+        bool valueAt(uint8_t category, uint8_t id, uint32_t timeMs, float& value) const;
+
+        // Latest sample, if any
+        bool latest(uint8_t category, uint8_t id, HistorySample& sample) const;
+
+        // Visit the samples from fromMs to toMs inclusive, oldest first.
+        // Returns the number visited. The visitor runs without the lock
+        // held; samples overwritten meanwhile are skipped.
+        size_t forEach(uint8_t category, uint8_t id, uint32_t fromMs, uint32_t toMs, const HistoryVisitor& visitor) const;
+
+        // Minimum, maximum and mean of the samples from fromMs to toMs.
+        // False if there are none.
+        bool getStats(uint8_t category, uint8_t id, uint32_t fromMs, uint32_t toMs, HistoryStats& stats) const;
+
+        // Samples held now, and ever recorded, for a parameter
+        size_t getSize(uint8_t category, uint8_t id) const;
+        uint32_t getRecorded(uint8_t category, uint8_t id) const;
+
+        // Pool samples not yet given to a track
+        size_t getSamplesAvailable() const { return SAMPLE_BUDGET - m_allocated; }
+
+        // Forget every sample but keep the tracks
+        void clear();
+
+        // Drop every track and return its samples to the pool. Not while
+        // reports are being recorded.
+        void reset();
+
+    private:
+        static_assert(SAMPLE_BUDGET <= 0xFFFF, "Track offsets are stored in a uint16_t");
+        static_assert(MAX_TRACKS < 0xFF, "Track numbers are stored in a uint8_t");
+
+        struct Track {
+            uint16_t offset;     // First sample in m_samples
+            uint16_t capacity;
+            uint32_t written;    // Samples ever recorded; the next goes at written % capacity
+            uint8_t element;
+            NotifyMode mode;
+        };
+
+        const Track* track(uint8_t category, uint8_t id) const;
+
+        // Absolute sequence of the oldest sample still held
+        static uint32_t oldest(const Track& track) {
+            return track.written > track.capacity ? track.written - track.capacity : 0;
+        }
+        const HistorySample& at(const Track& track, uint32_t sequence) const {
+            return m_samples[track.offset + sequence % track.capacity];
+        }
+
+        // First held sample at or after timeMs (inclusive) or after it,
+        // by binary search; written if there is none. Call under the lock.
+        uint32_t search(const Track& track, uint32_t timeMs, bool inclusive) const;
+
+        std::array<HistorySample, SAMPLE_BUDGET> m_samples{};
+        std::array<Track, MAX_TRACKS> m_tracks{};
+        size_t m_trackCount = 0;
+        size_t m_allocated = 0;
+
+        // Track number + 1 for each schema entry, 0 when not tracked
+        std::array<uint8_t, PARAMETER_COUNT> m_trackOf{};
+
+        mutable portMUX_TYPE m_lock = portMUX_INITIALIZER_UNLOCKED;
+    };
+}
+
+#endif // BMD_PARAMETER_HISTORY_H
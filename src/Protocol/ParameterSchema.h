@@ -0,0 +1,302 @@
+#ifndef BMD_PARAMETER_SCHEMA_H
+#define BMD_PARAMETER_SCHEMA_H
+
+// The constexpr tables below need C++17
+#if __cplusplus < 201703L
+#error "BMDBLEController requires C++17 (arduino-esp32 3.x, or -std=gnu++17)"
+#endif
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include "ProtocolConstants.h"
+
+namespace BMDCamera {
+    // Everything the protocol says about one parameter
+    struct ParameterInfo {
+        uint8_t category;    // ProtocolCategory
+        uint8_t id;
+        uint8_t dataType;    // ProtocolDataType
+        uint8_t count;       // Elements in the payload; 0 for commands and strings
+        float minimum;       // Valid range of each element (unused for strings)
+        float maximum;
+        const char* name;
+
+        // Fixed payload size in bytes, 0 for variable-length strings
+        constexpr size_t payloadSize() const;
+
+        constexpr bool inRange(float value) const {
+            return count == 0 || (value >= minimum && value <= maximum);
+        }
+    };
+
+    // Parameter table for every category. Keep each category's entries
+    // together and in id order; the checks at the bottom of this file
+    // enforce the layout at compile time.
+    inline constexpr ParameterInfo PARAMETER_TABLE[] = {
+        // Lens
+        { CAT_LENS, 0x00, TYPE_FIXED16, 1, 0.0f, 1.0f, "Focus" },
+        { CAT_LENS, 0x01, TYPE_VOID, 0, 0.0f, 0.0f, "Instantaneous Autofocus" },
+        { CAT_LENS, 0x02, TYPE_FIXED16, 1, -1.0f, 16.0f, "Aperture (f-stop)" },
+        { CAT_LENS, 0x03, TYPE_FIXED16, 1, 0.0f, 1.0f, "Aperture (normalised)" },
+        { CAT_LENS, 0x04, TYPE_INT16, 1, 0.0f, 32767.0f, "Aperture (ordinal)" },
+        { CAT_LENS, 0x05, TYPE_VOID, 0, 0.0f, 0.0f, "Instantaneous Auto Aperture" },
+        { CAT_LENS, 0x06, TYPE_VOID, 1, 0.0f, 1.0f, "Optical Image Stabilisation" },
+        { CAT_LENS, 0x07, TYPE_INT16, 1, 0.0f, 32767.0f, "Absolute Zoom (mm)" },
+        { CAT_LENS, 0x08, TYPE_FIXED16, 1, 0.0f, 1.0f, "Absolute Zoom (normalised)" },
+        { CAT_LENS, 0x09, TYPE_FIXED16, 1, -1.0f, 1.0f, "Continuous Zoom" },
+
+        // Video
+        { CAT_VIDEO, 0x00, TYPE_BYTE, 5, 0.0f, 127.0f, "Video Mode" },
+        { CAT_VIDEO, 0x01, TYPE_BYTE, 1, 1.0f, 16.0f, "Gain (legacy)" },
+        { CAT_VIDEO, 0x02, TYPE_INT16, 2, -50.0f, 10000.0f, "Manual White Balance" },
+        { CAT_VIDEO, 0x03, TYPE_VOID, 0, 0.0f, 0.0f, "Set Auto White Balance" },
+        { CAT_VIDEO, 0x04, TYPE_VOID, 0, 0.0f, 0.0f, "Restore Auto White Balance" },
+        { CAT_VIDEO, 0x05, TYPE_INT32, 1, 1.0f, 42000.0f, "Exposure (us)" },
+        { CAT_VIDEO, 0x06, TYPE_INT16, 1, 0.0f, 32767.0f, "Exposure (ordinal)" },
+        { CAT_VIDEO, 0x07, TYPE_BYTE, 1, 0.0f, 2.0f, "Dynamic Range Mode" },
+        { CAT_VIDEO, 0x08, TYPE_BYTE, 1, 0.0f, 3.0f, "Video Sharpening Level" },
+        { CAT_VIDEO, 0x09, TYPE_INT16, 5, 0.0f, 32767.0f, "Recording Format" },
+        { CAT_VIDEO, 0x0A, TYPE_BYTE, 1, 0.0f, 4.0f, "Auto Exposure Mode" },
+        { CAT_VIDEO, 0x0B, TYPE_INT32, 1, 100.0f, 36000.0f, "Shutter Angle" },
+        { CAT_VIDEO, 0x0C, TYPE_INT32, 1, 24.0f, 2000.0f, "Shutter Speed" },
+        { CAT_VIDEO, 0x0D, TYPE_BYTE, 1, -128.0f, 127.0f, "Gain (dB)" },
+        { CAT_VIDEO, 0x0E, TYPE_INT32, 1, 0.0f, 2147483647.0f, "ISO" },
+        { CAT_VIDEO, 0x0F, TYPE_BYTE, 2, 0.0f, 3.0f, "Display LUT" },
+        { CAT_VIDEO, 0x10, TYPE_FIXED16, 2, 0.0f, 15.0f, "ND Filter" },
+
+        // Audio
+        { CAT_AUDIO, 0x00, TYPE_FIXED16, 1, 0.0f, 1.0f, "Mic Level" },
+        { CAT_AUDIO, 0x01, TYPE_FIXED16, 1, 0.0f, 1.0f, "Headphone Level" },
+        { CAT_AUDIO, 0x02, TYPE_FIXED16, 1, 0.0f, 1.0f, "Headphone Program Mix" },
+        { CAT_AUDIO, 0x03, TYPE_FIXED16, 1, 0.0f, 1.0f, "Speaker Level" },
+        { CAT_AUDIO, 0x04, TYPE_BYTE, 1, 0.0f, 3.0f, "Input Type" },
+        { CAT_AUDIO, 0x05, TYPE_FIXED16, 2, 0.0f, 1.0f, "Input Levels" },
+        { CAT_AUDIO, 0x06, TYPE_VOID, 1, 0.0f, 1.0f, "Phantom Power" },
+
+        // Output
+        { CAT_OUTPUT, 0x00, TYPE_INT16, 1, 0.0f, 32767.0f, "Overlay Enables" },
+        { CAT_OUTPUT, 0x01, TYPE_BYTE, 1, 0.0f, 8.0f, "Frame Guides Style" },
+        { CAT_OUTPUT, 0x02, TYPE_FIXED16, 1, 0.1f, 1.0f, "Frame Guides Opacity" },
+        { CAT_OUTPUT, 0x03, TYPE_BYTE, 4, 0.0f, 100.0f, "Overlays" },
+
+        // Display
+        { CAT_DISPLAY, 0x00, TYPE_FIXED16, 1, 0.0f, 1.0f, "Brightness" },
+        { CAT_DISPLAY, 0x01, TYPE_INT16, 1, 0.0f, 32767.0f, "Exposure and Focus Tools" },
+        { CAT_DISPLAY, 0x02, TYPE_FIXED16, 1, 0.0f, 1.0f, "Zebra Level" },
+        { CAT_DISPLAY, 0x03, TYPE_FIXED16, 1, 0.0f, 1.0f, "Peaking Level" },
+        { CAT_DISPLAY, 0x04, TYPE_BYTE, 1, 0.0f, 30.0f, "Color Bars Display Time" },
+        { CAT_DISPLAY, 0x05, TYPE_BYTE, 2, 0.0f, 127.0f, "Focus Assist" },
+        { CAT_DISPLAY, 0x06, TYPE_BYTE, 1, 0.0f, 30.0f, "Program Return Feed" },
+
+        // Tally
+        { CAT_TALLY, 0x00, TYPE_FIXED16, 1, 0.0f, 1.0f, "Tally Brightness" },
+        { CAT_TALLY, 0x01, TYPE_FIXED16, 1, 0.0f, 1.0f, "Front Tally Brightness" },
+        { CAT_TALLY, 0x02, TYPE_FIXED16, 1, 0.0f, 1.0f, "Rear Tally Brightness" },
+
+        // Reference
+        { CAT_REFERENCE, 0x00, TYPE_BYTE, 1, 0.0f, 2.0f, "Reference Source" },
+        { CAT_REFERENCE, 0x01, TYPE_INT32, 1, -2147483648.0f, 2147483647.0f, "Reference Offset" },
+
+        // Configuration
+        { CAT_CONFIG, 0x00, TYPE_INT32, 2, 0.0f, 2147483647.0f, "Real Time Clock" },
+        { CAT_CONFIG, 0x01, TYPE_STRING, 0, 0.0f, 0.0f, "System Language" },
+        { CAT_CONFIG, 0x02, TYPE_INT32, 1, -1440.0f, 1440.0f, "Timezone" },
+        { CAT_CONFIG, 0x03, TYPE_INT64, 2, -9.2e18f, 9.2e18f, "Location" },
+
+        // Color correction
+        { CAT_COLOR, 0x00, TYPE_FIXED16, 4, -2.0f, 2.0f, "Lift Adjust" },
+        { CAT_COLOR, 0x01, TYPE_FIXED16, 4, -4.0f, 4.0f, "Gamma Adjust" },
+        { CAT_COLOR, 0x02, TYPE_FIXED16, 4, 0.0f, 15.9995f, "Gain Adjust" },
+        { CAT_COLOR, 0x03, TYPE_FIXED16, 4, -8.0f, 8.0f, "Offset Adjust" },
+        { CAT_COLOR, 0x04, TYPE_FIXED16, 2, 0.0f, 2.0f, "Contrast Adjust" },
+        { CAT_COLOR, 0x05, TYPE_FIXED16, 1, 0.0f, 1.0f, "Luma Mix" },
+        { CAT_COLOR, 0x06, TYPE_FIXED16, 2, -1.0f, 2.0f, "Color Adjust" },
+        { CAT_COLOR, 0x07, TYPE_VOID, 0, 0.0f, 0.0f, "Correction Reset Default" },
+
+        // Status is reported on its own characteristic (see CameraStatus.h)
+        // and has no control parameters
+
+        // Transport
+        { CAT_TRANSPORT, 0x00, TYPE_BYTE, 2, 0.0f, 127.0f, "Codec" },
+        { CAT_TRANSPORT, 0x01, TYPE_BYTE, 5, -128.0f, 127.0f, "Transport Mode" },
+        { CAT_TRANSPORT, 0x02, TYPE_BYTE, 2, 0.0f, 1.0f, "Playback Control" },
+        { CAT_TRANSPORT, 0x03, TYPE_VOID, 0, 0.0f, 0.0f, "Still Capture" },
+
+        // Extended lens (clip and lens metadata)
+        { CAT_EXTENDED_LENS, 0x00, TYPE_INT16, 1, 0.0f, 999.0f, "Reel" },
+        { CAT_EXTENDED_LENS, 0x01, TYPE_BYTE, 2, -1.0f, 127.0f, "Scene Tags" },
+        { CAT_EXTENDED_LENS, 0x02, TYPE_STRING, 0, 0.0f, 0.0f, "Scene" },
+        { CAT_EXTENDED_LENS, 0x03, TYPE_BYTE, 2, 0.0f, 99.0f, "Take" },
+        { CAT_EXTENDED_LENS, 0x04, TYPE_VOID, 1, 0.0f, 1.0f, "Good Take" },
+        { CAT_EXTENDED_LENS, 0x05, TYPE_STRING, 0, 0.0f, 0.0f, "Camera ID" },
+        { CAT_EXTENDED_LENS, 0x06, TYPE_STRING, 0, 0.0f, 0.0f, "Camera Operator" },
+        { CAT_EXTENDED_LENS, 0x07, TYPE_STRING, 0, 0.0f, 0.0f, "Director" },
+        { CAT_EXTENDED_LENS, 0x08, TYPE_STRING, 0, 0.0f, 0.0f, "Project Name" },
+        { CAT_EXTENDED_LENS, 0x09, TYPE_STRING, 0, 0.0f, 0.0f, "Lens Type" },
+        { CAT_EXTENDED_LENS, 0x0A, TYPE_STRING, 0, 0.0f, 0.0f, "Lens Iris" },
+        { CAT_EXTENDED_LENS, 0x0B, TYPE_STRING, 0, 0.0f, 0.0f, "Lens Focal Length" },
+        { CAT_EXTENDED_LENS, 0x0C, TYPE_STRING, 0, 0.0f, 0.0f, "Lens Distance" },
+        { CAT_EXTENDED_LENS, 0x0D, TYPE_STRING, 0, 0.0f, 0.0f, "Lens Filter" },
+        { CAT_EXTENDED_LENS, 0x0E, TYPE_BYTE, 1, 0.0f, 1.0f, "Slate Mode" },
+        { CAT_EXTENDED_LENS, 0x0F, TYPE_STRING, 0, 0.0f, 0.0f, "Slate Target" },
+    };
+
+    constexpr size_t PARAMETER_COUNT = sizeof(PARAMETER_TABLE) / sizeof(PARAMETER_TABLE[0]);
+
+    namespace detail {
+        // Dimensions of the direct-mapped lookup index
+        constexpr size_t CATEGORY_SLOTS = 16;
+        constexpr size_t PARAMETER_SLOTS = 32;
+
+        constexpr const char* CATEGORY_NAMES[CATEGORY_SLOTS] = {
+            "Lens", "Video", "Audio", "Output", "Display", "Tally", "Reference",
+            "Configuration", "Color Correction", "Status", "Transport", nullptr,
+            "Extended Lens", nullptr, nullptr, nullptr
+        };
+
+        // Bytes per element of a data type
+        constexpr size_t elementSize(uint8_t dataType) {
+            switch (dataType) {
+                case TYPE_VOID:     // Booleans travel as one byte
+                case TYPE_BYTE:
+                case TYPE_STRING:
+                    return 1;
+                case TYPE_INT16:
+                case TYPE_FIXED16:
+                    return 2;
+                case TYPE_INT32:
+                    return 4;
+                case TYPE_INT64:
+                    return 8;
+                default:
+                    return 0;
+            }
+        }
+
+        // Table position + 1 for each (category, id) slot, 0 when empty
+        constexpr std::array<uint8_t, CATEGORY_SLOTS * PARAMETER_SLOTS> buildIndex() {
+            std::array<uint8_t, CATEGORY_SLOTS * PARAMETER_SLOTS> index{};
+            for (size_t i = 0; i < PARAMETER_COUNT; i++) {
+                const ParameterInfo& info = PARAMETER_TABLE[i];
+                if (info.category < CATEGORY_SLOTS && info.id < PARAMETER_SLOTS) {
+                    index[info.category * PARAMETER_SLOTS + info.id] = static_cast<uint8_t>(i + 1);
+                }
+            }
+            return index;
+        }
+
+        constexpr std::array<uint8_t, CATEGORY_SLOTS * PARAMETER_SLOTS> PARAMETER_INDEX = buildIndex();
+    }
+
+    constexpr size_t ParameterInfo::payloadSize() const {
+        return detail::elementSize(dataType) * count;
+    }
+
+    class ParameterSchema {
+    public:
+        static constexpr size_t CATEGORY_SLOTS = detail::CATEGORY_SLOTS;
+        static constexpr size_t PARAMETER_SLOTS = detail::PARAMETER_SLOTS;
+
+        // O(1) position in PARAMETER_TABLE, or -1 if the parameter is
+        // unknown. The constexpr checks below go through this rather than
+        // comparing pointers, which GCC can't fold under -fsanitize=undefined.
+        static constexpr int indexOf(uint8_t category, uint8_t id) {
+            if (category >= CATEGORY_SLOTS || id >= PARAMETER_SLOTS) {
+                return -1;
+            }
+            return static_cast<int>(detail::PARAMETER_INDEX[category * PARAMETER_SLOTS + id]) - 1;
+        }
+
+        // O(1) lookup; nullptr if the parameter is unknown
+        static constexpr const ParameterInfo* find(uint8_t category, uint8_t id) {
+            int index = indexOf(category, id);
+            return index < 0 ? nullptr : &PARAMETER_TABLE[index];
+        }
+
+        // True if the parameter exists and uses this data type
+        static constexpr bool matches(uint8_t category, uint8_t id, uint8_t dataType) {
+            int index = indexOf(category, id);
+            return index >= 0 && PARAMETER_TABLE[index].dataType == dataType;
+        }
+
+        // Check an encoded or received payload against the schema
+        static constexpr bool validate(uint8_t category, uint8_t id, uint8_t dataType, size_t payloadLength) {
+            int index = indexOf(category, id);
+            if (index < 0 || PARAMETER_TABLE[index].dataType != dataType) {
+                return false;
+            }
+            size_t expected = PARAMETER_TABLE[index].payloadSize();
+            return expected == 0 ? (dataType == TYPE_STRING || payloadLength == 0)
+                                 : payloadLength == expected;
+        }
+
+        // Compile-time checked lookup for keys known at build time
+        template <uint8_t Category, uint8_t Id, uint8_t DataType>
+        static constexpr const ParameterInfo& require() {
+            static_assert(indexOf(Category, Id) >= 0, "Parameter is not in the schema");
+            static_assert(matches(Category, Id, DataType), "Data type does not match the schema");
+            return PARAMETER_TABLE[indexOf(Category, Id)];
+        }
+
+        static constexpr size_t elementSize(uint8_t dataType) {
+            return detail::elementSize(dataType);
+        }
+
+        static constexpr const char* categoryName(uint8_t category) {
+            return category < CATEGORY_SLOTS && detail::CATEGORY_NAMES[category] != nullptr
+                ? detail::CATEGORY_NAMES[category] : "Unknown";
+        }
+
+        static constexpr const char* dataTypeName(uint8_t dataType) {
+            switch (dataType) {
+                case TYPE_VOID: return "Void";
+                case TYPE_BYTE: return "Signed Byte";
+                case TYPE_INT16: return "Signed Int16";
+                case TYPE_INT32: return "Signed Int32";
+                case TYPE_INT64: return "Signed Int64";
+                case TYPE_STRING: return "String";
+                case TYPE_FIXED16: return "Fixed16";
+                default: return "Unknown";
+            }
+        }
+
+        static constexpr const char* parameterName(uint8_t category, uint8_t id) {
+            int index = indexOf(category, id);
+            return index >= 0 ? PARAMETER_TABLE[index].name : "Unknown";
+        }
+    };
+
+    // Layout checks: every entry fits the index, has a named category and a
+    // known type, sorts after its predecessor (so there are no duplicates)
+    // and has a sane range
+    constexpr bool schemaIsValid() {
+        for (size_t i = 0; i < PARAMETER_COUNT; i++) {
+            const ParameterInfo& info = PARAMETER_TABLE[i];
+            if (info.category >= ParameterSchema::CATEGORY_SLOTS ||
+                info.id >= ParameterSchema::PARAMETER_SLOTS ||
+                detail::CATEGORY_NAMES[info.category] == nullptr ||
+                ParameterSchema::elementSize(info.dataType) == 0 ||
+                info.minimum > info.maximum ||
+                info.name == nullptr) {
+                return false;
+            }
+            if (i > 0) {
+                const ParameterInfo& previous = PARAMETER_TABLE[i - 1];
+                uint16_t previousKey = (previous.category << 8) | previous.id;
+                uint16_t key = (info.category << 8) | info.id;
+                if (key <= previousKey) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    static_assert(PARAMETER_COUNT < 255, "Parameter index stores positions in a uint8_t");
+    static_assert(schemaIsValid(), "Parameter table is malformed");
+    static_assert(ParameterSchema::indexOf(CAT_LENS, 0x03) == 3,
+                  "Parameter index does not match the table");
+}
+
+#endif // BMD_PARAMETER_SCHEMA_H
@@ -0,0 +1,490 @@
+#include "ParameterSubscriptions.h"
+#include "../Diagnostics/Metrics.h"
+#include "../Diagnostics/TraceLog.h"
+#include <cstring>
+
+namespace BMDCamera {
+
+namespace {
+    constexpr uint32_t ALL_CATEGORIES = 0xFFFFFFFFu;
+
+    // Slot in the low byte (offset by one so 0 stays invalid), generation above
+    SubscriptionId makeId(size_t slot, uint8_t generation) {
+        return static_cast<SubscriptionId>((generation << 8) | (slot + 1));
+    }
+}
+
+bool ParameterSubscriptions::ReportQueue::push(const QueuedReport& report) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= QUEUE_CAPACITY) {
+        return false;
+    }
+    reports[h & (QUEUE_CAPACITY - 1)] = report;
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+bool ParameterSubscriptions::ReportQueue::pop(QueuedReport& report) {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    if (t == head.load(std::memory_order_acquire)) {
+        return false;
+    }
+    report = reports[t & (QUEUE_CAPACITY - 1)];
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+}
+
+SubscriptionId ParameterSubscriptions::subscribe(uint8_t category, uint8_t id, ParameterCallback cb,
+                                                 NotifyMode mode, CallbackExecutor executor) {
+    if (category == ANY_CATEGORY) {
+        return add(ALL_CATEGORIES, id, false, std::move(cb), mode, executor);
+    }
+    if (category >= ParameterSchema::CATEGORY_SLOTS) {
+        return INVALID_SUBSCRIPTION;
+    }
+    if (id != ANY_PARAMETER) {
+        // Reports for anything else never reach dispatch()
+        int index = ParameterSchema::indexOf(category, id);
+        if (index < 0 || !ParameterCache::caches(PARAMETER_TABLE[index])) {
+            return INVALID_SUBSCRIPTION;
+        }
+    }
+    return add(1u << category, id, id != ANY_PARAMETER, std::move(cb), mode, executor);
+}
+
+SubscriptionId ParameterSubscriptions::subscribeCategories(uint32_t categoryMask, ParameterCallback cb,
+                                                           NotifyMode mode, CallbackExecutor executor) {
+    return categoryMask == 0 ? INVALID_SUBSCRIPTION
+                             : add(categoryMask, ANY_PARAMETER, false, std::move(cb), mode, executor);
+}
+
+SubscriptionId ParameterSubscriptions::add(uint32_t categoryMask, uint8_t id, bool exact, ParameterCallback cb,
+                                           NotifyMode mode, CallbackExecutor executor) {
+    if (!cb) {
+        return INVALID_SUBSCRIPTION;
+    }
+
+    // Resolved once, here, instead of on every report. A subscription
+    // that can never fire is refused rather than silently kept.
+    auto wants = [categoryMask, id](const ParameterInfo& info) {
+        return ParameterCache::caches(info) && (categoryMask & (1u << info.category)) != 0 &&
+               (id == ANY_PARAMETER || id == info.id);
+    };
+    bool any = false;
+    for (size_t i = 0; i < PARAMETER_COUNT && !any; i++) {
+        any = wants(PARAMETER_TABLE[i]);
+    }
+    if (!any) {
+        return INVALID_SUBSCRIPTION;
+    }
+
+    // Claim a free slot; it is filled in unlocked, since nothing calls
+    // into a slot until it is published below
+    portENTER_CRITICAL(&m_lock);
+    size_t slot = 0;
+    while (slot < MAX_SUBSCRIBERS && (m_reserved & (SubscriberMask(1) << slot)) != 0) {
+        slot++;
+    }
+    if (slot < MAX_SUBSCRIBERS) {
+        m_reserved |= SubscriberMask(1) << slot;
+    }
+    portEXIT_CRITICAL(&m_lock);
+    if (slot == MAX_SUBSCRIBERS) {
+        return INVALID_SUBSCRIPTION;
+    }
+
+    Subscriber& subscriber = m_subscribers[slot];
+    subscriber.callback = std::move(cb);
+    subscriber.categoryMask = categoryMask;
+    subscriber.id = id;
+    subscriber.exact = exact;
+    subscriber.mode = mode;
+    subscriber.executor = executor;
+
+    SubscriberMask bit = SubscriberMask(1) << slot;
+    SubscriptionId subscription = makeId(slot, subscriber.generation);
+
+    portENTER_CRITICAL(&m_lock);
+    subscriber.suppressed = 0;
+    subscriber.delivered = 0;
+    subscriber.slowCalls = 0;
+    subscriber.maxMicros = 0;
+    for (size_t i = 0; i < PARAMETER_COUNT; i++) {
+        if (wants(PARAMETER_TABLE[i])) {
+            m_matches[i] |= bit;
+        }
+    }
+    m_active |= bit;
+    portEXIT_CRITICAL(&m_lock);
+
+    return subscription;
+}
+
+bool ParameterSubscriptions::retire(size_t slot) {
+    SubscriberMask bit = SubscriberMask(1) << slot;
+    for (SubscriberMask& matches : m_matches) {
+        matches &= ~bit;
+    }
+    m_active &= ~bit;
+
+    Subscriber& subscriber = m_subscribers[slot];
+    subscriber.generation++;
+    return subscriber.running == 0;
+}
+
+void ParameterSubscriptions::release(size_t slot) {
+    // Destroyed unlocked: the callable's destructor is user code
+    m_subscribers[slot].callback = nullptr;
+
+    portENTER_CRITICAL(&m_lock);
+    m_reserved &= ~(SubscriberMask(1) << slot);
+    portEXIT_CRITICAL(&m_lock);
+}
+
+bool ParameterSubscriptions::unsubscribe(SubscriptionId subscription) {
+    size_t slot = static_cast<size_t>(subscription & 0xFF);
+    if (slot == 0 || slot > MAX_SUBSCRIBERS) {
+        return false;
+    }
+    slot--;
+
+    // Checked and retired in one step, so a racing unsubscribe can't
+    // retire the slot twice
+    portENTER_CRITICAL(&m_lock);
+    bool found = (m_active & (SubscriberMask(1) << slot)) != 0 &&
+                 m_subscribers[slot].generation == (subscription >> 8);
+    bool idle = found && retire(slot);
+    portEXIT_CRITICAL(&m_lock);
+
+    if (idle) {
+        release(slot);
+    }
+    return found;
+}
+
+size_t ParameterSubscriptions::unsubscribe(uint8_t category, uint8_t id) {
+    if (category >= ParameterSchema::CATEGORY_SLOTS) {
+        return 0;
+    }
+
+    size_t removed = 0;
+    SubscriberMask idle = 0;
+    portENTER_CRITICAL(&m_lock);
+    for (size_t slot = 0; slot < MAX_SUBSCRIBERS; slot++) {
+        const Subscriber& subscriber = m_subscribers[slot];
+        if ((m_active & (SubscriberMask(1) << slot)) != 0 && subscriber.exact &&
+            subscriber.categoryMask == (1u << category) && subscriber.id == id) {
+            if (retire(slot)) {
+                idle |= SubscriberMask(1) << slot;
+            }
+            removed++;
+        }
+    }
+    portEXIT_CRITICAL(&m_lock);
+
+    while (idle != 0) {
+        release(static_cast<size_t>(__builtin_ctz(idle)));
+        idle &= idle - 1;
+    }
+    return removed;
+}
+
+uint32_t ParameterSubscriptions::readCounter(SubscriptionId subscription, uint32_t Subscriber::*counter) const {
+    size_t slot = static_cast<size_t>(subscription & 0xFF);
+    if (slot == 0 || slot > MAX_SUBSCRIBERS) {
+        return 0;
+    }
+    slot--;
+
+    portENTER_CRITICAL(&m_lock);
+    const Subscriber& subscriber = m_subscribers[slot];
+    bool found = (m_active & (SubscriberMask(1) << slot)) != 0 && subscriber.generation == (subscription >> 8);
+    uint32_t value = found ? subscriber.*counter : 0;
+    portEXIT_CRITICAL(&m_lock);
+    return value;
+}
+
+bool ParameterSubscriptions::isSubscribed(uint8_t category, uint8_t id) const {
+    int index = ParameterSchema::indexOf(category, id);
+    if (index < 0) {
+        return false;
+    }
+    portENTER_CRITICAL(&m_lock);
+    bool subscribed = m_matches[index] != 0;
+    portEXIT_CRITICAL(&m_lock);
+    return subscribed;
+}
+
+size_t ParameterSubscriptions::getSubscriberCount() const {
+    portENTER_CRITICAL(&m_lock);
+    SubscriberMask active = m_active;
+    portEXIT_CRITICAL(&m_lock);
+    return static_cast<size_t>(__builtin_popcount(active));
+}
+
+bool ParameterSubscriptions::dispatch(uint8_t category, uint8_t id, const uint8_t* payload, size_t length, bool changed) {
+    int index = ParameterSchema::indexOf(category, id);
+    if (index < 0) {
+        return false;
+    }
+
+    // Sorted by executor in one snapshot, so callbacks may subscribe or
+    // unsubscribe; invoke() skips ones removed since
+    SubscriberMask inlined = 0;
+    SubscriberMask deferred = 0;
+    SubscriberMask worker = 0;
+    uint32_t suppressed = 0;
+    std::array<uint8_t, MAX_SUBSCRIBERS> generations;
+
+    portENTER_CRITICAL(&m_lock);
+    SubscriberMask pending = m_matches[index] & m_active;
+    while (pending != 0) {
+        size_t slot = static_cast<size_t>(__builtin_ctz(pending));
+        Subscriber& subscriber = m_subscribers[slot];
+        SubscriberMask bit = pending & (0 - pending);
+        pending &= pending - 1;
+        generations[slot] = subscriber.generation;
+
+        if (!changed && subscriber.mode == NotifyMode::ChangesOnly) {
+            subscriber.suppressed++;
+            suppressed++;
+            continue;
+        }
+
+        switch (subscriber.executor) {
+            case CallbackExecutor::Inline:
+                inlined |= bit;
+                break;
+            case CallbackExecutor::Deferred:
+                deferred |= bit;
+                break;
+            case CallbackExecutor::Worker:
+                // Until the worker runs, its callbacks go to poll() instead
+                if (m_workerTask != nullptr) {
+                    worker |= bit;
+                } else {
+                    deferred |= bit;
+                }
+                break;
+        }
+    }
+    portEXIT_CRITICAL(&m_lock);
+
+    if (suppressed != 0) {
+        m_suppressedTotal.fetch_add(suppressed, std::memory_order_relaxed);
+        MetricsRegistry::instance().increment(Counter::DuplicatesSuppressed, suppressed);
+    }
+
+    bool delivered = (inlined | deferred | worker) != 0;
+    while (inlined != 0) {
+        size_t slot = static_cast<size_t>(__builtin_ctz(inlined));
+        invoke(slot, generations[slot], index, category, id, payload, length);
+        inlined &= inlined - 1;
+    }
+
+    if (deferred != 0) {
+        enqueue(m_deferred, deferred, generations, category, id, payload, length);
+    }
+    if (worker != 0) {
+        enqueue(m_worker, worker, generations, category, id, payload, length);
+        xTaskNotifyGive(m_workerTask);
+    }
+
+    return delivered;
+}
+
+void ParameterSubscriptions::enqueue(ReportQueue& queue, SubscriberMask targets,
+                                     const std::array<uint8_t, MAX_SUBSCRIBERS>& generations,
+                                     uint8_t category, uint8_t id, const uint8_t* payload, size_t length) {
+    QueuedReport report;
+    report.targets = targets;
+    report.generations = generations;
+    report.category = category;
+    report.id = id;
+    report.length = static_cast<uint8_t>(length > sizeof(report.payload) ? sizeof(report.payload) : length);
+    memcpy(report.payload, payload, report.length);
+
+    uint32_t count = static_cast<uint32_t>(__builtin_popcount(targets));
+    if (queue.push(report)) {
+        m_deferredTotal.fetch_add(count, std::memory_order_relaxed);
+        MetricsRegistry::instance().increment(Counter::CallbacksDeferred, count);
+    } else {
+        m_droppedTotal.fetch_add(count, std::memory_order_relaxed);
+        MetricsRegistry::instance().increment(Counter::CallbacksDropped, count);
+    }
+}
+
+size_t ParameterSubscriptions::poll() {
+    // Bounded, so a flood on the BLE task can't keep loop() here
+    size_t handled = 0;
+    QueuedReport report;
+    while (handled < QUEUE_CAPACITY && m_deferred.pop(report)) {
+        deliver(report, CallbackExecutor::Deferred);
+        handled++;
+    }
+    return handled;
+}
+
+void ParameterSubscriptions::deliver(const QueuedReport& report, CallbackExecutor executor) {
+    int index = ParameterSchema::indexOf(report.category, report.id);
+    if (index < 0) {
+        return;
+    }
+
+    // Subscribers removed since the report was queued are skipped, as are
+    // slots reused by a new subscriber. A Worker subscriber queued for
+    // poll() before the worker started is still run here; one moved to
+    // the worker queue only runs there.
+    portENTER_CRITICAL(&m_lock);
+    SubscriberMask pending = report.targets & m_matches[index] & m_active;
+    SubscriberMask runnable = 0;
+    while (pending != 0) {
+        size_t slot = static_cast<size_t>(__builtin_ctz(pending));
+        const Subscriber& subscriber = m_subscribers[slot];
+        CallbackExecutor wanted = subscriber.executor;
+        if (subscriber.generation == report.generations[slot] && wanted != CallbackExecutor::Inline &&
+            (executor != CallbackExecutor::Worker || wanted == CallbackExecutor::Worker)) {
+            runnable |= pending & (0 - pending);
+        }
+        pending &= pending - 1;
+    }
+    portEXIT_CRITICAL(&m_lock);
+
+    while (runnable != 0) {
+        size_t slot = static_cast<size_t>(__builtin_ctz(runnable));
+        invoke(slot, report.generations[slot], index, report.category, report.id, report.payload, report.length);
+        runnable &= runnable - 1;
+    }
+}
+
+void ParameterSubscriptions::invoke(size_t slot, uint8_t generation, int index, uint8_t category, uint8_t id,
+                                    const uint8_t* payload, size_t length) {
+    Subscriber& subscriber = m_subscribers[slot];
+    SubscriberMask bit = SubscriberMask(1) << slot;
+
+    // Checked again here, since unsubscribe may have won since the
+    // snapshot; while running is set the slot can't be released
+    portENTER_CRITICAL(&m_lock);
+    bool wanted = (m_matches[index] & m_active & bit) != 0 && subscriber.generation == generation;
+    if (wanted) {
+        subscriber.running++;
+        subscriber.delivered++;
+    }
+    portEXIT_CRITICAL(&m_lock);
+    if (!wanted) {
+        return;
+    }
+    m_deliveredTotal.fetch_add(1, std::memory_order_relaxed);
+
+    uint32_t start = micros();
+    subscriber.callback(category, id, payload, length);
+    uint32_t elapsed = micros() - start;
+    MetricsRegistry::instance().record(Histogram::CallbackMicros, elapsed);
+
+    // Removed while it ran: the last call out releases the callable
+    std::shared_ptr<const SlowCallbackHandler> handler;
+    portENTER_CRITICAL(&m_lock);
+    uint32_t budget = m_budgetMicros;
+    bool slow = budget != 0 && elapsed > budget;
+    if (elapsed > subscriber.maxMicros) {
+        subscriber.maxMicros = elapsed;
+    }
+    if (slow) {
+        subscriber.slowCalls++;
+        handler = m_slowHandler;
+    }
+    bool orphaned = --subscriber.running == 0 && (m_active & bit) == 0;
+    portEXIT_CRITICAL(&m_lock);
+
+    if (slow) {
+        SubscriptionId subscription = makeId(slot, generation);
+        m_slowTotal.fetch_add(1, std::memory_order_relaxed);
+        MetricsRegistry::instance().increment(Counter::SlowCallbacks);
+        BMD_TRACE_WARN(TRACE_SLOW_CALLBACK, subscription, elapsed, budget);
+        if (handler) {
+            (*handler)(subscription, elapsed);
+        }
+    }
+    if (orphaned) {
+        release(slot);
+    }
+}
+
+bool ParameterSubscriptions::startWorker(uint32_t stackSize, UBaseType_t priority) {
+    if (m_workerTask != nullptr) {
+        return true;
+    }
+
+    TaskHandle_t task = nullptr;
+    if (xTaskCreate(workerTask, "bmd_callbacks", stackSize, this, priority, &task) != pdPASS) {
+        return false;
+    }
+    m_workerTask = task;
+    return true;
+}
+
+void ParameterSubscriptions::workerTask(void* param) {
+    ParameterSubscriptions* self = static_cast<ParameterSubscriptions*>(param);
+    QueuedReport report;
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (self->m_worker.pop(report)) {
+            self->deliver(report, CallbackExecutor::Worker);
+        }
+    }
+}
+
+void ParameterSubscriptions::setCallbackBudget(uint32_t budgetMicros, SlowCallbackHandler handler) {
+    // Allocate outside the lock; the old handler is released after it,
+    // or by a slow call still running on another task
+    std::shared_ptr<const SlowCallbackHandler> replacement;
+    if (handler) {
+        replacement = std::make_shared<const SlowCallbackHandler>(std::move(handler));
+    }
+
+    portENTER_CRITICAL(&m_lock);
+    m_budgetMicros = budgetMicros;
+    m_slowHandler.swap(replacement);
+    portEXIT_CRITICAL(&m_lock);
+}
+
+uint32_t ParameterSubscriptions::getCallbackBudget() const {
+    portENTER_CRITICAL(&m_lock);
+    uint32_t budget = m_budgetMicros;
+    portEXIT_CRITICAL(&m_lock);
+    return budget;
+}
+
+uint32_t ParameterSubscriptions::getSuppressed(SubscriptionId subscription) const {
+    return readCounter(subscription, &Subscriber::suppressed);
+}
+
+uint32_t ParameterSubscriptions::getDelivered(SubscriptionId subscription) const {
+    return readCounter(subscription, &Subscriber::delivered);
+}
+
+uint32_t ParameterSubscriptions::getSlowCalls(SubscriptionId subscription) const {
+    return readCounter(subscription, &Subscriber::slowCalls);
+}
+
+uint32_t ParameterSubscriptions::getMaxCallbackMicros(SubscriptionId subscription) const {
+    return readCounter(subscription, &Subscriber::maxMicros);
+}
+
+void ParameterSubscriptions::resetCounters() {
+    portENTER_CRITICAL(&m_lock);
+    for (Subscriber& subscriber : m_subscribers) {
+        subscriber.suppressed = 0;
+        subscriber.delivered = 0;
+        subscriber.slowCalls = 0;
+        subscriber.maxMicros = 0;
+    }
+    portEXIT_CRITICAL(&m_lock);
+    m_suppressedTotal = 0;
+    m_deliveredTotal = 0;
+    m_deferredTotal = 0;
+    m_droppedTotal = 0;
+    m_slowTotal = 0;
+}
+
+} // namespace BMDCamera
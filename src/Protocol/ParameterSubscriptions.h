@@ -0,0 +1,224 @@
+#ifndef BMD_PARAMETER_SUBSCRIPTIONS_H
+#define BMD_PARAMETER_SUBSCRIPTIONS_H
+
+#include <Arduino.h>
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <atomic>
+#include <memory>
+#include "InplaceFunction.h"
+#include "ParameterCache.h"
+#include "ParameterSchema.h"
+
+// Subscriber slots; the per-parameter match sets are one bit per slot
+#ifndef BMD_MAX_PARAMETER_SUBSCRIBERS
+#define BMD_MAX_PARAMETER_SUBSCRIBERS 32
+#endif
+
+// Reports each deferred queue holds before dropping (a power of two)
+#ifndef BMD_DEFERRED_CALLBACK_CAPACITY
+#define BMD_DEFERRED_CALLBACK_CAPACITY 32
+#endif
+
+namespace BMDCamera {
+    // Which reports a subscription hears
+    enum class NotifyMode : uint8_t {
+        ChangesOnly,   // Only reports that change the cached value
+        AllReports     // Every report, including repeats
+    };
+
+    // Where a subscription's callback runs
+    enum class CallbackExecutor : uint8_t {
+        Inline,    // On the BLE task, while the report is ingested
+        Deferred,  // On the task calling poll(), normally the sketch's loop()
+        Worker     // On the task from startWorker(); Deferred until it runs
+    };
+
+    // Receives the reported payload, as stored in the ParameterCache.
+    // Small lambdas are stored inline; a std::function is accepted too.
+    using ParameterCallback = InplaceFunction<void(uint8_t category, uint8_t id, const uint8_t* payload, size_t length)>;
+
+    // Handle for unsubscribe(); 0 means the subscription failed
+    using SubscriptionId = uint16_t;
+    constexpr SubscriptionId INVALID_SUBSCRIPTION = 0;
+
+    // Told which subscription overran the callback budget, and by how much
+    using SlowCallbackHandler = InplaceFunction<void(SubscriptionId subscription, uint32_t elapsedMicros)>;
+
+    // Wildcards for subscribe()
+    constexpr uint8_t ANY_CATEGORY = 0xFF;
+    constexpr uint8_t ANY_PARAMETER = 0xFF;
+
+    // Application callbacks for parameter reports. Any number of
+    // subscribers may match a parameter, by exact key, by wildcard or by a
+    // bitmask of categories. Matching is resolved when subscribing: each
+    // schema entry keeps a bitset of the subscribers that want it, so a
+    // report costs one table lookup plus one call per set bit.
+    //
+    // Inline callbacks run during dispatch(). Deferred and Worker ones get
+    // a copy of the report through a bounded queue, so a slow handler
+    // never stalls ingest; a report that finds its queue full is dropped
+    // for them and counted.
+    //
+    // Subscribing and unsubscribing are safe from any task, including from
+    // inside a callback. A callback removed while it runs finishes first;
+    // its callable is released when the last running call returns.
+    class ParameterSubscriptions {
+    public:
+        static constexpr size_t MAX_SUBSCRIBERS = BMD_MAX_PARAMETER_SUBSCRIBERS;
+        static constexpr size_t QUEUE_CAPACITY = BMD_DEFERRED_CALLBACK_CAPACITY;
+
+        // category and id may be ANY_CATEGORY / ANY_PARAMETER. Only cached
+        // parameters are reported (see ParameterCache::caches), so string
+        // parameters are never matched. Fails if all slots are taken, an
+        // exact key isn't in the schema or is a string, or nothing matches.
+        SubscriptionId subscribe(uint8_t category, uint8_t id, ParameterCallback cb,
+                                 NotifyMode mode = NotifyMode::ChangesOnly,
+                                 CallbackExecutor executor = CallbackExecutor::Inline);
+
+        // Every cached parameter in the categories whose bits are set (1 << CAT_*)
+        SubscriptionId subscribeCategories(uint32_t categoryMask, ParameterCallback cb,
+                                           NotifyMode mode = NotifyMode::ChangesOnly,
+                                           CallbackExecutor executor = CallbackExecutor::Inline);
+
+        bool unsubscribe(SubscriptionId subscription);
+
+        // Drop the subscriptions made for exactly this key; returns how many
+        size_t unsubscribe(uint8_t category, uint8_t id);
+
+        // True if any subscriber matches the parameter
+        bool isSubscribed(uint8_t category, uint8_t id) const;
+        size_t getSubscriberCount() const;
+
+        // Deliver one stored report to every matching subscriber: Inline
+        // ones now, the others by queue. Returns true if a callback ran or
+        // was queued.
+        bool dispatch(uint8_t category, uint8_t id, const uint8_t* payload, size_t length, bool changed);
+
+        // Run the queued Deferred callbacks. Call from loop(); returns the
+        // number of reports handled.
+        size_t poll();
+
+        // Start the task that runs Worker callbacks. Call once, from the
+        // task that calls poll().
+        bool startWorker(uint32_t stackSize = 4096, UBaseType_t priority = 1);
+        bool isWorkerRunning() const { return m_workerTask != nullptr; }
+
+        // Callbacks taking longer than this are counted, traced and passed
+        // to the handler, on the task that ran them (0 disables the check)
+        void setCallbackBudget(uint32_t budgetMicros, SlowCallbackHandler handler = nullptr);
+        uint32_t getCallbackBudget() const;
+
+        // Repeats held back from a ChangesOnly subscriber, and reports it received
+        uint32_t getSuppressed(SubscriptionId subscription) const;
+        uint32_t getDelivered(SubscriptionId subscription) const;
+
+        // Calls over budget, and the longest call in microseconds
+        uint32_t getSlowCalls(SubscriptionId subscription) const;
+        uint32_t getMaxCallbackMicros(SubscriptionId subscription) const;
+
+        uint32_t getSuppressedTotal() const { return m_suppressedTotal.load(std::memory_order_relaxed); }
+        uint32_t getDeliveredTotal() const { return m_deliveredTotal.load(std::memory_order_relaxed); }
+        uint32_t getDeferredTotal() const { return m_deferredTotal.load(std::memory_order_relaxed); }
+        uint32_t getDroppedTotal() const { return m_droppedTotal.load(std::memory_order_relaxed); }
+        uint32_t getSlowTotal() const { return m_slowTotal.load(std::memory_order_relaxed); }
+        void resetCounters();
+
+    private:
+        using SubscriberMask = uint32_t;
+        static_assert(MAX_SUBSCRIBERS <= sizeof(SubscriberMask) * 8, "Subscriber sets are one bit per slot");
+        static_assert(ParameterSchema::CATEGORY_SLOTS <= 32, "Category masks are one bit per category");
+        static_assert(QUEUE_CAPACITY != 0 && (QUEUE_CAPACITY & (QUEUE_CAPACITY - 1)) == 0,
+                      "BMD_DEFERRED_CALLBACK_CAPACITY must be a power of two");
+
+        struct Subscriber {
+            ParameterCallback callback;
+            uint32_t categoryMask = 0;   // Categories matched
+            uint8_t id = ANY_PARAMETER;  // Parameter matched within them
+            bool exact = false;          // Made for a single key
+            NotifyMode mode = NotifyMode::ChangesOnly;
+            CallbackExecutor executor = CallbackExecutor::Inline;
+            uint8_t generation = 0;      // Distinguishes reuses of the slot
+            uint8_t running = 0;         // Calls in progress, under m_lock
+            // Counters, under m_lock
+            uint32_t suppressed = 0;
+            uint32_t delivered = 0;
+            uint32_t slowCalls = 0;
+            uint32_t maxMicros = 0;
+        };
+
+        // A report copied for the subscribers in targets. Each target's
+        // generation is kept so a slot reused before delivery is skipped.
+        struct QueuedReport {
+            SubscriberMask targets;
+            std::array<uint8_t, MAX_SUBSCRIBERS> generations;
+            uint8_t category;
+            uint8_t id;
+            uint8_t length;
+            uint8_t payload[ParameterCache::MAX_PAYLOAD];
+        };
+
+        // Single producer (the BLE task) and single consumer (the executor)
+        struct ReportQueue {
+            std::array<QueuedReport, QUEUE_CAPACITY> reports{};
+            std::atomic<uint32_t> head{0};  // Next slot written
+            std::atomic<uint32_t> tail{0};  // Next slot read
+
+            bool push(const QueuedReport& report);
+            bool pop(QueuedReport& report);
+        };
+
+        SubscriptionId add(uint32_t categoryMask, uint8_t id, bool exact, ParameterCallback cb,
+                           NotifyMode mode, CallbackExecutor executor);
+        // Unmatch a slot, under m_lock. True if no call is in progress, in
+        // which case the caller must release() it once unlocked.
+        bool retire(size_t slot);
+
+        // Destroy a retired slot's callable and free the slot for reuse
+        void release(size_t slot);
+
+        // Read a live subscription's counter under m_lock; 0 if it's gone
+        uint32_t readCounter(SubscriptionId subscription, uint32_t Subscriber::*counter) const;
+
+        void enqueue(ReportQueue& queue, SubscriberMask targets, const std::array<uint8_t, MAX_SUBSCRIBERS>& generations,
+                     uint8_t category, uint8_t id, const uint8_t* payload, size_t length);
+
+        // Run a queued report for those targets that still want it
+        void deliver(const QueuedReport& report, CallbackExecutor executor);
+
+        // Run one callback, timed against the budget, if the slot still
+        // holds that generation and matches the schema entry at index
+        void invoke(size_t slot, uint8_t generation, int index, uint8_t category, uint8_t id,
+                    const uint8_t* payload, size_t length);
+
+        static void workerTask(void* param);
+
+        // Guards the masks below, each subscriber's running count and
+        // counters, and the budget. Held only to take or change them, never
+        // across a callback.
+        mutable portMUX_TYPE m_lock = portMUX_INITIALIZER_UNLOCKED;
+
+        std::array<Subscriber, MAX_SUBSCRIBERS> m_subscribers{};
+        SubscriberMask m_active = 0;    // Subscribed and matched
+        SubscriberMask m_reserved = 0;  // Taken, from add() until release()
+
+        // Subscribers matching each schema entry, by PARAMETER_TABLE index
+        std::array<SubscriberMask, PARAMETER_COUNT> m_matches{};
+
+        ReportQueue m_deferred;
+        ReportQueue m_worker;
+        TaskHandle_t m_workerTask = nullptr;
+
+        uint32_t m_budgetMicros = 0;
+        std::shared_ptr<const SlowCallbackHandler> m_slowHandler; // Swapped under m_lock
+
+        std::atomic<uint32_t> m_suppressedTotal{0};
+        std::atomic<uint32_t> m_deliveredTotal{0};
+        std::atomic<uint32_t> m_deferredTotal{0};
+        std::atomic<uint32_t> m_droppedTotal{0};
+        std::atomic<uint32_t> m_slowTotal{0};
+    };
+}
+
+#endif // BMD_PARAMETER_SUBSCRIPTIONS_H
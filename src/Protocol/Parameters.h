@@ -0,0 +1,267 @@
+#ifndef BMD_PARAMETERS_H
+#define BMD_PARAMETERS_H
+
+// The typed descriptors below need C++17
+#if __cplusplus < 201703L
+#error "BMDBLEController requires C++17 (arduino-esp32 3.x, or -std=gnu++17)"
+#endif
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include "ProtocolConstants.h"
+#include "ParameterSchema.h"
+#include "Fixed16.h"
+
+namespace BMDCamera {
+    // Value of a parameter that carries no data (auto white balance, still capture)
+    struct Trigger {};
+
+    namespace detail {
+        // Wire encoding of a single element. Types without a specialisation
+        // (double, unsigned, String...) fail to compile when used in a Param.
+        template <typename T>
+        struct ElementCodec;
+
+        // Booleans travel as one byte under the void type
+        template <>
+        struct ElementCodec<bool> {
+            static constexpr uint8_t DATA_TYPE = TYPE_VOID;
+            static constexpr size_t SIZE = 1;
+            static void encode(bool value, uint8_t* out) { out[0] = value ? 1 : 0; }
+            static bool decode(const uint8_t* in) { return in[0] != 0; }
+        };
+
+        // Little-endian signed integers
+        template <typename T, uint8_t Type>
+        struct IntegerCodec {
+            static constexpr uint8_t DATA_TYPE = Type;
+            static constexpr size_t SIZE = sizeof(T);
+            static void encode(T value, uint8_t* out) {
+                uint64_t bits = static_cast<uint64_t>(value);
+                for (size_t i = 0; i < SIZE; i++) {
+                    out[i] = static_cast<uint8_t>(bits >> (8 * i));
+                }
+            }
+            static T decode(const uint8_t* in) {
+                uint64_t bits = 0;
+                for (size_t i = 0; i < SIZE; i++) {
+                    bits |= static_cast<uint64_t>(in[i]) << (8 * i);
+                }
+                return static_cast<T>(bits);
+            }
+        };
+
+        template <> struct ElementCodec<int8_t> : IntegerCodec<int8_t, TYPE_BYTE> {};
+        template <> struct ElementCodec<int16_t> : IntegerCodec<int16_t, TYPE_INT16> {};
+        template <> struct ElementCodec<int32_t> : IntegerCodec<int32_t, TYPE_INT32> {};
+        template <> struct ElementCodec<int64_t> : IntegerCodec<int64_t, TYPE_INT64> {};
+
+        // Floats are always sent as fixed16
+        template <>
+        struct ElementCodec<float> {
+            static constexpr uint8_t DATA_TYPE = TYPE_FIXED16;
+            static constexpr size_t SIZE = 2;
+            static void encode(float value, uint8_t* out) {
+                IntegerCodec<int16_t, TYPE_FIXED16>::encode(Fixed16::fromFloat(value), out);
+            }
+            static float decode(const uint8_t* in) {
+                return Fixed16::toFloat(IntegerCodec<int16_t, TYPE_FIXED16>::decode(in));
+            }
+        };
+
+        // A parameter's value: one element, a fixed-size array, or nothing
+        template <typename T>
+        struct ValueCodec {
+            using Element = ElementCodec<T>;
+            static constexpr uint8_t DATA_TYPE = Element::DATA_TYPE;
+            static constexpr size_t COUNT = 1;
+            static void encode(const T& value, uint8_t* out) { Element::encode(value, out); }
+            static void decode(const uint8_t* in, T& value) { value = Element::decode(in); }
+        };
+
+        template <typename T, size_t N>
+        struct ValueCodec<std::array<T, N>> {
+            using Element = ElementCodec<T>;
+            static constexpr uint8_t DATA_TYPE = Element::DATA_TYPE;
+            static constexpr size_t COUNT = N;
+            static void encode(const std::array<T, N>& value, uint8_t* out) {
+                for (size_t i = 0; i < N; i++) {
+                    Element::encode(value[i], out + i * Element::SIZE);
+                }
+            }
+            static void decode(const uint8_t* in, std::array<T, N>& value) {
+                for (size_t i = 0; i < N; i++) {
+                    value[i] = Element::decode(in + i * Element::SIZE);
+                }
+            }
+        };
+
+        template <>
+        struct ValueCodec<Trigger> {
+            static constexpr uint8_t DATA_TYPE = TYPE_VOID;
+            static constexpr size_t COUNT = 0;
+            static void encode(const Trigger&, uint8_t*) {}
+            static void decode(const uint8_t*, Trigger&) {}
+        };
+
+        // Header before the payload: identifier, length, command id, reserved,
+        // category, parameter, data type, operation
+        constexpr size_t PACKET_HEADER_SIZE = 8;
+        constexpr uint8_t PACKET_DESTINATION = 0xFF;
+    }
+
+    // Compile-time description of one parameter. The data type, payload size
+    // and packet size all follow from ValueType and are checked against the
+    // schema, so a descriptor that disagrees with the protocol doesn't build.
+    template <uint8_t CategoryId, uint8_t ParameterId, typename ValueType>
+    struct Param {
+        using Value = ValueType;
+        using Codec = detail::ValueCodec<ValueType>;
+
+        static constexpr uint8_t CATEGORY = CategoryId;
+        static constexpr uint8_t ID = ParameterId;
+        static constexpr uint8_t DATA_TYPE = Codec::DATA_TYPE;
+        static constexpr size_t COUNT = Codec::COUNT;
+        static constexpr size_t PAYLOAD_SIZE = COUNT * ParameterSchema::elementSize(DATA_TYPE);
+        static constexpr size_t PACKET_SIZE = (detail::PACKET_HEADER_SIZE + PAYLOAD_SIZE + 3) & ~size_t(3);
+
+        static_assert(ParameterSchema::indexOf(CategoryId, ParameterId) >= 0,
+                      "Parameter is not in the schema");
+        static_assert(ParameterSchema::matches(CategoryId, ParameterId, DATA_TYPE),
+                      "Value type does not match the parameter's data type");
+        static_assert(ParameterSchema::indexOf(CategoryId, ParameterId) < 0 ||
+                      PARAMETER_TABLE[ParameterSchema::indexOf(CategoryId, ParameterId)].count == COUNT,
+                      "Value type does not match the parameter's element count");
+
+        using Packet = std::array<uint8_t, PACKET_SIZE>;
+
+        // Complete, padded command packet ready for the outgoing characteristic
+        static Packet encode(const ValueType& value, uint8_t operation = OP_ASSIGN) {
+            Packet packet{};
+            packet[0] = detail::PACKET_DESTINATION;
+            packet[1] = static_cast<uint8_t>(PAYLOAD_SIZE + 4);
+            packet[4] = CATEGORY;
+            packet[5] = ID;
+            packet[6] = DATA_TYPE;
+            packet[7] = operation;
+            Codec::encode(value, packet.data() + detail::PACKET_HEADER_SIZE);
+            return packet;
+        }
+
+        // Decode a received payload; false if its size doesn't match
+        static bool decode(const uint8_t* payload, size_t length, ValueType& value) {
+            if (length != PAYLOAD_SIZE || (PAYLOAD_SIZE > 0 && payload == nullptr)) {
+                return false;
+            }
+            Codec::decode(payload, value);
+            return true;
+        }
+    };
+
+    // Descriptors for the parameters the library sets and reads. String
+    // parameters are variable-length and stay on the untyped path.
+    namespace Lens {
+        using Focus = Param<CAT_LENS, 0x00, float>;
+        using AutoFocus = Param<CAT_LENS, 0x01, Trigger>;
+        using ApertureFStop = Param<CAT_LENS, 0x02, float>;
+        using ApertureNormalized = Param<CAT_LENS, 0x03, float>;
+        using ApertureOrdinal = Param<CAT_LENS, 0x04, int16_t>;
+        using AutoAperture = Param<CAT_LENS, 0x05, Trigger>;
+        using ImageStabilization = Param<CAT_LENS, 0x06, bool>;
+        using ZoomMillimeters = Param<CAT_LENS, 0x07, int16_t>;
+        using ZoomNormalized = Param<CAT_LENS, 0x08, float>;
+        using ContinuousZoom = Param<CAT_LENS, 0x09, float>;
+    }
+
+    namespace Video {
+        using Mode = Param<CAT_VIDEO, 0x00, std::array<int8_t, 5>>;
+        using WhiteBalance = Param<CAT_VIDEO, 0x02, std::array<int16_t, 2>>;
+        using SetAutoWhiteBalance = Param<CAT_VIDEO, 0x03, Trigger>;
+        using RestoreAutoWhiteBalance = Param<CAT_VIDEO, 0x04, Trigger>;
+        using Exposure = Param<CAT_VIDEO, 0x05, int32_t>;
+        using ExposureOrdinal = Param<CAT_VIDEO, 0x06, int16_t>;
+        using DynamicRange = Param<CAT_VIDEO, 0x07, int8_t>;
+        using Sharpening = Param<CAT_VIDEO, 0x08, int8_t>;
+        using RecordingFormat = Param<CAT_VIDEO, 0x09, std::array<int16_t, 5>>;
+        using AutoExposureMode = Param<CAT_VIDEO, 0x0A, int8_t>;
+        using ShutterAngle = Param<CAT_VIDEO, 0x0B, int32_t>;
+        using ShutterSpeed = Param<CAT_VIDEO, 0x0C, int32_t>;
+        using Gain = Param<CAT_VIDEO, 0x0D, int8_t>;
+        using ISO = Param<CAT_VIDEO, 0x0E, int32_t>;
+        using DisplayLUT = Param<CAT_VIDEO, 0x0F, std::array<int8_t, 2>>;
+        using NDFilter = Param<CAT_VIDEO, 0x10, std::array<float, 2>>;
+    }
+
+    namespace Audio {
+        using MicLevel = Param<CAT_AUDIO, 0x00, float>;
+        using HeadphoneLevel = Param<CAT_AUDIO, 0x01, float>;
+        using HeadphoneProgramMix = Param<CAT_AUDIO, 0x02, float>;
+        using SpeakerLevel = Param<CAT_AUDIO, 0x03, float>;
+        using InputType = Param<CAT_AUDIO, 0x04, int8_t>;
+        using InputLevels = Param<CAT_AUDIO, 0x05, std::array<float, 2>>;
+        using PhantomPower = Param<CAT_AUDIO, 0x06, bool>;
+    }
+
+    namespace Output {
+        using OverlayEnables = Param<CAT_OUTPUT, 0x00, int16_t>;
+        using FrameGuidesStyle = Param<CAT_OUTPUT, 0x01, int8_t>;
+        using FrameGuidesOpacity = Param<CAT_OUTPUT, 0x02, float>;
+        using Overlays = Param<CAT_OUTPUT, 0x03, std::array<int8_t, 4>>;
+    }
+
+    namespace Display {
+        using Brightness = Param<CAT_DISPLAY, 0x00, float>;
+        using Tools = Param<CAT_DISPLAY, 0x01, int16_t>;
+        using ZebraLevel = Param<CAT_DISPLAY, 0x02, float>;
+        using PeakingLevel = Param<CAT_DISPLAY, 0x03, float>;
+        using ColorBars = Param<CAT_DISPLAY, 0x04, int8_t>;
+        using FocusAssist = Param<CAT_DISPLAY, 0x05, std::array<int8_t, 2>>;
+        using ProgramReturnFeed = Param<CAT_DISPLAY, 0x06, int8_t>;
+    }
+
+    namespace Tally {
+        using Brightness = Param<CAT_TALLY, 0x00, float>;
+        using FrontBrightness = Param<CAT_TALLY, 0x01, float>;
+        using RearBrightness = Param<CAT_TALLY, 0x02, float>;
+    }
+
+    namespace Reference {
+        using Source = Param<CAT_REFERENCE, 0x00, int8_t>;
+        using Offset = Param<CAT_REFERENCE, 0x01, int32_t>;
+    }
+
+    namespace Config {
+        using RealTimeClock = Param<CAT_CONFIG, 0x00, std::array<int32_t, 2>>;
+        using Timezone = Param<CAT_CONFIG, 0x02, int32_t>;
+        using Location = Param<CAT_CONFIG, 0x03, std::array<int64_t, 2>>;
+    }
+
+    namespace Color {
+        using Lift = Param<CAT_COLOR, 0x00, std::array<float, 4>>;
+        using Gamma = Param<CAT_COLOR, 0x01, std::array<float, 4>>;
+        using Gain = Param<CAT_COLOR, 0x02, std::array<float, 4>>;
+        using Offset = Param<CAT_COLOR, 0x03, std::array<float, 4>>;
+        using Contrast = Param<CAT_COLOR, 0x04, std::array<float, 2>>;
+        using LumaMix = Param<CAT_COLOR, 0x05, float>;
+        using HueSaturation = Param<CAT_COLOR, 0x06, std::array<float, 2>>;
+        using ResetDefaults = Param<CAT_COLOR, 0x07, Trigger>;
+    }
+
+    namespace Transport {
+        using Codec = Param<CAT_TRANSPORT, 0x00, std::array<int8_t, 2>>;
+        using Mode = Param<CAT_TRANSPORT, 0x01, std::array<int8_t, 5>>;
+        using Playback = Param<CAT_TRANSPORT, 0x02, std::array<int8_t, 2>>;
+        using StillCapture = Param<CAT_TRANSPORT, 0x03, Trigger>;
+    }
+
+    namespace ExtendedLens {
+        using Reel = Param<CAT_EXTENDED_LENS, 0x00, int16_t>;
+        using SceneTags = Param<CAT_EXTENDED_LENS, 0x01, std::array<int8_t, 2>>;
+        using Take = Param<CAT_EXTENDED_LENS, 0x03, std::array<int8_t, 2>>;
+        using GoodTake = Param<CAT_EXTENDED_LENS, 0x04, bool>;
+        using SlateMode = Param<CAT_EXTENDED_LENS, 0x0E, int8_t>;
+    }
+}
+
+#endif // BMD_PARAMETERS_H
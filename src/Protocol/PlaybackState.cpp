@@ -0,0 +1,60 @@
+#include "PlaybackState.h"
+#include <cmath>
+#include <cstring>
+
+namespace BMDCamera {
+
+namespace {
+    uint32_t readLittleEndian32(const uint8_t* data) {
+        return static_cast<uint32_t>(data[0]) |
+               (static_cast<uint32_t>(data[1]) << 8) |
+               (static_cast<uint32_t>(data[2]) << 16) |
+               (static_cast<uint32_t>(data[3]) << 24);
+    }
+
+    void writeLittleEndian32(uint32_t value, uint8_t* out) {
+        out[0] = static_cast<uint8_t>(value);
+        out[1] = static_cast<uint8_t>(value >> 8);
+        out[2] = static_cast<uint8_t>(value >> 16);
+        out[3] = static_cast<uint8_t>(value >> 24);
+    }
+}
+
+bool PlaybackState::decode(const uint8_t* data, size_t length, PlaybackState& out) {
+    if (data == nullptr || length < PAYLOAD_SIZE) {
+        return false;
+    }
+
+    // Anything outside the enum came off the radio corrupted
+    if (data[0] > static_cast<uint8_t>(PlaybackType::Var)) {
+        return false;
+    }
+
+    // Copy the speed's bits, so no byte pattern is undefined behaviour
+    float speed;
+    uint32_t speedBits = readLittleEndian32(data + 3);
+    memcpy(&speed, &speedBits, sizeof(speed));
+    if (!std::isfinite(speed)) {
+        return false;
+    }
+
+    out.type = static_cast<PlaybackType>(data[0]);
+    out.loop = data[1] != 0;
+    out.singleClip = data[2] != 0;
+    out.speed = speed;
+    out.position = static_cast<int32_t>(readLittleEndian32(data + 7));
+    return true;
+}
+
+void PlaybackState::encode(const PlaybackState& state, uint8_t* out) {
+    out[0] = static_cast<uint8_t>(state.type);
+    out[1] = state.loop ? 0x01 : 0x00;
+    out[2] = state.singleClip ? 0x01 : 0x00;
+
+    uint32_t speedBits;
+    memcpy(&speedBits, &state.speed, sizeof(speedBits));
+    writeLittleEndian32(speedBits, out + 3);
+    writeLittleEndian32(static_cast<uint32_t>(state.position), out + 7);
+}
+
+} // namespace BMDCamera
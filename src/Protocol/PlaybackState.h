@@ -0,0 +1,35 @@
+#ifndef BMD_PLAYBACK_STATE_H
+#define BMD_PLAYBACK_STATE_H
+
+#include <cstdint>
+#include <cstddef>
+
+namespace BMDCamera {
+    enum class PlaybackType : uint8_t {
+        Play = 0,
+        Jog = 1,
+        Shuttle = 2,
+        Var = 3
+    };
+
+    // Transport playback control (transport parameter 0x05)
+    struct PlaybackState {
+        PlaybackType type = PlaybackType::Play;
+        bool loop = false;
+        bool singleClip = false;
+        float speed = 0.0f;
+        int32_t position = 0; // Frame position
+
+        // Type, loop, single clip, speed (float32) and position (int32)
+        static constexpr size_t PAYLOAD_SIZE = 11;
+
+        // Decode a reported payload. Rejects short payloads, unknown types
+        // and a speed that isn't finite.
+        static bool decode(const uint8_t* data, size_t length, PlaybackState& out);
+
+        // Write PAYLOAD_SIZE bytes to out
+        static void encode(const PlaybackState& state, uint8_t* out);
+    };
+}
+
+#endif // BMD_PLAYBACK_STATE_H
@@ -1,6 +1,8 @@
 #ifndef BMD_PROTOCOL_CONSTANTS_H
 #define BMD_PROTOCOL_CONSTANTS_H
 
+#include <cstdint>
+
 namespace BMDCamera {
     // Blackmagic Camera Service UUID
     constexpr const char* BMD_SERVICE_UUID = "291d567a-6d75-11e6-8b77-86f30ca893d3";
@@ -44,6 +46,40 @@ namespace BMDCamera {
         OP_REPORT = 0x02
     };
 
+    // Scoped forms of the values above, for the Controls and the
+    // incoming parameter store
+    enum class Category : uint8_t {
+        Lens = CAT_LENS,
+        Video = CAT_VIDEO,
+        Audio = CAT_AUDIO,
+        Output = CAT_OUTPUT,
+        Display = CAT_DISPLAY,
+        Tally = CAT_TALLY,
+        Reference = CAT_REFERENCE,
+        Configuration = CAT_CONFIG,
+        ColorCorrection = CAT_COLOR,
+        Status = CAT_STATUS,
+        Transport = CAT_TRANSPORT,
+        ExtendedLens = CAT_EXTENDED_LENS
+    };
+
+    enum class DataType : uint8_t {
+        Void = TYPE_VOID,       // Also booleans, as one byte
+        SignedByte = TYPE_BYTE,
+        SignedInt16 = TYPE_INT16,
+        SignedInt32 = TYPE_INT32,
+        SignedInt64 = TYPE_INT64,
+        String = TYPE_STRING,   // UTF-8
+        Fixed16 = TYPE_FIXED16,
+        Boolean = TYPE_VOID
+    };
+
+    enum class OperationType : uint8_t {
+        Assign = OP_ASSIGN,
+        Offset = OP_OFFSET,
+        Report = OP_REPORT
+    };
+
     // Error Codes
     enum ErrorCode {
         ERROR_NONE = 0,
@@ -1,8 +1,8 @@
 // src/Protocol/ProtocolUtils.cpp
 #include "ProtocolUtils.h"
-#include <sstream>
-#include <iomanip>
-#include <algorithm>
+#include "Fixed16.h"
+#include "ParameterSchema.h"
+#include "HexCodec.h"
 
 namespace BMDCamera {
 
@@ -52,20 +52,14 @@ std::vector<uint8_t> ProtocolUtils::createCommandPacket(
     OperationType operation,
     const std::vector<uint8_t>& payload
 ) {
-    // Calculate packet length (payload + 6 bytes for category, parameter, type, operation)
-    uint8_t packetLength = static_cast<uint8_t>(payload.size() + 6);
-    
-    // Create packet with header
+    // The length byte counts the command from the category onwards, not
+    // the 4-byte header or the padding
     std::vector<uint8_t> packet;
-    packet.reserve(packetLength + 2);  // +2 for protocol ID and length byte
+    packet.reserve(8 + payload.size() + 3);
     
-    // Protocol ID
+    // Protocol ID, length, command ID and reserved byte
     packet.push_back(0xFF);
-    
-    // Length field (doesn't include protocol ID and length byte itself)
-    packet.push_back(packetLength);
-    
-    // Command ID and reserved byte
+    packet.push_back(static_cast<uint8_t>(payload.size() + 4));
     packet.push_back(0x00);
     packet.push_back(0x00);
     
@@ -97,9 +91,9 @@ bool ProtocolUtils::validatePacket(const std::vector<uint8_t>& packet) {
         return false;
     }
     
-    // Check packet length
-    uint8_t declaredLength = packet[1];
-    if (declaredLength != packet.size() - 2) {  // -2 for protocol ID and length byte
+    // The declared command must fit, with under 4 bytes of padding after it
+    size_t declaredLength = packet[1];
+    if (declaredLength < 4 || 4 + declaredLength > packet.size() || packet.size() - (4 + declaredLength) > 3) {
         return false;
     }
     
@@ -112,37 +106,11 @@ bool ProtocolUtils::validatePacket(const std::vector<uint8_t>& packet) {
 }
 
 std::string ProtocolUtils::getCategoryName(Category category) {
-    switch (category) {
-        case Category::Lens: return "Lens";
-        case Category::Video: return "Video";
-        case Category::Audio: return "Audio";
-        case Category::Output: return "Output";
-        case Category::Display: return "Display";
-        case Category::Tally: return "Tally";
-        case Category::Reference: return "Reference";
-        case Category::Configuration: return "Configuration";
-        case Category::ColorCorrection: return "Color Correction";
-        case Category::Status: return "Status";
-        case Category::Transport: return "Transport";
-        case Category::Timeline: return "Timeline";
-        case Category::Media: return "Media";
-        case Category::ExtendedLens: return "Extended Lens";
-        default: return "Unknown";
-    }
+    return ParameterSchema::categoryName(static_cast<uint8_t>(category));
 }
 
 std::string ProtocolUtils::getDataTypeName(DataType dataType) {
-    switch (dataType) {
-        case DataType::Void: return "Void";
-        case DataType::Boolean: return "Boolean";
-        case DataType::SignedByte: return "Signed Byte";
-        case DataType::SignedInt16: return "Signed Int16";
-        case DataType::SignedInt32: return "Signed Int32";
-        case DataType::SignedInt64: return "Signed Int64";
-        case DataType::String: return "String";
-        case DataType::Fixed16: return "Fixed16";
-        default: return "Unknown";
-    }
+    return ParameterSchema::dataTypeName(static_cast<uint8_t>(dataType));
 }
 
 std::string ProtocolUtils::getOperationTypeName(OperationType operationType) {
@@ -155,41 +123,15 @@ std::string ProtocolUtils::getOperationTypeName(OperationType operationType) {
 }
 
 std::string ProtocolUtils::bytesToHexString(const std::vector<uint8_t>& data) {
-    std::stringstream ss;
-    ss << std::hex << std::setfill('0');
-    
-    for (auto byte : data) {
-        ss << std::setw(2) << static_cast<int>(byte) << " ";
-    }
-    
-    std::string result = ss.str();
-    if (!result.empty()) {
-        result.pop_back();  // Remove trailing space
-    }
-    
+    std::string result(HexCodec::encodedSize(data.size()), '\0');
+    result.resize(HexCodec::encode(data.data(), data.size(), &result[0], result.size()));
     return result;
 }
 
 std::vector<uint8_t> ProtocolUtils::hexStringToBytes(const std::string& hexString) {
-    std::vector<uint8_t> bytes;
-    
-    // Remove any spaces or other separators
-    std::string cleanHex;
-    std::copy_if(hexString.begin(), hexString.end(), std::back_inserter(cleanHex),
-                [](char c) { return std::isxdigit(c); });
-    
-    // Ensure even number of digits
-    if (cleanHex.length() % 2 != 0) {
-        cleanHex = "0" + cleanHex;
-    }
-    
-    // Convert hex string to bytes
-    for (size_t i = 0; i < cleanHex.length(); i += 2) {
-        std::string byteString = cleanHex.substr(i, 2);
-        uint8_t byte = static_cast<uint8_t>(std::stoi(byteString, nullptr, 16));
-        bytes.push_back(byte);
-    }
-    
+    // Every two characters yield at most one byte
+    std::vector<uint8_t> bytes(hexString.size() / 2 + 1);
+    bytes.resize(HexCodec::decode(hexString.data(), hexString.size(), bytes.data(), bytes.size()));
     return bytes;
 }
 
@@ -201,8 +143,8 @@ float ProtocolUtils::fixed16ToFloat(uint16_t fixed16Value) {
 
 uint16_t ProtocolUtils::floatToFixed16(float value) {
     // Convert float to 5.11 fixed point format
-    // 5 bits integer, 11 bits fractional
-    return static_cast<uint16_t>(value * 2048.0f);
+    // 5 bits integer, 11 bits fractional, rounded and saturated
+    return static_cast<uint16_t>(Fixed16::fromFloat(value));
 }
 
 uint16_t ProtocolUtils::littleEndianToHost16(const uint8_t* data) {
@@ -210,8 +152,8 @@ uint16_t ProtocolUtils::littleEndianToHost16(const uint8_t* data) {
 }
 
 uint32_t ProtocolUtils::littleEndianToHost32(const uint8_t* data) {
-    return static_cast<uint32_t>(
-        data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24));
+    return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+           (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
 }
 
 }  // namespace BMDCamera
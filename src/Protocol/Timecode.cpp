@@ -0,0 +1,232 @@
+#include "Timecode.h"
+#include <cstdio>
+
+namespace BMDCamera {
+
+namespace {
+    // Frames dropped at the start of each minute (except every tenth)
+    uint32_t droppedFramesPerMinute(uint8_t nominalFps) {
+        return nominalFps / 15;  // 2 at 30 fps, 4 at 60 fps
+    }
+
+    bool decodeBCDField(uint32_t value, int shift, uint32_t tensMask, uint8_t& out) {
+        uint32_t units = (value >> shift) & 0x0F;
+        uint32_t tens = (value >> (shift + 4)) & tensMask;
+        if (units > 9) {
+            return false;
+        }
+        out = static_cast<uint8_t>(tens * 10 + units);
+        return true;
+    }
+}
+
+uint32_t Timecode::toFrameCount(uint8_t nominalFps) const {
+    uint32_t totalMinutes = hours * 60u + minutes;
+    uint32_t count = (totalMinutes * 60u + seconds) * nominalFps + frames;
+
+    if (dropFrame) {
+        uint32_t drop = droppedFramesPerMinute(nominalFps);
+        count -= drop * (totalMinutes - totalMinutes / 10);
+    }
+
+    return count;
+}
+
+Timecode Timecode::fromFrameCount(uint32_t frameCount, uint8_t nominalFps, bool dropFrame) {
+    Timecode timecode;
+    timecode.dropFrame = dropFrame;
+
+    if (nominalFps == 0) {
+        return timecode;
+    }
+
+    if (dropFrame) {
+        // Re-insert the skipped frame numbers so plain arithmetic applies
+        uint32_t drop = droppedFramesPerMinute(nominalFps);
+        uint32_t framesPerMinute = nominalFps * 60u - drop;
+        uint32_t framesPer10Minutes = nominalFps * 600u - drop * 9;
+
+        uint32_t tens = frameCount / framesPer10Minutes;
+        uint32_t remainder = frameCount % framesPer10Minutes;
+
+        frameCount += drop * 9 * tens;
+        if (remainder > drop) {
+            frameCount += drop * ((remainder - drop) / framesPerMinute);
+        }
+    }
+
+    timecode.frames = static_cast<uint8_t>(frameCount % nominalFps);
+    uint32_t totalSeconds = frameCount / nominalFps;
+    timecode.seconds = static_cast<uint8_t>(totalSeconds % 60);
+    timecode.minutes = static_cast<uint8_t>((totalSeconds / 60) % 60);
+    timecode.hours = static_cast<uint8_t>((totalSeconds / 3600) % 24);
+
+    return timecode;
+}
+
+size_t Timecode::format(char* buffer, size_t size) const {
+    if (buffer == nullptr || size == 0) {
+        return 0;
+    }
+
+    int written = snprintf(buffer, size, "%02u:%02u:%02u%c%02u",
+        hours, minutes, seconds, dropFrame ? ';' : ':', frames);
+
+    if (written < 0) {
+        buffer[0] = '\0';
+        return 0;
+    }
+    return static_cast<size_t>(written) < size ? static_cast<size_t>(written) : size - 1;
+}
+
+bool TimecodeDecoder::decode(const uint8_t* data, size_t length, Timecode& out) {
+    if (data == nullptr) {
+        return false;
+    }
+
+    // Framed like a camera control packet, or just the bare value
+    size_t offset;
+    if (length >= 12) {
+        offset = 8;
+    } else if (length >= 4) {
+        offset = 0;
+    } else {
+        return false;
+    }
+
+    uint32_t value =
+        static_cast<uint32_t>(data[offset]) |
+        (static_cast<uint32_t>(data[offset + 1]) << 8) |
+        (static_cast<uint32_t>(data[offset + 2]) << 16) |
+        (static_cast<uint32_t>(data[offset + 3]) << 24);
+
+    return decodeBCD(value, out);
+}
+
+bool TimecodeDecoder::decodeBCD(uint32_t value, Timecode& out) {
+    Timecode timecode;
+
+    if (!decodeBCDField(value, 0, 0x07, timecode.frames) ||
+        !decodeBCDField(value, 8, 0x07, timecode.seconds) ||
+        !decodeBCDField(value, 16, 0x07, timecode.minutes) ||
+        !decodeBCDField(value, 24, 0x03, timecode.hours)) {
+        return false;
+    }
+
+    if (timecode.hours > 23 || timecode.minutes > 59 || timecode.seconds > 59) {
+        return false;
+    }
+
+    timecode.dropFrame = (value & 0x80000000u) != 0;
+    out = timecode;
+    return true;
+}
+
+uint32_t TimecodeDecoder::encodeBCD(const Timecode& timecode) {
+    auto bcd = [](uint8_t v) -> uint32_t {
+        return static_cast<uint32_t>(((v / 10) << 4) | (v % 10));
+    };
+
+    return (bcd(timecode.hours) << 24) |
+           (bcd(timecode.minutes) << 16) |
+           (bcd(timecode.seconds) << 8) |
+           bcd(timecode.frames) |
+           (timecode.dropFrame ? 0x80000000u : 0);
+}
+
+void TimecodeClock::setFrameRate(uint32_t numerator, uint32_t denominator) {
+    if (numerator == 0 || denominator == 0) {
+        return;
+    }
+
+    portENTER_CRITICAL(&m_lock);
+    if (m_anchor.frameRate.numerator == numerator && m_anchor.frameRate.denominator == denominator) {
+        portEXIT_CRITICAL(&m_lock);
+        return;
+    }
+    m_anchor.frameRate.numerator = numerator;
+    m_anchor.frameRate.denominator = denominator;
+    m_anchor.valid = false;  // Re-anchor on the next notification
+    portEXIT_CRITICAL(&m_lock);
+}
+
+void TimecodeClock::update(const Timecode& timecode, uint32_t nowUs) {
+    portENTER_CRITICAL(&m_lock);
+    Snapshot& anchor = m_anchor;
+    uint32_t frame = timecode.toFrameCount(anchor.frameRate.nominal());
+    anchor.reported = timecode;
+    anchor.hasReported = true;
+
+    // Keep the existing phase while the interpolation agrees with the camera,
+    // so notification jitter doesn't move frame boundaries around
+    if (!anchor.valid || anchor.dropFrame != timecode.dropFrame || anchor.frameCountAt(nowUs) != frame) {
+        anchor.anchorFrame = frame;
+        anchor.anchorUs = nowUs;
+        anchor.dropFrame = timecode.dropFrame;
+        anchor.valid = true;
+    }
+    portEXIT_CRITICAL(&m_lock);
+}
+
+TimecodeClock::Snapshot TimecodeClock::snapshot() const {
+    portENTER_CRITICAL(&m_lock);
+    Snapshot copy = m_anchor;
+    portEXIT_CRITICAL(&m_lock);
+    return copy;
+}
+
+uint32_t TimecodeClock::Snapshot::frameCountAt(uint32_t nowUs) const {
+    if (!valid) {
+        return 0;
+    }
+
+    uint64_t frames = anchorFrame + microsToFrames(nowUs - anchorUs);
+    return static_cast<uint32_t>(frames % framesPerDay());
+}
+
+Timecode TimecodeClock::Snapshot::timecodeAt(uint32_t nowUs) const {
+    return Timecode::fromFrameCount(frameCountAt(nowUs), frameRate.nominal(), dropFrame);
+}
+
+int64_t TimecodeClock::Snapshot::microsUntilFrame(uint32_t frameCount, uint32_t nowUs) const {
+    if (!valid) {
+        return 0;
+    }
+
+    // Pick the nearest occurrence of the target across midnight
+    int64_t perDay = framesPerDay();
+    int64_t delta = static_cast<int64_t>(frameCount) - static_cast<int64_t>(anchorFrame);
+    if (delta > perDay / 2) {
+        delta -= perDay;
+    } else if (delta < -perDay / 2) {
+        delta += perDay;
+    }
+
+    int64_t targetUs = delta >= 0
+        ? static_cast<int64_t>(framesToMicros(static_cast<uint64_t>(delta)))
+        : -static_cast<int64_t>(framesToMicros(static_cast<uint64_t>(-delta)));
+
+    return targetUs - static_cast<int64_t>(nowUs - anchorUs);
+}
+
+uint32_t TimecodeClock::Snapshot::framesPerDay() const {
+    uint32_t nominal = frameRate.nominal();
+    uint32_t perDay = nominal * 86400u;
+
+    if (dropFrame) {
+        // 1296 minutes a day drop frames (all but every tenth)
+        perDay -= droppedFramesPerMinute(nominal) * 1296u;
+    }
+
+    return perDay > 0 ? perDay : 1;
+}
+
+uint64_t TimecodeClock::Snapshot::framesToMicros(uint64_t frames) const {
+    return frames * frameRate.denominator * 1000000ull / frameRate.numerator;
+}
+
+uint64_t TimecodeClock::Snapshot::microsToFrames(uint64_t micros) const {
+    return micros * frameRate.numerator / (frameRate.denominator * 1000000ull);
+}
+
+} // namespace BMDCamera
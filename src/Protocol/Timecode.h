@@ -0,0 +1,137 @@
+#ifndef BMD_TIMECODE_H
+#define BMD_TIMECODE_H
+
+#include <Arduino.h>
+#include <cstdint>
+#include <cstddef>
+
+namespace BMDCamera {
+    // SMPTE timecode as reported by the camera's timecode characteristic
+    struct Timecode {
+        uint8_t hours = 0;
+        uint8_t minutes = 0;
+        uint8_t seconds = 0;
+        uint8_t frames = 0;
+        bool dropFrame = false;
+
+        // Frames since 00:00:00:00 at the given nominal rate (24, 25, 30...),
+        // honouring drop-frame numbering when set
+        uint32_t toFrameCount(uint8_t nominalFps) const;
+
+        // Inverse of toFrameCount()
+        static Timecode fromFrameCount(uint32_t frameCount, uint8_t nominalFps, bool dropFrame);
+
+        // Write "HH:MM:SS:FF" (';' before the frames for drop-frame) into buffer.
+        // Returns the number of characters written, excluding the terminator.
+        size_t format(char* buffer, size_t size) const;
+
+        bool operator==(const Timecode& other) const {
+            return hours == other.hours && minutes == other.minutes &&
+                   seconds == other.seconds && frames == other.frames &&
+                   dropFrame == other.dropFrame;
+        }
+        bool operator!=(const Timecode& other) const { return !(*this == other); }
+    };
+
+    // Length of a formatted timecode including the terminator
+    constexpr size_t TIMECODE_STRING_SIZE = 12;
+
+    class TimecodeDecoder {
+    public:
+        // Decode the timecode characteristic. The value is a little-endian
+        // 32-bit BCD word 0xHHMMSSFF with bit 31 flagging drop-frame; it is
+        // either the whole notification or follows an 8-byte control header.
+        static bool decode(const uint8_t* data, size_t length, Timecode& out);
+
+        // Decode a 32-bit BCD word
+        static bool decodeBCD(uint32_t value, Timecode& out);
+
+        // Encode back to the 32-bit BCD word
+        static uint32_t encodeBCD(const Timecode& timecode);
+    };
+
+    // Frame rate as a rational number (e.g. 24000/1001 for 23.98)
+    struct FrameRate {
+        uint32_t numerator = 24;
+        uint32_t denominator = 1;
+
+        // Integer frame count per timecode second (24, 25, 30, 50, 60...)
+        uint8_t nominal() const {
+            return static_cast<uint8_t>((numerator + denominator / 2) / denominator);
+        }
+
+        // 29.97 and 59.94 use drop-frame numbering
+        bool isDropFrameRate() const {
+            return denominator == 1001 && (nominal() == 30 || nominal() == 60);
+        }
+    };
+
+    // Local timecode clock. Anchored on each notification and interpolated in
+    // between with the monotonic microsecond timer, so callers get
+    // frame-accurate timecode without waiting for the next notification.
+    //
+    // Notifications update the anchor on the BLE task while loop() reads
+    // it; the anchor is swapped and copied under a lock, and each query
+    // works from one consistent copy. Use snapshot() to run several
+    // queries against the same anchor.
+    class TimecodeClock {
+    public:
+        // The anchor at one instant, with the interpolation done on the copy
+        struct Snapshot {
+            FrameRate frameRate;
+            uint32_t anchorFrame = 0;
+            uint32_t anchorUs = 0;
+            bool dropFrame = false;
+            bool valid = false;
+
+            // The last notification as decoded, kept across frame rate changes
+            Timecode reported;
+            bool hasReported = false;
+
+            uint32_t frameCountAt(uint32_t nowUs) const;
+            Timecode timecodeAt(uint32_t nowUs) const;
+            int64_t microsUntilFrame(uint32_t frameCount, uint32_t nowUs) const;
+            uint32_t framesPerDay() const;
+            uint32_t anchorAgeUs(uint32_t nowUs) const { return nowUs - anchorUs; }
+
+        private:
+            uint64_t framesToMicros(uint64_t frames) const;
+            uint64_t microsToFrames(uint64_t micros) const;
+        };
+
+        // Re-anchors on the next notification; setting the current rate again is a no-op
+        void setFrameRate(uint32_t numerator, uint32_t denominator = 1);
+        FrameRate getFrameRate() const { return snapshot().frameRate; }
+
+        // Feed a decoded notification received at nowUs
+        void update(const Timecode& timecode, uint32_t nowUs);
+
+        // Consistent copy of the anchor
+        Snapshot snapshot() const;
+
+        // True once at least one timecode has been received
+        bool isValid() const { return snapshot().valid; }
+
+        // Interpolated position, as a frame count and as timecode
+        uint32_t frameCountAt(uint32_t nowUs) const { return snapshot().frameCountAt(nowUs); }
+        Timecode timecodeAt(uint32_t nowUs) const { return snapshot().timecodeAt(nowUs); }
+
+        // Microseconds from nowUs until the start of frameCount (negative if
+        // it has already passed)
+        int64_t microsUntilFrame(uint32_t frameCount, uint32_t nowUs) const {
+            return snapshot().microsUntilFrame(frameCount, nowUs);
+        }
+
+        // Frames in one day at the current rate, for wrap-around
+        uint32_t framesPerDay() const { return snapshot().framesPerDay(); }
+
+        // Time since the last notification
+        uint32_t anchorAgeUs(uint32_t nowUs) const { return snapshot().anchorAgeUs(nowUs); }
+
+    private:
+        Snapshot m_anchor;
+        mutable portMUX_TYPE m_lock = portMUX_INITIALIZER_UNLOCKED;
+    };
+}
+
+#endif // BMD_TIMECODE_H
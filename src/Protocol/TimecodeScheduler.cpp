@@ -0,0 +1,153 @@
+#include "TimecodeScheduler.h"
+#include <algorithm>
+
+namespace BMDCamera {
+
+TimecodeScheduler::TimecodeScheduler(const TimecodeClock& clock, PacketSender sender)
+    : m_clock(clock), m_sender(std::move(sender)) {
+}
+
+uint32_t TimecodeScheduler::schedule(const Timecode& at, std::vector<uint8_t> packet) {
+    TimecodeClock::Snapshot clock = m_clock.snapshot();
+    if (!clock.valid) {
+        return 0;
+    }
+
+    // At 29.97 a non-drop count of a drop-frame label is up to a minute out
+    uint8_t nominal = clock.frameRate.nominal();
+    Timecode label = at;
+    label.dropFrame = clock.dropFrame;
+    uint32_t frame = label.toFrameCount(nominal);
+    if (Timecode::fromFrameCount(frame, nominal, label.dropFrame) != label) {
+        return 0;
+    }
+    return scheduleAtFrame(frame, std::move(packet));
+}
+
+uint32_t TimecodeScheduler::scheduleAtFrame(uint32_t frameCount, std::vector<uint8_t> packet) {
+    if (!m_clock.isValid() || packet.empty()) {
+        return 0;
+    }
+
+    uint32_t id = m_nextId++;
+    if (m_nextId == 0) {
+        m_nextId = 1;  // 0 is reserved for failure
+    }
+
+    m_heap.push_back(Entry{ frameCount, m_sequence++, id, std::move(packet) });
+    std::push_heap(m_heap.begin(), m_heap.end(), Later());
+
+    return id;
+}
+
+bool TimecodeScheduler::cancel(uint32_t id) {
+    auto it = std::find_if(m_heap.begin(), m_heap.end(),
+        [id](const Entry& entry) { return entry.id == id; });
+
+    if (it == m_heap.end()) {
+        return false;
+    }
+
+    m_heap.erase(it);
+    std::make_heap(m_heap.begin(), m_heap.end(), Later());
+    return true;
+}
+
+void TimecodeScheduler::clear() {
+    m_heap.clear();
+    m_awaiting.clear();
+}
+
+void TimecodeScheduler::poll(uint32_t nowUs) {
+    TimecodeClock::Snapshot clock = m_clock.snapshot();
+    if (!clock.valid) {
+        return;
+    }
+
+    checkEchoes(clock, nowUs);
+
+    while (!m_heap.empty()) {
+        const Entry& next = m_heap.front();
+        int64_t untilTarget = clock.microsUntilFrame(next.targetFrame, nowUs);
+
+        // Not yet inside the lead window
+        if (untilTarget > static_cast<int64_t>(m_leadUs)) {
+            break;
+        }
+
+        std::pop_heap(m_heap.begin(), m_heap.end(), Later());
+        Entry entry = std::move(m_heap.back());
+        m_heap.pop_back();
+
+        ScheduleResult result;
+        result.id = entry.id;
+        result.targetFrame = entry.targetFrame;
+        result.sentFrame = clock.frameCountAt(nowUs);
+
+        // The parameter's last change before sending; a later one is the echo
+        Awaiting awaiting{};
+        uint64_t changedUs = 0;
+        bool watch = m_reportLookup && entry.packet.size() >= 8;
+        if (watch) {
+            awaiting.category = entry.packet[4];
+            awaiting.id = entry.packet[5];
+            m_reportLookup(awaiting.category, awaiting.id, awaiting.sequence, changedUs);
+        }
+
+        result.sent = m_sender && m_sender(entry.packet.data(), entry.packet.size());
+
+        // The packet is expected to land one lead time after sending
+        result.estimatedErrorMicros = static_cast<int32_t>(static_cast<int64_t>(m_leadUs) - untilTarget);
+
+        if (m_resultCallback) {
+            m_resultCallback(result);
+        }
+
+        if (watch && result.sent) {
+            if (m_awaiting.size() == MAX_AWAITING_ECHO) {
+                m_awaiting.erase(m_awaiting.begin());
+            }
+            awaiting.result = result;
+            awaiting.sentUs = nowUs;
+            m_awaiting.push_back(awaiting);
+        }
+    }
+}
+
+void TimecodeScheduler::checkEchoes(const TimecodeClock::Snapshot& clock, uint32_t nowUs) {
+    size_t kept = 0;
+    for (size_t i = 0; i < m_awaiting.size(); i++) {
+        Awaiting& awaiting = m_awaiting[i];
+        uint32_t sequence = 0;
+        uint64_t changedUs = 0;
+        bool echoed = m_reportLookup && m_reportLookup(awaiting.category, awaiting.id, sequence, changedUs) &&
+                      sequence != awaiting.sequence;
+
+        if (echoed) {
+            // Stamped in the same timebase as micros(); the clock places it
+            // against the target frame's start
+            ScheduleResult result = awaiting.result;
+            result.echoed = true;
+            result.measuredErrorMicros = static_cast<int32_t>(
+                -clock.microsUntilFrame(result.targetFrame, static_cast<uint32_t>(changedUs)));
+            if (m_echoCallback) {
+                m_echoCallback(result);
+            }
+        } else if (nowUs - awaiting.sentUs < ECHO_TIMEOUT_US) {
+            m_awaiting[kept++] = awaiting;
+        }
+    }
+    m_awaiting.erase(m_awaiting.begin() + kept, m_awaiting.end());
+}
+
+uint32_t TimecodeScheduler::microsUntilNext(uint32_t nowUs) const {
+    TimecodeClock::Snapshot clock = m_clock.snapshot();
+    if (m_heap.empty() || !clock.valid) {
+        return 0;
+    }
+
+    int64_t until = clock.microsUntilFrame(m_heap.front().targetFrame, nowUs) - m_leadUs;
+    return until > 0 ? static_cast<uint32_t>(until) : 0;
+}
+
+} // namespace BMDCamera
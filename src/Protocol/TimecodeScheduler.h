@@ -0,0 +1,127 @@
+#ifndef BMD_TIMECODE_SCHEDULER_H
+#define BMD_TIMECODE_SCHEDULER_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "Timecode.h"
+
+namespace BMDCamera {
+    // Outcome of a scheduled command
+    struct ScheduleResult {
+        uint32_t id = 0;
+        uint32_t targetFrame = 0;    // Frame the command was meant to land on
+        uint32_t sentFrame = 0;      // Interpolated frame when it was sent
+        bool sent = false;           // False if the transport refused the packet
+
+        // How far from its frame the command should land, assuming the link
+        // takes exactly the lead time (+ve = late). This is the planned
+        // error from when poll() got to it, not a measurement.
+        int32_t estimatedErrorMicros = 0;
+
+        // Set once the camera reports the parameter the command set (see
+        // setEchoSource): when that report arrived, relative to the start
+        // of the target frame on the timecode clock (+ve = late). It
+        // includes the report's trip back, so it bounds the real error.
+        bool echoed = false;
+        int32_t measuredErrorMicros = 0;
+    };
+
+    // Hands an encoded packet to the link
+    using PacketSender = std::function<bool(const uint8_t* data, size_t length)>;
+
+    // Sequence number and local time (micros() timebase) of a parameter's
+    // latest reported change, e.g. ParameterCache::getChangeInfo
+    using ReportLookup = std::function<bool(uint8_t category, uint8_t id, uint32_t& sequence, uint64_t& changedUs)>;
+
+    using ScheduleResultCallback = std::function<void(const ScheduleResult& result)>;
+
+    // Fires pre-encoded command packets at a target timecode. Pending
+    // commands sit in a min-heap keyed by target frame; each is sent one
+    // lead time before its deadline to absorb link latency. Timing comes
+    // from one snapshot of the clock per poll, so a notification moving
+    // the anchor on the BLE task can't tear a deadline.
+    class TimecodeScheduler {
+    public:
+        TimecodeScheduler(const TimecodeClock& clock, PacketSender sender);
+
+        // Queue a complete packet to land at the given timecode/frame.
+        // Returns an id for cancel(), or 0 if the clock is not running.
+        // The timecode is read in the camera's numbering, drop-frame or not
+        // as its notifications are, whatever at.dropFrame says; a label
+        // that doesn't exist there (e.g. 00:01:00;00) is refused.
+        uint32_t schedule(const Timecode& at, std::vector<uint8_t> packet);
+        uint32_t scheduleAtFrame(uint32_t frameCount, std::vector<uint8_t> packet);
+
+        bool cancel(uint32_t id);
+        void clear();
+
+        // Expected transmit latency; commands go out this long before their frame
+        void setLeadTime(uint32_t leadUs) { m_leadUs = leadUs; }
+        uint32_t getLeadTime() const { return m_leadUs; }
+
+        // Send everything that is due. Call as often as possible.
+        void poll(uint32_t nowUs);
+
+        // Microseconds until the next command is due (0 if due or none queued)
+        uint32_t microsUntilNext(uint32_t nowUs) const;
+
+        size_t pending() const { return m_heap.size(); }
+
+        void setResultCallback(ScheduleResultCallback cb) {
+            m_resultCallback = std::move(cb);
+        }
+
+        // Where poll() looks for the camera's report of each sent command.
+        // A command whose report arrives within ECHO_TIMEOUT_US is passed
+        // to the echo callback with the measured error; one that changes
+        // nothing is never reported, and is dropped after the timeout.
+        static constexpr uint32_t ECHO_TIMEOUT_US = 1000000;
+        static constexpr size_t MAX_AWAITING_ECHO = 16;
+        void setEchoSource(ReportLookup lookup) { m_reportLookup = std::move(lookup); }
+        void setEchoCallback(ScheduleResultCallback cb) { m_echoCallback = std::move(cb); }
+
+    private:
+        struct Entry {
+            uint32_t targetFrame;
+            uint32_t sequence;  // Preserves submission order within a frame
+            uint32_t id;
+            std::vector<uint8_t> packet;
+        };
+
+        // A sent command waiting for the camera to report its parameter
+        struct Awaiting {
+            ScheduleResult result;
+            uint8_t category;
+            uint8_t id;
+            uint32_t sequence;  // The parameter's change sequence before sending
+            uint32_t sentUs;
+        };
+
+        // Match sent commands against the camera's reports
+        void checkEchoes(const TimecodeClock::Snapshot& clock, uint32_t nowUs);
+
+        // Heap comparator: the earliest target is on top
+        struct Later {
+            bool operator()(const Entry& a, const Entry& b) const {
+                if (a.targetFrame != b.targetFrame) {
+                    return a.targetFrame > b.targetFrame;
+                }
+                return a.sequence > b.sequence;
+            }
+        };
+
+        const TimecodeClock& m_clock;
+        PacketSender m_sender;
+        std::vector<Entry> m_heap;
+        uint32_t m_leadUs = 30000;
+        uint32_t m_nextId = 1;
+        uint32_t m_sequence = 0;
+        ScheduleResultCallback m_resultCallback;
+        ReportLookup m_reportLookup;
+        ScheduleResultCallback m_echoCallback;
+        std::vector<Awaiting> m_awaiting;
+    };
+}
+
+#endif // BMD_TIMECODE_SCHEDULER_H
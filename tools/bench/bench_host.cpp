@@ -0,0 +1,320 @@
+// Host build of the protocol benchmarks: ProtocolUtils, Fixed16,
+// ParameterCache and ParameterSubscriptions, timed on a desktop so a
+// change can be measured without a board. Prints the same CSV as the
+// Benchmarks example, so captures compare with tools/compare_bench.py:
+//
+//   make -C tools/bench run > candidate.txt
+//   python3 tools/compare_bench.py baseline.txt candidate.txt
+//
+// Host timings are only comparable with other host runs on the same
+// machine; the example remains the reference for the ESP32 itself.
+
+#include "Protocol/Fixed16.h"
+#include "Protocol/ParameterCache.h"
+#include "Protocol/ParameterSchema.h"
+#include "Protocol/ParameterSubscriptions.h"
+#include "Protocol/Parameters.h"
+#include "Protocol/ProtocolUtils.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace BMDCamera;
+
+namespace {
+    // Keeps results alive so the optimizer can't drop the loops
+    volatile float floatSink = 0.0f;
+    volatile uint32_t intSink = 0;
+
+    // Ten times the example's count; a desktop runs them in milliseconds
+    const uint32_t ITERATIONS = 1000000;
+
+    // Time fn(i) for i in [0, iterations); opsPerIteration counts the values
+    // each call processes, so batch and scalar results are per value
+    template <typename Fn>
+    void runBenchmark(const char* name, uint32_t iterations, Fn fn, uint32_t opsPerIteration = 1) {
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < iterations; i++) {
+            fn(i);
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        uint64_t ops = static_cast<uint64_t>(iterations) * opsPerIteration;
+
+        printf("bench,%s,%llu,%llu,%.2f\n", name, static_cast<unsigned long long>(ops),
+               static_cast<unsigned long long>(elapsed / 1000), static_cast<double>(elapsed) / ops);
+    }
+
+    void printCheck(const char* name, bool pass) {
+        printf("check,%s,%s\n", name, pass ? "pass" : "fail");
+    }
+
+    // Buffers for the batch conversion benchmarks
+    const size_t FIXED16_BATCH = 256;
+    float floatBuffer[FIXED16_BATCH];
+    float floatResult[FIXED16_BATCH];
+    int16_t fixedBuffer[FIXED16_BATCH];
+    uint8_t payloadBuffer[FIXED16_BATCH * 2];
+
+    // Batch and scalar conversions must agree, round to nearest and saturate
+    bool checkFixed16() {
+        const float edges[] = {
+            0.0f, -0.0f, 0.5f / 2048, -0.5f / 2048, 0.3f, -0.3f, 1.0f, -1.0f,
+            15.9995f, 15.9999f, 16.0f, -16.0f, -16.001f, 1000.0f, -1000.0f,
+            NAN, INFINITY, -INFINITY
+        };
+        const size_t edgeCount = sizeof(edges) / sizeof(edges[0]);
+
+        for (size_t i = 0; i < FIXED16_BATCH; i++) {
+            floatBuffer[i] = i < edgeCount ? edges[i] : (static_cast<int32_t>(i * 2654435761u) / 65536.0f) / 1500.0f;
+        }
+        Fixed16::fromFloat(floatBuffer, fixedBuffer, FIXED16_BATCH);
+
+        uint32_t failures = 0;
+        for (size_t i = 0; i < FIXED16_BATCH; i++) {
+            float value = floatBuffer[i];
+            int32_t expected = 0;
+            if (!std::isnan(value)) {
+                float rounded = std::round(value * 2048.0f);
+                expected = rounded > 32767.0f ? 32767 : (rounded < -32768.0f ? -32768 : static_cast<int32_t>(rounded));
+            }
+            if (fixedBuffer[i] != expected || Fixed16::fromFloat(value) != expected) {
+                failures++;
+            }
+        }
+
+        for (int32_t raw = -32768; raw <= 32767; raw++) {
+            if (Fixed16::fromFloat(Fixed16::toFloat(static_cast<int16_t>(raw))) != raw) {
+                failures++;
+            }
+        }
+
+        printCheck("fixed16", failures == 0);
+        return failures == 0;
+    }
+
+    void benchmarkFixed16() {
+        checkFixed16();
+
+        const uint32_t rounds = ITERATIONS / FIXED16_BATCH;
+
+        runBenchmark("fixed16_from_float_scalar", rounds * FIXED16_BATCH, [](uint32_t i) {
+            fixedBuffer[i % FIXED16_BATCH] = Fixed16::fromFloat(floatBuffer[i % FIXED16_BATCH]);
+        });
+
+        runBenchmark("fixed16_from_float_batch", rounds, [](uint32_t) {
+            intSink = Fixed16::fromFloat(floatBuffer, fixedBuffer, FIXED16_BATCH);
+        }, FIXED16_BATCH);
+
+        runBenchmark("fixed16_to_float_batch", rounds, [](uint32_t) {
+            Fixed16::toFloat(fixedBuffer, floatResult, FIXED16_BATCH);
+        }, FIXED16_BATCH);
+
+        runBenchmark("fixed16_encode_payload", rounds, [](uint32_t) {
+            intSink = Fixed16::encode(floatBuffer, payloadBuffer, FIXED16_BATCH);
+        }, FIXED16_BATCH);
+
+        runBenchmark("fixed16_decode_payload", rounds, [](uint32_t) {
+            Fixed16::decode(payloadBuffer, floatResult, FIXED16_BATCH);
+        }, FIXED16_BATCH);
+        floatSink = floatResult[0];
+    }
+
+    // The runtime-keyed packet path must build what the typed descriptor does
+    bool checkProtocolUtils() {
+        auto typed = Video::ISO::encode(800);
+        std::vector<uint8_t> payload = { 0x20, 0x03, 0x00, 0x00 };
+        auto packet = ProtocolUtils::createCommandPacket(Category::Video, Video::ISO::ID, DataType::SignedInt32,
+                                                         OperationType::Assign, payload);
+
+        bool pass = packet.size() == typed.size() && memcmp(packet.data(), typed.data(), typed.size()) == 0 &&
+                    ProtocolUtils::validatePacket(packet) &&
+                    ProtocolUtils::hexStringToBytes(ProtocolUtils::bytesToHexString(packet)) == packet;
+
+        printCheck("protocol_utils", pass);
+        return pass;
+    }
+
+    void benchmarkProtocolUtils() {
+        checkProtocolUtils();
+
+        const std::vector<uint8_t> payload = { 0x00, 0x04 };
+        runBenchmark("protocol_create_packet", ITERATIONS, [&](uint32_t) {
+            auto packet = ProtocolUtils::createCommandPacket(Category::Lens, Lens::Focus::ID, DataType::Fixed16,
+                                                             OperationType::Assign, payload);
+            intSink = packet[packet.size() - 1];
+        });
+
+        const auto packet = ProtocolUtils::createCommandPacket(Category::Lens, Lens::Focus::ID, DataType::Fixed16,
+                                                               OperationType::Assign, payload);
+        runBenchmark("protocol_validate_packet", ITERATIONS, [&](uint32_t) {
+            intSink = ProtocolUtils::validatePacket(packet);
+        });
+
+        runBenchmark("protocol_bytes_to_float", ITERATIONS, [&](uint32_t) {
+            floatSink = ProtocolUtils::bytesToFloat(payload);
+        });
+
+        runBenchmark("protocol_fixed16_round_trip", ITERATIONS, [](uint32_t i) {
+            intSink = ProtocolUtils::floatToFixed16(ProtocolUtils::fixed16ToFloat(static_cast<uint16_t>(i)));
+        });
+
+        const uint32_t hexRounds = ITERATIONS / 10;
+        runBenchmark("protocol_bytes_to_hex", hexRounds, [&](uint32_t) {
+            intSink = ProtocolUtils::bytesToHexString(packet).size();
+        });
+
+        const std::string hex = ProtocolUtils::bytesToHexString(packet);
+        runBenchmark("protocol_hex_to_bytes", hexRounds, [&](uint32_t) {
+            intSink = ProtocolUtils::hexStringToBytes(hex).size();
+        });
+    }
+
+    // Cache every fixed-size parameter in the schema up to count
+    void populateCache(ParameterCache& cache, size_t count) {
+        const uint8_t zeros[ParameterCache::MAX_PAYLOAD] = {};
+        cache.clear();
+        for (size_t i = 0; i < PARAMETER_COUNT && i < count; i++) {
+            const ParameterInfo& info = PARAMETER_TABLE[i];
+            cache.store(info.category, info.id, info.dataType, zeros, info.payloadSize());
+        }
+    }
+
+    ParameterCache benchCache;
+
+    // Ingest cost should not depend on how much is already cached
+    void benchmarkCache() {
+        const auto iso = Video::ISO::encode(800, OP_REPORT);
+        const size_t populations[] = { 0, PARAMETER_COUNT / 4, PARAMETER_COUNT / 2, PARAMETER_COUNT };
+        const char* ingestNames[] = { "cache_ingest_empty", "cache_ingest_quarter", "cache_ingest_half", "cache_ingest_full" };
+
+        for (size_t i = 0; i < 4; i++) {
+            populateCache(benchCache, populations[i]);
+            runBenchmark(ingestNames[i], ITERATIONS, [&](uint32_t) {
+                intSink = benchCache.update(iso.data(), iso.size());
+            });
+        }
+
+        // A dump of several reports back to back, as after a mode change
+        uint8_t burst[Video::ISO::PACKET_SIZE * 4];
+        size_t burstLength = 0;
+        const int32_t values[] = { 200, 400, 800, 1600 };
+        for (int32_t value : values) {
+            auto packet = Video::ISO::encode(value, OP_REPORT);
+            memcpy(burst + burstLength, packet.data(), packet.size());
+            burstLength += packet.size();
+        }
+        runBenchmark("cache_ingest_burst4", ITERATIONS / 4, [&](uint32_t) {
+            intSink = benchCache.update(burst, burstLength);
+        }, 4);
+
+        // Lookups against a full cache
+        populateCache(benchCache, PARAMETER_COUNT);
+        benchCache.update(iso.data(), iso.size());
+
+        runBenchmark("cache_lookup_hit", ITERATIONS, [](uint32_t) {
+            int32_t value = 0;
+            intSink = benchCache.get<Video::ISO>(value) ? value : 0;
+        });
+
+        runBenchmark("cache_lookup_miss", ITERATIONS, [](uint32_t) {
+            uint8_t payload[ParameterCache::MAX_PAYLOAD];
+            size_t length = 0;
+            intSink = benchCache.read(CAT_VIDEO, 0x7F, payload, length);
+        });
+
+        runBenchmark("schema_index_of", ITERATIONS, [](uint32_t i) {
+            const ParameterInfo& info = PARAMETER_TABLE[i % PARAMETER_COUNT];
+            intSink = ParameterSchema::indexOf(info.category, info.id);
+        });
+
+        // Incremental sync after four parameters of a full cache change
+        const uint8_t changedIds[] = { 0x00, 0x02, 0x03, 0x04 };
+        ChangedParameter changes[8];
+        runBenchmark("cache_changes_since_4", ITERATIONS / 4, [&](uint32_t i) {
+            uint32_t since = benchCache.getSequence();
+            uint8_t payload[2] = { static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8) };
+            for (uint8_t id : changedIds) {
+                benchCache.store(CAT_LENS, id, ParameterSchema::find(CAT_LENS, id)->dataType, payload, sizeof(payload));
+            }
+            intSink = benchCache.getChangesSince(since, changes, 8);
+        }, 4);
+    }
+
+    volatile uint32_t callbackCount = 0;
+
+    void countCallback(uint8_t, uint8_t, const uint8_t*, size_t) {
+        callbackCount = callbackCount + 1;
+    }
+
+    // Dispatch of one stored report, as the controller does after ingest
+    void benchmarkSubscriptions() {
+        ParameterSubscriptions subscriptions;
+        const auto iso = Video::ISO::encode(800, OP_REPORT);
+        const uint8_t* payload = iso.data() + 8;
+        const size_t length = Video::ISO::PAYLOAD_SIZE;
+
+        auto dispatch = [&](uint32_t) {
+            intSink = subscriptions.dispatch(CAT_VIDEO, Video::ISO::ID, payload, length, false);
+        };
+
+        runBenchmark("subscriptions_dispatch_none", ITERATIONS, dispatch);
+
+        // The camera repeats unchanged values; ChangesOnly holds them back
+        SubscriptionId changesOnly = subscriptions.subscribe(CAT_VIDEO, Video::ISO::ID, countCallback);
+        runBenchmark("subscriptions_dispatch_changes_only", ITERATIONS, dispatch);
+        subscriptions.unsubscribe(changesOnly);
+
+        SubscriptionId allReports = subscriptions.subscribe(CAT_VIDEO, Video::ISO::ID, countCallback,
+                                                            NotifyMode::AllReports);
+        runBenchmark("subscriptions_dispatch_all_reports", ITERATIONS, dispatch);
+        subscriptions.unsubscribe(allReports);
+
+        // Eight subscribers matched by key, wildcard and category mask
+        SubscriptionId fanout[8];
+        for (size_t i = 0; i < 8; i++) {
+            if (i % 3 == 0) {
+                fanout[i] = subscriptions.subscribe(CAT_VIDEO, Video::ISO::ID, countCallback, NotifyMode::AllReports);
+            } else if (i % 3 == 1) {
+                fanout[i] = subscriptions.subscribe(ANY_CATEGORY, Video::ISO::ID, countCallback, NotifyMode::AllReports);
+            } else {
+                fanout[i] = subscriptions.subscribeCategories(1u << CAT_VIDEO, countCallback, NotifyMode::AllReports);
+            }
+        }
+        runBenchmark("subscriptions_dispatch_fanout_8", ITERATIONS, dispatch);
+        for (SubscriptionId subscription : fanout) {
+            subscriptions.unsubscribe(subscription);
+        }
+
+        // A Deferred callback costs dispatch one queued copy; poll() runs it
+        SubscriptionId deferred = subscriptions.subscribe(CAT_VIDEO, Video::ISO::ID, countCallback,
+                                                          NotifyMode::AllReports, CallbackExecutor::Deferred);
+        runBenchmark("subscriptions_dispatch_deferred", ITERATIONS, [&](uint32_t i) {
+            dispatch(i);
+            if ((i & 15) == 15) {
+                intSink = subscriptions.poll();
+            }
+        });
+        subscriptions.poll();
+        subscriptions.unsubscribe(deferred);
+
+        runBenchmark("subscriptions_subscribe_unsubscribe", ITERATIONS / 10, [&](uint32_t) {
+            subscriptions.unsubscribe(subscriptions.subscribe(CAT_VIDEO, Video::ISO::ID, countCallback));
+        });
+
+        printCheck("subscriptions_delivered", subscriptions.getDroppedTotal() == 0 && callbackCount > 0);
+    }
+}
+
+int main() {
+    printf("bench,name,iterations,total_us,ns_per_op\n");
+    benchmarkFixed16();
+    benchmarkProtocolUtils();
+    benchmarkCache();
+    benchmarkSubscriptions();
+    printf("bench,done\n");
+    return 0;
+}
@@ -0,0 +1,74 @@
+#!/usr/bin/env python3
+"""Compare two serial captures from the Benchmarks example.
+
+Capture the serial monitor output of a baseline build and a candidate
+build (or the output of the host benchmark in tools/bench), then:
+
+    python3 tools/compare_bench.py baseline.txt candidate.txt
+    python3 tools/compare_bench.py --threshold 10 baseline.txt candidate.txt
+
+Lines are "bench,name,iterations,total_us,ns_per_op" and
+"check,name,pass|fail"; anything else (boot messages, other prints) is
+skipped. Exits non-zero if a check failed, a benchmark disappeared, or a
+benchmark's ns_per_op grew by more than the threshold percentage.
+"""
+
+import argparse
+import sys
+
+
+def parse(path):
+    benches = {}
+    checks = {}
+    with open(path, "r", errors="replace") as f:
+        for line in f:
+            fields = line.strip().split(",")
+            if len(fields) == 5 and fields[0] == "bench" and fields[1] != "name":
+                try:
+                    benches[fields[1]] = float(fields[4])
+                except ValueError:
+                    pass
+            elif len(fields) == 3 and fields[0] == "check":
+                checks[fields[1]] = fields[2] == "pass"
+    return benches, checks
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("baseline", help="capture from the reference build")
+    parser.add_argument("candidate", help="capture from the build under test")
+    parser.add_argument("--threshold", type=float, default=5.0,
+                        help="allowed slowdown in percent (default 5)")
+    options = parser.parse_args()
+
+    baseline, _ = parse(options.baseline)
+    candidate, checks = parse(options.candidate)
+    failed = False
+
+    for name, passed in sorted(checks.items()):
+        if not passed:
+            print("check %s failed" % name)
+            failed = True
+
+    print("%-32s %12s %12s %8s" % ("benchmark", "baseline", "candidate", "change"))
+    for name in sorted(set(baseline) | set(candidate)):
+        before = baseline.get(name)
+        after = candidate.get(name)
+        if after is None:
+            print("%-32s %12.2f %12s %8s" % (name, before, "missing", ""))
+            failed = True
+            continue
+        if before is None:
+            print("%-32s %12s %12.2f %8s" % (name, "new", after, ""))
+            continue
+
+        change = (after - before) * 100.0 / before if before > 0 else 0.0
+        regressed = change > options.threshold
+        print("%-32s %12.2f %12.2f %+7.1f%%%s" % (name, before, after, change, " !" if regressed else ""))
+        failed = failed or regressed
+
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
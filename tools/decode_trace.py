@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+"""Decode binary trace output from BMDCamera::TraceLog.
+
+Capture the serial port to a file while the sketch drains with
+TraceFormat::Binary, then:
+
+    python3 tools/decode_trace.py capture.bin
+    python3 tools/decode_trace.py --csv capture.bin > trace.csv
+
+Frames are 0xBD 0x7E, a 20-byte little-endian record, and a one-byte sum
+of the record bytes. Anything between frames (boot messages, other
+prints) is skipped.
+"""
+
+import argparse
+import struct
+import sys
+
+SYNC = b"\xbd\x7e"
+RECORD = struct.Struct("<IBBHIII")
+FRAME_SIZE = len(SYNC) + RECORD.size + 1
+
+# Must match TraceEvent in src/Diagnostics/TraceLog.h
+EVENTS = [
+    "dropped", "device_found", "camera_found", "passkey_request",
+    "auth_success", "auth_failed", "notify", "slow_callback",
+]
+
+LEVELS = "?EWID"
+
+
+def unpack_bytes(args, count):
+    return bytes((args[i // 4] >> (8 * (i % 4))) & 0xFF for i in range(count))
+
+
+def signed(value):
+    return value - (1 << 32) if value & 0x80000000 else value
+
+
+def describe(event, args):
+    if event == 0:
+        return "count=%d" % args[0]
+    if event in (1, 2):
+        text = ":".join("%02x" % b for b in unpack_bytes(args, 6))
+        return text + (" rssi=%d" % signed(args[2]) if event == 1 else "")
+    if event == 3:
+        return "pin=%d" % args[0]
+    if event == 4:
+        return ""
+    if event == 5:
+        return "reason=%d" % args[0]
+    if event == 6:
+        data = unpack_bytes(args[2:], min(args[1], 4))
+        return "source=%d length=%d data=%s" % (args[0], args[1], data.hex())
+    if event == 7:
+        return "subscription=%d us=%d budget=%d" % tuple(args)
+    return " ".join("%08x" % a for a in args)
+
+
+def frames(data):
+    """Yield (timestamp_us, level, event, args) for every valid frame."""
+    i = 0
+    skipped = 0
+    while True:
+        start = data.find(SYNC, i)
+        if start < 0 or start + FRAME_SIZE > len(data):
+            break
+        body = data[start + len(SYNC):start + FRAME_SIZE - 1]
+        if sum(body) & 0xFF != data[start + FRAME_SIZE - 1]:
+            # False sync inside other output; resume one byte later
+            skipped += 1
+            i = start + 1
+            continue
+        timestamp, event, level, _, a, b, c = RECORD.unpack(body)
+        yield timestamp, level, event, (a, b, c)
+        i = start + FRAME_SIZE
+    if skipped:
+        print("skipped %d corrupt frames" % skipped, file=sys.stderr)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("capture", help="raw serial capture ('-' for stdin)")
+    parser.add_argument("--csv", action="store_true", help="emit timestamp_us,level,event,args")
+    options = parser.parse_args()
+
+    if options.capture == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(options.capture, "rb") as f:
+            data = f.read()
+
+    if options.csv:
+        print("timestamp_us,level,event,args")
+    for timestamp, level, event, args in frames(data):
+        name = EVENTS[event] if event < len(EVENTS) else "unknown"
+        letter = LEVELS[level] if level < len(LEVELS) else "?"
+        text = describe(event, args)
+        if options.csv:
+            print('%d,%s,%s,"%s"' % (timestamp, letter, name, text))
+        else:
+            print(("%10d %s %s %s" % (timestamp, letter, name, text)).rstrip())
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,248 @@
+// Host fuzz target for the notification ingest path: packet walking and
+// schema checks in ParameterCache, typed decoding of the cached payloads,
+// the runtime-keyed reports in IncomingCameraControlManager and their
+// ParameterData conversions, the playback state, timecode and camera
+// status decoders, and the text conversions used for string parameters.
+// Any broken invariant aborts, so the fuzzer records the input.
+
+/*
+With libFuzzer (clang), from the repository root:
+
+    clang++ -std=c++17 -g -O1 -fsanitize=fuzzer,address,undefined
+        -I tools/host -I src tools/fuzz/fuzz_ingest.cpp
+        src/Protocol/ParameterCache.cpp src/Protocol/IncomingCameraControlManager.cpp
+        src/Protocol/ProtocolUtils.cpp src/Protocol/HexCodec.cpp src/Protocol/PlaybackState.cpp
+        src/Protocol/Timecode.cpp src/Protocol/CameraStatus.cpp src/Protocol/CharConv.cpp
+        src/Protocol/Fixed16.cpp src/Diagnostics/Metrics.cpp
+        -o fuzz_ingest
+    ./fuzz_ingest tools/fuzz/corpus
+
+(one command, wrapped here). Without libFuzzer, for example with g++, add
+-DBMD_FUZZ_STANDALONE and drop "fuzzer" from the sanitizers; the binary
+then runs each file or directory named on the command line through the
+target once, e.g. to replay the corpus or a crash found elsewhere.
+*/
+
+#include "Protocol/CameraStatus.h"
+#include "Protocol/CharConv.h"
+#include "Protocol/IncomingCameraControlManager.h"
+#include "Protocol/ParameterCache.h"
+#include "Protocol/ParameterSchema.h"
+#include "Protocol/Parameters.h"
+#include "Protocol/PlaybackState.h"
+#include "Protocol/Timecode.h"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+using namespace BMDCamera;
+
+namespace {
+    void require(bool condition) {
+        if (!condition) {
+            abort();
+        }
+    }
+
+    // A cached payload must decode, and encode back to the same bytes
+    template <typename P>
+    void checkRoundTrip(const ParameterCache& cache) {
+        uint8_t payload[ParameterCache::MAX_PAYLOAD];
+        size_t length = 0;
+        if (!cache.read(P::CATEGORY, P::ID, payload, length)) {
+            return;
+        }
+
+        typename P::Value value{};
+        require(P::decode(payload, length, value));
+        auto packet = P::encode(value, OP_REPORT);
+        require(memcmp(packet.data() + 8, payload, length) == 0);
+    }
+
+    void fuzzCache(const uint8_t* data, size_t size) {
+        ParameterCache cache;
+        cache.update(data, size);
+
+        // Whatever the input, every cached payload satisfies the schema
+        for (size_t i = 0; i < PARAMETER_COUNT; i++) {
+            const ParameterInfo& info = PARAMETER_TABLE[i];
+            uint8_t payload[ParameterCache::MAX_PAYLOAD];
+            size_t length = 0;
+            if (cache.read(info.category, info.id, payload, length)) {
+                require(ParameterCache::caches(info));
+                require(ParameterSchema::validate(info.category, info.id, info.dataType, length));
+            }
+        }
+
+        // The change list holds each cached parameter once, oldest first
+        ChangedParameter changes[PARAMETER_COUNT];
+        size_t count = cache.getChangesSince(0, changes, PARAMETER_COUNT);
+        for (size_t i = 0; i < count; i++) {
+            require(cache.has(changes[i].category, changes[i].id));
+            require(i == 0 || changes[i].sequence > changes[i - 1].sequence);
+        }
+        require(count == 0 || changes[count - 1].sequence == cache.getSequence());
+
+        // One descriptor per element type and shape
+        checkRoundTrip<Lens::Focus>(cache);
+        checkRoundTrip<Lens::ApertureOrdinal>(cache);
+        checkRoundTrip<Video::Mode>(cache);
+        checkRoundTrip<Video::WhiteBalance>(cache);
+        checkRoundTrip<Video::ISO>(cache);
+        checkRoundTrip<Video::NDFilter>(cache);
+        checkRoundTrip<Config::Location>(cache);
+        checkRoundTrip<Color::Lift>(cache);
+        checkRoundTrip<Transport::Mode>(cache);
+    }
+
+    // A decoded playback state encodes back to the same bytes, with the
+    // flags normalized to 0 or 1
+    void fuzzPlayback(const uint8_t* data, size_t size) {
+        PlaybackState state;
+        if (!PlaybackState::decode(data, size, state)) {
+            return;
+        }
+        require(std::isfinite(state.speed));
+
+        uint8_t encoded[PlaybackState::PAYLOAD_SIZE];
+        PlaybackState::encode(state, encoded);
+        require(encoded[0] == data[0] && encoded[1] == (data[1] != 0) && encoded[2] == (data[2] != 0));
+        require(memcmp(encoded + 3, data + 3, PlaybackState::PAYLOAD_SIZE - 3) == 0);
+    }
+
+    // Every stored report converts without reading past its payload, and
+    // the text forms are terminated and agree with each other
+    void fuzzParameterData(const uint8_t* data, size_t size) {
+        IncomingCameraControlManager manager;
+        manager.processIncomingPacket(data, size);
+
+        for (Category category : manager.getCachedCategories()) {
+            for (uint8_t id : manager.getParametersForCategory(category)) {
+                auto param = manager.getParameter(category, id);
+                require(param.has_value() && manager.hasParameter(category, id));
+                require(param->rawData.size() + 8 <= size);
+
+                char text[64];
+                size_t written = param->toChars(text, sizeof(text));
+                require(written < sizeof(text) && text[written] == '\0');
+                if (param->dataType != DataType::String) {
+                    require(param->toString() == text);
+                }
+
+                char small[4];
+                written = param->toChars(small, sizeof(small));
+                require(written < sizeof(small) && small[written] == '\0');
+                require(param->toChars(small, 0) == 0);
+
+                float value = param->toFloat();
+                require(param->dataType != DataType::Fixed16 || std::isfinite(value));
+                param->toInteger();
+                param->toBoolean();
+
+                // The controller hands transport 0x05 to the playback decoder
+                fuzzPlayback(param->rawData.data(), param->rawData.size());
+            }
+        }
+    }
+
+    void fuzzTimecode(const uint8_t* data, size_t size) {
+        Timecode timecode;
+        if (!TimecodeDecoder::decode(data, size, timecode)) {
+            return;
+        }
+
+        char text[TIMECODE_STRING_SIZE];
+        size_t written = timecode.format(text, sizeof(text));
+        require(written == TIMECODE_STRING_SIZE - 1 && text[written] == '\0');
+
+        Timecode decoded;
+        require(TimecodeDecoder::decodeBCD(TimecodeDecoder::encodeBCD(timecode), decoded) && decoded == timecode);
+    }
+
+    void fuzzStatus(const uint8_t* data, size_t size) {
+        CameraStatus status;
+        if (CameraStatus::decode(data, size, status)) {
+            require(size > 0 && status.flags == data[0]);
+        }
+    }
+
+    // The input read as the text of a string parameter
+    void fuzzText(const uint8_t* data, size_t size) {
+        const char* first = reinterpret_cast<const char*>(data);
+        const char* last = first + size;
+
+        int64_t integer = 0;
+        CharConvResult result = CharConv::parseInteger(first, last, integer);
+        require(result.ptr >= first && result.ptr <= last);
+        if (result.ok) {
+            char text[CharConv::INTEGER_BUFFER];
+            size_t written = CharConv::formatInteger(integer, text, sizeof(text));
+            int64_t reparsed = 0;
+            require(written > 0 && CharConv::parseInteger(text, text + written, reparsed).ok && reparsed == integer);
+        }
+
+        float value = 0.0f;
+        result = CharConv::parseFloat(first, last, value);
+        require(result.ptr >= first && result.ptr <= last);
+        if (result.ok) {
+            char text[64];
+            size_t written = CharConv::formatFloat(value, text, sizeof(text));
+            require(written < sizeof(text) && text[written] == '\0');
+        }
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    fuzzCache(data, size);
+    fuzzParameterData(data, size);
+    fuzzPlayback(data, size);
+    fuzzTimecode(data, size);
+    fuzzStatus(data, size);
+    fuzzText(data, size);
+    return 0;
+}
+
+#ifdef BMD_FUZZ_STANDALONE
+#include <cstdio>
+#include <dirent.h>
+#include <string>
+#include <vector>
+
+namespace {
+    bool runFile(const std::string& path) {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (file == nullptr) {
+            return false;
+        }
+        std::vector<uint8_t> input;
+        uint8_t buffer[4096];
+        size_t read;
+        while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+            input.insert(input.end(), buffer, buffer + read);
+        }
+        fclose(file);
+
+        LLVMFuzzerTestOneInput(input.data(), input.size());
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t runs = 0;
+    for (int i = 1; i < argc; i++) {
+        DIR* dir = opendir(argv[i]);
+        if (dir == nullptr) {
+            runs += runFile(argv[i]) ? 1 : 0;
+            continue;
+        }
+        while (dirent* entry = readdir(dir)) {
+            if (entry->d_name[0] != '.') {
+                runs += runFile(std::string(argv[i]) + "/" + entry->d_name) ? 1 : 0;
+            }
+        }
+        closedir(dir);
+    }
+    printf("Executed %zu inputs\n", runs);
+    return 0;
+}
+#endif
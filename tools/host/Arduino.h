@@ -0,0 +1,60 @@
+// Just enough of the Arduino-ESP32 core for the protocol and diagnostics
+// sources to build on a desktop, for the host benchmark and fuzz target.
+// Both are single-threaded: critical sections are no-ops and tasks never
+// start, so Worker callbacks and the trace drain task stay unavailable.
+#ifndef BMD_HOST_ARDUINO_H
+#define BMD_HOST_ARDUINO_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+inline uint32_t micros() {
+    static const auto start = std::chrono::steady_clock::now();
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count());
+}
+
+inline uint32_t millis() {
+    return micros() / 1000;
+}
+
+// Output goes to stdout
+class Print {
+public:
+    size_t write(const uint8_t* data, size_t length) { return fwrite(data, 1, length, stdout); }
+    size_t print(const char* text) { return fputs(text, stdout) >= 0 ? strlen(text) : 0; }
+    size_t println(const char* text = "") { return print(text) + print("\n"); }
+};
+
+struct portMUX_TYPE {
+    uint32_t owner;
+    uint32_t count;
+};
+
+#define portMUX_INITIALIZER_UNLOCKED { 0, 0 }
+
+inline void portENTER_CRITICAL(portMUX_TYPE*) {}
+inline void portEXIT_CRITICAL(portMUX_TYPE*) {}
+
+// FreeRTOS
+typedef unsigned int UBaseType_t;
+typedef void* TaskHandle_t;
+
+#define pdTRUE 1
+#define pdPASS 1
+#define pdFAIL 0
+#define portMAX_DELAY 0xFFFFFFFFu
+#define tskIDLE_PRIORITY 0
+#define pdMS_TO_TICKS(ms) (ms)
+
+inline int xTaskCreate(void (*)(void*), const char*, uint32_t, void*, UBaseType_t, TaskHandle_t*) {
+    return pdFAIL;
+}
+inline void vTaskDelay(uint32_t) {}
+inline void xTaskNotifyGive(TaskHandle_t) {}
+inline uint32_t ulTaskNotifyTake(int, uint32_t) { return 0; }
+
+#endif // BMD_HOST_ARDUINO_H